@@ -0,0 +1,98 @@
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "common/RecordingCodec.h"
+
+// Size and speed of the compact recording encoding against the in-memory
+// RecordedEvent layout, over a synthetic session shaped like real captures:
+// mostly 8 ms pointer moves of a few units, with occasional clicks, scrolls and
+// key transitions. Everything stays in memory so the numbers are the codec
+// alone; the file reader and writer add one buffered fread/fwrite per 64 KiB.
+namespace {
+
+using robot::RecordedEvent;
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t kEvents = 1000000;
+
+std::vector<RecordedEvent> syntheticSession() {
+  std::vector<RecordedEvent> events;
+  events.reserve(kEvents);
+  robot::LogicalPoint p{640.0, 360.0};
+  std::chrono::milliseconds t{0};
+  for (std::size_t i = 0; i < kEvents; ++i) {
+    t += std::chrono::milliseconds(8);
+    switch (i % 50) {
+      case 10:
+        events.push_back({t, robot::MouseButtonEvent{
+                                 robot::MouseButton::Left, true, p}});
+        break;
+      case 11:
+        events.push_back({t, robot::MouseButtonEvent{
+                                 robot::MouseButton::Left, false, p}});
+        break;
+      case 20:
+        events.push_back({t, robot::ScrollEvent{
+                                 robot::ScrollDelta::lines(-1.0), p}});
+        break;
+      case 30:
+        events.push_back({t, robot::KeyEvent{robot::Key::E, (i / 50) % 2 == 0}});
+        break;
+      default:
+        p.x += static_cast<double>(i % 7) - 3.0;
+        p.y += static_cast<double>(i % 5) - 2.0;
+        events.push_back({t, robot::MouseMoveEvent{p}});
+        break;
+    }
+  }
+  return events;
+}
+
+}  // namespace
+
+int main() {
+  const auto events = syntheticSession();
+  std::vector<std::uint8_t> encoded(kEvents * robot::recording::kMaxEventSize);
+
+  const auto encodeStart = Clock::now();
+  robot::recording::Encoder encoder;
+  std::size_t size = 0;
+  for (const auto& e : events) {
+    size += encoder.encode(e, std::span(encoded).subspan(size));
+  }
+  const std::chrono::duration<double, std::nano> encodeTime =
+      Clock::now() - encodeStart;
+
+  const auto decodeStart = Clock::now();
+  robot::recording::Decoder decoder;
+  std::size_t offset = 0;
+  std::size_t decoded = 0;
+  RecordedEvent out;
+  while (offset < size) {
+    const auto n =
+        decoder.decode(std::span(encoded).first(size).subspan(offset), out);
+    if (!n) {
+      std::fprintf(stderr, "decode failed at %zu\n", offset);
+      return 1;
+    }
+    offset += *n;
+    ++decoded;
+  }
+  const std::chrono::duration<double, std::nano> decodeTime =
+      Clock::now() - decodeStart;
+
+  const std::size_t raw = kEvents * sizeof(RecordedEvent);
+  std::printf("%zu events (%zu decoded)\n", kEvents, decoded);
+  std::printf("%-18s %12zu bytes %8.2f bytes/event\n", "in memory", raw,
+              static_cast<double>(raw) / kEvents);
+  std::printf("%-18s %12zu bytes %8.2f bytes/event (%.1fx smaller)\n",
+              "encoded", size, static_cast<double>(size) / kEvents,
+              static_cast<double>(raw) / static_cast<double>(size));
+  std::printf("%-18s %8.1f ns/event\n", "encode", encodeTime.count() / kEvents);
+  std::printf("%-18s %8.1f ns/event\n", "decode", decodeTime.count() / kEvents);
+  return 0;
+}
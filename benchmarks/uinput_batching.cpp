@@ -0,0 +1,84 @@
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+
+#include "platform/linux/EvdevBatch.h"
+
+// System calls and time per key transition for the uinput write path: the
+// previous scheme (one write for the event, one for its SYN_REPORT) against
+// EvdevBatch (whole sequence per write). Writes go to /dev/null so the numbers
+// isolate the syscall cost and need no /dev/uinput access; a real uinput write
+// adds the kernel's per-call event processing on top of both.
+namespace {
+
+using robot::linux_uinput::EvdevBatch;
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t kTransitions = 200000;
+
+struct Result {
+  std::size_t syscalls = 0;
+  double nsPerTransition = 0.0;
+};
+
+Result perEventWrites(const int fd) {
+  Result result;
+  const auto start = Clock::now();
+  for (std::size_t i = 0; i < kTransitions; ++i) {
+    input_event ev{};
+    ev.type = EV_KEY;
+    ev.code = KEY_A;
+    ev.value = static_cast<int>(i % 2);
+    input_event syn{};
+    syn.type = EV_SYN;
+    syn.code = SYN_REPORT;
+    if (write(fd, &ev, sizeof(ev)) < 0 || write(fd, &syn, sizeof(syn)) < 0) {
+      std::perror("write");
+    }
+    result.syscalls += 2;
+  }
+  const std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+  result.nsPerTransition = elapsed.count() / kTransitions;
+  return result;
+}
+
+Result batchedWrites(const int fd) {
+  Result result;
+  const auto start = Clock::now();
+  EvdevBatch batch(fd);
+  for (std::size_t i = 0; i < kTransitions; ++i) {
+    if (!batch.add(EV_KEY, KEY_A, static_cast<int>(i % 2)) || !batch.sync()) {
+      std::perror("write");
+    }
+  }
+  if (!batch.flush()) std::perror("write");
+  const std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+  result.syscalls = batch.writes();
+  result.nsPerTransition = elapsed.count() / kTransitions;
+  return result;
+}
+
+}  // namespace
+
+int main() {
+  const int fd = open("/dev/null", O_WRONLY);
+  if (fd < 0) {
+    std::perror("open /dev/null");
+    return 1;
+  }
+
+  const Result legacy = perEventWrites(fd);
+  const Result batched = batchedWrites(fd);
+  close(fd);
+
+  std::printf("%zu key transitions\n", kTransitions);
+  std::printf("%-18s %12s %16s\n", "scheme", "syscalls", "ns/transition");
+  std::printf("%-18s %12zu %16.1f\n", "write per event", legacy.syscalls,
+              legacy.nsPerTransition);
+  std::printf("%-18s %12zu %16.1f\n", "batched", batched.syscalls,
+              batched.nsPerTransition);
+  return 0;
+}
@@ -0,0 +1,128 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <optional>
+#include <span>
+#include <thread>
+#include <variant>
+#include <vector>
+
+#include "robot/Robot.h"
+
+// Event-to-sink latency of the two X11 tap sources, XRecord and XInput2 raw
+// events: the time from issuing an XTest pointer warp to its motion event
+// reaching the sink, in batches of one. Run against a quiet X server such as
+// Xvfb (DISPLAY=:99 after `Xvfb :99 &`); real pointer motion would be counted
+// alongside the injected moves. Each move goes to a distinct position, which
+// is how its arrival is matched to its injection.
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t kMoves = 2000;
+constexpr std::size_t kPerRow = 1000;
+constexpr double kOrigin = 10.0;
+constexpr auto kSpacing = std::chrono::microseconds(500);
+
+struct Result {
+  std::size_t delivered = 0;
+  double meanUs = 0.0;
+  double p50Us = 0.0;
+  double p99Us = 0.0;
+};
+
+robot::LogicalPoint target(const std::size_t i) {
+  return {kOrigin + static_cast<double>(i % kPerRow),
+          kOrigin + static_cast<double>(i / kPerRow)};
+}
+
+std::optional<Result> measure(const robot::X11TapSource source) {
+  robot::SessionOptions options;
+  options.linuxBackend = robot::LinuxBackend::X11;
+  options.x11TapSource = source;
+  auto session = robot::Session::create(options);
+  if (!session) {
+    std::fprintf(stderr, "%s\n", session.error().message.c_str());
+    return std::nullopt;
+  }
+  robot::Mouse& mouse = (*session)->mouse();
+  robot::EventTap& tap = (*session)->eventTap();
+  (void)mouse.move({0.0, 0.0});
+
+  // Written only by the tap thread until it is joined.
+  std::vector<Clock::time_point> arrived(kMoves);
+  std::thread thread([&] {
+    const auto r = tap.start(
+        [&](std::span<const robot::TimedEvent> batch) {
+          const auto now = Clock::now();
+          for (const robot::TimedEvent& e : batch) {
+            const auto* move = std::get_if<robot::MouseMoveEvent>(&e.event);
+            if (move == nullptr || move->position.x < kOrigin ||
+                move->position.y < kOrigin) {
+              continue;
+            }
+            const robot::LogicalPoint p = move->position;
+            const auto x = static_cast<std::size_t>(p.x - kOrigin);
+            const auto y = static_cast<std::size_t>(p.y - kOrigin);
+            const std::size_t i = y * kPerRow + x;
+            if (i < kMoves && arrived[i] == Clock::time_point{}) {
+              arrived[i] = now;
+            }
+          }
+        },
+        robot::TapOptions{.maxBatch = 1}
+    );
+    if (!r) std::fprintf(stderr, "%s\n", r.error().message.c_str());
+  });
+  for (int spins = 0; !tap.isRunning() && spins < 1000; ++spins) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  std::vector<Clock::time_point> sent(kMoves);
+  auto next = Clock::now();
+  for (std::size_t i = 0; i < kMoves; ++i) {
+    sent[i] = Clock::now();
+    (void)mouse.move(target(i));
+    next += kSpacing;
+    std::this_thread::sleep_until(next);
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  tap.stop();
+  thread.join();
+
+  std::vector<double> latencies;
+  for (std::size_t i = 0; i < kMoves; ++i) {
+    if (arrived[i] == Clock::time_point{}) continue;
+    const std::chrono::duration<double, std::micro> d = arrived[i] - sent[i];
+    latencies.push_back(d.count());
+  }
+  Result result;
+  result.delivered = latencies.size();
+  if (latencies.empty()) return result;
+  std::sort(latencies.begin(), latencies.end());
+  double sum = 0.0;
+  for (const double l : latencies) sum += l;
+  result.meanUs = sum / static_cast<double>(latencies.size());
+  result.p50Us = latencies[latencies.size() / 2];
+  result.p99Us = latencies[latencies.size() * 99 / 100];
+  return result;
+}
+
+}  // namespace
+
+int main() {
+  const auto record = measure(robot::X11TapSource::Record);
+  const auto raw = measure(robot::X11TapSource::RawInput);
+  if (!record || !raw) return 1;
+
+  std::printf("%zu pointer warps, %lld us apart\n", kMoves,
+              static_cast<long long>(kSpacing.count()));
+  std::printf("%-10s %10s %10s %10s %10s\n", "source", "delivered", "mean us",
+              "p50 us", "p99 us");
+  std::printf("%-10s %10zu %10.1f %10.1f %10.1f\n", "XRecord",
+              record->delivered, record->meanUs, record->p50Us, record->p99Us);
+  std::printf("%-10s %10zu %10.1f %10.1f %10.1f\n", "XI2 raw",
+              raw->delivered, raw->meanUs, raw->p50Us, raw->p99Us);
+  return 0;
+}
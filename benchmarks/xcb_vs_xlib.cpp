@@ -0,0 +1,114 @@
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <optional>
+#include <thread>
+
+#include "robot/Robot.h"
+
+// Per-call cost of the operations that wait on the X server, through the Xlib
+// backend and the XCB backend (which needs a build configured with
+// ROBOT_LINUX_ENABLE_XCB). The last row is a pointer query issued while
+// another thread captures the full screen: the XCB backend sends both on one
+// connection, the Xlib backend on its two. Run against a quiet X server such
+// as Xvfb (DISPLAY=:99 after `Xvfb :99 &`); typeChar types into whatever has
+// focus.
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+enum Op : std::size_t {
+  kPosition,
+  kMonitors,
+  kCapture,
+  kTypeChar,
+  kPositionDuringCapture,
+  kOpCount
+};
+
+constexpr std::array<const char*, kOpCount> kNames = {
+    "position()", "monitors()", "capture 256x256", "typeChar",
+    "position() during capture"};
+constexpr std::array<int, kOpCount> kIterations = {2000, 500, 200, 200, 2000};
+
+// Mean microseconds per call of f, or a negative value if any call failed.
+template <typename F>
+double timeCalls(const int iterations, F&& f) {
+  const auto start = Clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    if (!f()) return -1.0;
+  }
+  const std::chrono::duration<double, std::micro> d = Clock::now() - start;
+  return d.count() / iterations;
+}
+
+std::optional<std::array<double, kOpCount>> measure(
+    const robot::LinuxBackend backend
+) {
+  robot::SessionOptions options;
+  options.linuxBackend = backend;
+  auto session = robot::Session::create(options);
+  if (!session) {
+    std::fprintf(stderr, "%s\n", session.error().message.c_str());
+    return std::nullopt;
+  }
+  robot::Mouse& mouse = (*session)->mouse();
+  robot::Screen& screen = (*session)->screen();
+  robot::Keyboard& keyboard = (*session)->keyboard();
+  const auto bounds = screen.virtualBounds();
+  if (!bounds) {
+    std::fprintf(stderr, "%s\n", bounds.error().message.c_str());
+    return std::nullopt;
+  }
+
+  std::array<double, kOpCount> us{};
+  us[kPosition] = timeCalls(kIterations[kPosition], [&] {
+    return mouse.position().has_value();
+  });
+  us[kMonitors] = timeCalls(kIterations[kMonitors], [&] {
+    return screen.monitors().has_value();
+  });
+  const robot::PhysicalRect tile{bounds->origin, {256, 256}};
+  us[kCapture] = timeCalls(kIterations[kCapture], [&] {
+    return screen.capture(tile).has_value();
+  });
+  us[kTypeChar] = timeCalls(kIterations[kTypeChar], [&] {
+    return keyboard.typeChar(U'é').has_value();
+  });
+
+  std::atomic<bool> capturing{true};
+  std::thread capturer([&] {
+    while (capturing.load()) (void)screen.capture(*bounds);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  us[kPositionDuringCapture] =
+      timeCalls(kIterations[kPositionDuringCapture], [&] {
+        return mouse.position().has_value();
+      });
+  capturing = false;
+  capturer.join();
+  return us;
+}
+
+}  // namespace
+
+int main() {
+  const auto xlib = measure(robot::LinuxBackend::X11);
+  const auto xcb = measure(robot::LinuxBackend::Xcb);
+  if (!xlib || !xcb) return 1;
+
+  std::printf("%-28s %10s %10s %8s\n", "operation", "Xlib us", "XCB us",
+              "speedup");
+  for (std::size_t op = 0; op < kOpCount; ++op) {
+    const double a = (*xlib)[op];
+    const double b = (*xcb)[op];
+    if (a < 0.0 || b < 0.0) {
+      std::printf("%-28s %10s\n", kNames[op], "failed");
+      continue;
+    }
+    std::printf("%-28s %10.1f %10.1f %7.2fx\n", kNames[op], a, b, a / b);
+  }
+  return 0;
+}
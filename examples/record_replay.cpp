@@ -1,5 +1,6 @@
 #include <chrono>
 #include <print>
+#include <span>
 #include <thread>
 
 #include "robot/Robot.h"
@@ -25,7 +26,10 @@ int main() {
 
   std::println("Recording for 5 seconds...");
   std::thread recordThread([&] {
-    auto r = tap.start([&](const robot::InputEvent& e) { recorder.capture(e); });
+    // Batched delivery: one call per burst of input rather than per event.
+    auto r = tap.start([&](std::span<const robot::TimedEvent> batch) {
+      recorder.capture(batch);
+    });
     if (!r) std::println("Tap error: {}", r.error().message);
   });
 
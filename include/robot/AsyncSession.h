@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <future>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "robot/Error.h"
+#include "robot/Image.h"
+#include "robot/Keyboard.h"
+#include "robot/Monitor.h"
+#include "robot/Mouse.h"
+#include "robot/Screen.h"
+
+namespace robot {
+namespace backend {
+class IPlatformBackend;
+}
+
+// A command queue in front of one backend: every call returns at once with a
+// future, and a single worker thread issues the calls in the order they were
+// made. Timed gestures (smooth moves and scrolls, drags, human-like typing)
+// wait out their gaps on that worker, so the caller's thread never sleeps and
+// several sessions can be driven from one thread by holding their futures.
+//
+// Obtained from Session::async(), or built directly over a backend (which must
+// outlive it). Calls on one AsyncSession are ordered; calls made through the
+// Session's synchronous facades at the same time are not ordered against them.
+//
+// Each future holds what the synchronous call would have returned, or
+// ErrorCode::Cancelled if cancel() or destruction got there first. Arguments
+// are copied, so a span or string_view need only live until the call returns.
+class AsyncSession {
+ public:
+  explicit AsyncSession(backend::IPlatformBackend& backend);
+  // Cancels everything queued (see cancel()) and joins the worker.
+  ~AsyncSession();
+  AsyncSession(const AsyncSession&) = delete;
+  AsyncSession& operator=(const AsyncSession&) = delete;
+  AsyncSession(AsyncSession&&) = delete;
+  AsyncSession& operator=(AsyncSession&&) = delete;
+
+  template <typename T>
+  using Result = std::future<std::expected<T, Error>>;
+
+  // Keyboard: as the methods of the same name on Keyboard.
+  [[nodiscard]] Result<void> press(Key key);
+  [[nodiscard]] Result<void> release(Key key);
+  [[nodiscard]] Result<void> tap(Key key, Modifiers modifiers = {});
+  [[nodiscard]] Result<void> sequence(
+      std::span<const KeyTransition> transitions
+  );
+  [[nodiscard]] Result<void> typeChar(char32_t codepoint);
+  [[nodiscard]] Result<void> typeText(std::string_view utf8);
+  [[nodiscard]] Result<void> typeTextHumanLike(
+      std::string_view utf8, const HumanTypingOptions& options = {}
+  );
+
+  // Mouse: as the methods of the same name on Mouse.
+  [[nodiscard]] Result<void> move(LogicalPoint point);
+  [[nodiscard]] Result<MoveStats> moveSmooth(
+      LogicalPoint point, const MouseMoveOptions& options = {}
+  );
+  [[nodiscard]] Result<MoveStats> followPath(
+      std::span<const LogicalPoint> path, const MouseMoveOptions& options = {}
+  );
+  [[nodiscard]] Result<LogicalPoint> position();
+  [[nodiscard]] Result<void> press(MouseButton button);
+  [[nodiscard]] Result<void> release(MouseButton button);
+  [[nodiscard]] Result<void> click(MouseButton button = MouseButton::Left);
+  [[nodiscard]] Result<void> doubleClick(
+      MouseButton button = MouseButton::Left
+  );
+  [[nodiscard]] Result<void> drag(
+      LogicalPoint to, MouseButton button = MouseButton::Left
+  );
+  [[nodiscard]] Result<void> dragSmooth(
+      LogicalPoint to, MouseButton button = MouseButton::Left,
+      const MouseMoveOptions& options = {}
+  );
+  [[nodiscard]] Result<void> scroll(ScrollDelta delta);
+  [[nodiscard]] Result<MoveStats> scrollSmooth(
+      ScrollDelta total, const ScrollSmoothOptions& options = {}
+  );
+
+  // Screen: as the methods of the same name on Screen.
+  [[nodiscard]] Result<std::vector<Monitor>> monitors();
+  [[nodiscard]] Result<Image> capture(PhysicalRect region);
+  [[nodiscard]] Result<Image> captureMonitor(std::uint32_t monitorId);
+
+  // Queue any other work: f(keyboard, mouse, screen) runs on the worker in
+  // turn with the calls above and must return a std::expected<T, Error>. It
+  // runs to completion once started; cancel() cannot interrupt it.
+  template <typename F>
+  [[nodiscard]] auto run(F f)
+      -> std::future<std::invoke_result_t<F&, Keyboard&, Mouse&, Screen&>>;
+
+  // Fail every call still queued with Cancelled, and stop a running gesture
+  // at its next wait, releasing any button it holds. Calls made afterwards run
+  // normally.
+  void cancel();
+
+  struct State;  // Defined with the worker.
+
+ private:
+  // Hands call to the worker: call(true) to run it, call(false) if it is
+  // cancelled first. Exactly one of the two happens.
+  void post(std::move_only_function<void(bool)> call);
+
+  Keyboard keyboard_;
+  Mouse mouse_;
+  Screen screen_;
+  // Last, so the worker is joined before the facades it uses go away.
+  std::unique_ptr<State> state_;
+};
+
+template <typename F>
+auto AsyncSession::run(F f)
+    -> std::future<std::invoke_result_t<F&, Keyboard&, Mouse&, Screen&>> {
+  using R = std::invoke_result_t<F&, Keyboard&, Mouse&, Screen&>;
+  static_assert(
+      std::is_constructible_v<R, std::unexpected<Error>>,
+      "AsyncSession::run needs a callable returning std::expected<T, Error>"
+  );
+  std::promise<R> promise;
+  auto future = promise.get_future();
+  post([this, f = std::move(f),
+        promise = std::move(promise)](const bool run) mutable {
+    if (run) {
+      promise.set_value(f(keyboard_, mouse_, screen_));
+    } else {
+      promise.set_value(std::unexpected(Error::cancelled("queued call")));
+    }
+  });
+  return future;
+}
+
+}  // namespace robot
@@ -35,6 +35,9 @@ enum class ErrorCode : std::uint16_t {
   // An underlying OS call failed for a reason the library did not classify;
   // message carries the platform detail.
   PlatformError,
+  // An operation queued on an AsyncSession was cancelled, or abandoned when
+  // the session shut down, before it finished.
+  Cancelled,
 };
 
 constexpr std::string_view toString(const ErrorCode code) {
@@ -49,6 +52,7 @@ constexpr std::string_view toString(const ErrorCode code) {
     case ErrorCode::EncodeFailed: return "EncodeFailed";
     case ErrorCode::IoError: return "IoError";
     case ErrorCode::PlatformError: return "PlatformError";
+    case ErrorCode::Cancelled: return "Cancelled";
   }
   std::abort();
 }
@@ -100,6 +104,9 @@ struct Error {
   static Error platformError(std::string_view detail) {
     return {ErrorCode::PlatformError, std::string{detail}};
   }
+  static Error cancelled(std::string_view what) {
+    return {ErrorCode::Cancelled, std::format("Cancelled: {}", what)};
+  }
 };
 
 }  // namespace robot
@@ -22,32 +22,52 @@ namespace robot {
 struct KeyEvent {
   Key key = Key::Unknown;
   bool down = false;  // true = press, false = release.
+
+  friend bool operator==(KeyEvent, KeyEvent) = default;
 };
 
 struct MouseMoveEvent {
   LogicalPoint position;
+
+  friend bool operator==(MouseMoveEvent, MouseMoveEvent) = default;
 };
 
 struct MouseButtonEvent {
   MouseButton button = MouseButton::Left;
   bool down = false;
   LogicalPoint position;
+
+  friend bool operator==(MouseButtonEvent, MouseButtonEvent) = default;
 };
 
 struct ScrollEvent {
   ScrollDelta delta;
   LogicalPoint position;
+
+  friend bool operator==(ScrollEvent, ScrollEvent) = default;
 };
 
 using InputEvent =
     std::variant<KeyEvent, MouseMoveEvent, MouseButtonEvent, ScrollEvent>;
 
+// An input event with the moment it happened on the steady clock. Taps use the
+// platform's own event time where it has one (the X server timestamp, the
+// Quartz event timestamp), so the delay before the tap callback ran does not
+// end up in a recording; otherwise the time the callback received the event.
+struct TimedEvent {
+  std::chrono::steady_clock::time_point time;
+  InputEvent event;
+};
+
 // An input event stamped with the time elapsed since recording began. Absolute
 // timestamps are avoided so a timeline replays identically regardless of when it
-// is replayed.
+// is replayed. Microseconds, so the sub-millisecond gaps of fast typing or a
+// high-rate mouse survive.
 struct RecordedEvent {
-  std::chrono::milliseconds timestamp{0};
+  std::chrono::microseconds timestamp{0};
   InputEvent event;
+
+  friend bool operator==(const RecordedEvent&, const RecordedEvent&) = default;
 };
 
 }  // namespace robot
\ No newline at end of file
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+#include "robot/Event.h"
+
+namespace robot {
+
+// Recorded events in fixed-size segments. Appending never moves an existing
+// event: when the last segment is full a new one is allocated and the old ones
+// stay put, so there is no growth spike proportional to the recording's length
+// (std::vector's reallocate-and-copy) and references to stored events remain
+// valid until clear(). Indexing is one division into the segment table.
+class EventStore {
+ public:
+  static constexpr std::size_t kSegmentSize = 4096;
+
+  class Iterator {
+   public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = RecordedEvent;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const RecordedEvent*;
+    using reference = const RecordedEvent&;
+
+    Iterator() = default;
+    Iterator(const EventStore* store, const std::size_t index)
+        : store_(store), index_(index) {}
+
+    reference operator*() const { return (*store_)[index_]; }
+    pointer operator->() const { return &(*store_)[index_]; }
+    reference operator[](const difference_type n) const {
+      return *(*this + n);
+    }
+
+    Iterator& operator++() {
+      ++index_;
+      return *this;
+    }
+    Iterator operator++(int) {
+      Iterator copy = *this;
+      ++index_;
+      return copy;
+    }
+    Iterator& operator--() {
+      --index_;
+      return *this;
+    }
+    Iterator operator--(int) {
+      Iterator copy = *this;
+      --index_;
+      return copy;
+    }
+    Iterator& operator+=(const difference_type n) {
+      index_ = static_cast<std::size_t>(static_cast<difference_type>(index_) + n);
+      return *this;
+    }
+    Iterator& operator-=(const difference_type n) { return *this += -n; }
+
+    friend Iterator operator+(Iterator it, const difference_type n) {
+      return it += n;
+    }
+    friend Iterator operator+(const difference_type n, Iterator it) {
+      return it += n;
+    }
+    friend Iterator operator-(Iterator it, const difference_type n) {
+      return it -= n;
+    }
+    friend difference_type operator-(const Iterator a, const Iterator b) {
+      return static_cast<difference_type>(a.index_) -
+             static_cast<difference_type>(b.index_);
+    }
+    friend bool operator==(const Iterator a, const Iterator b) {
+      return a.index_ == b.index_;
+    }
+    friend auto operator<=>(const Iterator a, const Iterator b) {
+      return a.index_ <=> b.index_;
+    }
+
+   private:
+    const EventStore* store_ = nullptr;
+    std::size_t index_ = 0;
+  };
+
+  void push_back(const RecordedEvent& event);
+  void clear();
+
+  [[nodiscard]] std::size_t size() const { return size_; }
+  [[nodiscard]] bool empty() const { return size_ == 0; }
+
+  [[nodiscard]] const RecordedEvent& operator[](const std::size_t i) const {
+    return segments_[i / kSegmentSize][i % kSegmentSize];
+  }
+  [[nodiscard]] const RecordedEvent& front() const { return (*this)[0]; }
+  [[nodiscard]] const RecordedEvent& back() const { return (*this)[size_ - 1]; }
+
+  [[nodiscard]] Iterator begin() const { return {this, 0}; }
+  [[nodiscard]] Iterator end() const { return {this, size_}; }
+
+ private:
+  std::vector<std::unique_ptr<RecordedEvent[]>> segments_;
+  std::size_t size_ = 0;
+};
+
+}  // namespace robot
@@ -1,21 +1,108 @@
 #pragma once
 
+#include <chrono>
+#include <cstddef>
 #include <expected>
 #include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
 
 #include "robot/Error.h"
 #include "robot/Event.h"
+#include "robot/Geometry.h"
+#include "robot/Key.h"
+#include "robot/MouseButton.h"
 
 namespace robot {
 namespace backend {
 class IEventTapBackend;
 }
+namespace tap {
+class Hub;
+struct Subscriber;
+}
 
 // Receives normalized global input events in real time. Kept as a std::function
 // because a tap is a cold, one-per-session boundary where type erasure costs
 // nothing meaningful.
 using EventSink = std::function<void(const InputEvent&)>;
 
+// The same, with each event's time of occurrence (see TimedEvent). Pass this
+// kind of sink to record with the platform's timestamps.
+using TimedEventSink = std::function<void(const TimedEvent&)>;
+
+// Receives events in batches, one call per batch rather than per event: the
+// right sink for throughput-oriented consumers (Recorder::capture has a batch
+// overload). The span is only valid during the call.
+using EventBatchSink = std::function<void(std::span<const TimedEvent>)>;
+
+// Which events a tap delivers; the default passes everything. The category
+// switches are pushed down to the OS wherever it can filter: on X11 they
+// narrow the XRecord ranges, so a keyboard-only tap never receives motion; on
+// macOS they narrow the event tap mask; on Windows a category-free hook is not
+// installed at all. The finer selections (particular keys or buttons, and a
+// region for pointer events, in the tap's coordinates) are applied in the
+// callback, before the event is queued.
+struct EventFilter {
+  bool keys = true;
+  bool motion = true;
+  bool buttons = true;
+  bool scroll = true;
+  // Empty passes every key or button.
+  std::vector<Key> onlyKeys;
+  std::vector<MouseButton> onlyButtons;
+  std::optional<LogicalRect> region;
+};
+
+// How a batch sink is fed. A batch is delivered once it holds maxBatch events,
+// or once the tap has drained what the OS had ready and the oldest queued event
+// has waited maxLatency. With the default zero latency each batch is whatever
+// one read from the OS produced (one XRecord reply buffer on X11, one hook or
+// tap callback elsewhere); a latency allowance trades delay for fewer, fuller
+// batches during sparse input. Idle batches are checked with the platform's
+// timer granularity (1 ms on X11 and macOS, about 10 ms on Windows).
+//
+// filter selects what reaches the sink (see EventFilter).
+struct TapOptions {
+  std::size_t maxBatch = 256;
+  std::chrono::microseconds maxLatency{0};
+  EventFilter filter{};
+};
+
+// One subscriber to a shared tap (see EventTap::subscribe). filter selects its
+// events. queueCapacity bounds how far it may fall behind the tap; events
+// arriving while its queue is full are dropped and counted for it alone.
+struct SubscriberOptions {
+  EventFilter filter{};
+  std::size_t queueCapacity = 4096;
+};
+
+// A live subscription; destroying it, or unsubscribe(), ends it. Its sink runs
+// on a delivery thread of its own and has been called for the last time when
+// unsubscribe() returns (unless it is called from inside that sink). Must not
+// outlive the Session.
+class Subscription {
+ public:
+  Subscription() = default;
+  Subscription(Subscription&&) noexcept;
+  Subscription& operator=(Subscription&&) noexcept;
+  ~Subscription();
+
+  void unsubscribe();
+  [[nodiscard]] bool active() const { return subscriber_ != nullptr; }
+  // Events lost to a full queue so far.
+  [[nodiscard]] std::size_t dropped() const;
+
+ private:
+  friend class EventTap;
+  Subscription(tap::Hub* hub, std::shared_ptr<tap::Subscriber> subscriber);
+
+  tap::Hub* hub_ = nullptr;
+  std::shared_ptr<tap::Subscriber> subscriber_;
+};
+
 // A global input tap: observe all mouse and keyboard activity system-wide and
 // forward it as normalized InputEvents (commonly into a Recorder). This is an
 // inherently privileged, platform-limited capability - it needs Accessibility on
@@ -28,21 +115,59 @@ using EventSink = std::function<void(const InputEvent&)>;
 // until stop() is called (from another thread or from within the sink). Run it
 // on a dedicated thread if the caller needs to keep working.
 //
+// For several consumers at once, subscribe() instead: the first subscription
+// starts one platform tap on a thread the EventTap owns, every subscription
+// shares it, and the last one to end stops it. Subscribers come and go at
+// runtime without restarting the tap. The shared tap reads every category, so
+// each subscriber's filter is applied in software; start() with a filter is
+// the way to have the OS filter for a single consumer. The two modes exclude
+// each other while either is running.
+//
 // Obtained from Session::eventTap(); holds a non-owning, possibly-null backend
 // pointer (null when the platform has no tap implementation, in which case
 // start() reports Unsupported).
 class EventTap {
  public:
-  explicit EventTap(backend::IEventTapBackend* backend) : backend_(backend) {}
+  explicit EventTap(backend::IEventTapBackend* backend);
+  ~EventTap();
+
+  EventTap(const EventTap&) = delete;
+  EventTap& operator=(const EventTap&) = delete;
 
   [[nodiscard]] bool isSupported() const { return backend_ != nullptr; }
 
   [[nodiscard]] std::expected<void, Error> start(EventSink sink);
+  [[nodiscard]] std::expected<void, Error> start(TimedEventSink sink);
+  [[nodiscard]] std::expected<void, Error> start(
+      EventBatchSink sink, const TapOptions& options = {}
+  );
+  // Non-blocking mode, for an existing poll/epoll loop: open the tap and
+  // return a file descriptor that becomes readable when input arrives. On
+  // each wake-up, call dispatch() on the same thread; it reads what is
+  // pending, delivers it to the sink before returning, and reports how many
+  // events it delivered. dispatch() delivers everything it read, so
+  // maxLatency does not apply. stop() closes the tap, from that same thread.
+  // Available where the platform's event source is a descriptor (X11);
+  // elsewhere Unsupported.
+  [[nodiscard]] std::expected<int, Error> startPollable(
+      EventBatchSink sink, const TapOptions& options = {}
+  );
+  [[nodiscard]] std::expected<std::size_t, Error> dispatch();
+
   void stop();
   [[nodiscard]] bool isRunning() const;
 
+  [[nodiscard]] std::expected<Subscription, Error> subscribe(
+      EventBatchSink sink, const SubscriberOptions& options = {}
+  );
+
  private:
+  [[nodiscard]] std::expected<void, Error> checkStart(
+      const TapOptions& options
+  ) const;
+
   backend::IEventTapBackend* backend_;
+  std::unique_ptr<tap::Hub> hub_;  // Null when backend_ is.
 };
 
 }  // namespace robot
\ No newline at end of file
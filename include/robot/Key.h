@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <cstdlib>
+#include <optional>
 #include <string_view>
 
 namespace robot {
@@ -79,12 +80,34 @@ enum class Key : std::uint16_t {
   RightControl = 0xE4, RightShift = 0xE5, RightAlt = 0xE6, RightMeta = 0xE7,
 };
 
+// One physical key edge. A span of these is a key sequence (Keyboard::sequence)
+// that a backend may deliver to the OS in a single native call.
+struct KeyTransition {
+  Key key = Key::Unknown;
+  bool down = true;
+
+  friend bool operator==(KeyTransition, KeyTransition) = default;
+};
+
 // The USB HID usage id backing a Key (Usage Page 0x07). Backends translate this
 // to their native code.
 [[nodiscard]] constexpr std::uint16_t keyToHidUsage(const Key key) {
   return static_cast<std::uint16_t>(key);
 }
 
+// The inverse, for usage ids read from outside the program (a saved recording):
+// nullopt when the usage is not one of the enumerators above.
+[[nodiscard]] constexpr std::optional<Key> keyFromHidUsage(
+    const std::uint16_t usage
+) {
+  const bool known = usage == 0x00 || (usage >= 0x04 && usage <= 0x73) ||
+                     usage == 0x75 || usage == 0x76 || usage == 0x87 ||
+                     usage == 0x89 || usage == 0x90 || usage == 0x91 ||
+                     (usage >= 0xE0 && usage <= 0xE7);
+  if (!known) return std::nullopt;
+  return static_cast<Key>(usage);
+}
+
 constexpr std::string_view toString(const Key key) {
   switch (key) {
     case Key::Unknown: return "Unknown";
@@ -2,6 +2,7 @@
 
 #include <chrono>
 #include <expected>
+#include <span>
 #include <string_view>
 
 #include "robot/Error.h"
@@ -58,6 +59,13 @@ class Keyboard {
       Key key, Modifiers modifiers = {}
   );
 
+  // Apply a whole sequence of physical key transitions as one batch, which a
+  // backend can deliver in a single native call (one write on uinput). Keys the
+  // sequence pressed are released if it fails part-way.
+  [[nodiscard]] std::expected<void, Error> sequence(
+      std::span<const KeyTransition> transitions
+  );
+
   // Inject a single Unicode scalar value as text (layout-independent).
   [[nodiscard]] std::expected<void, Error> typeChar(char32_t codepoint);
 
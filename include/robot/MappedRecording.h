@@ -0,0 +1,95 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <expected>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "robot/Error.h"
+#include "robot/Event.h"
+#include "robot/Recorder.h"
+
+namespace robot {
+
+class Session;
+
+// A saved recording (see RecordingFile.h) replayed straight from a read-only
+// memory mapping, for recordings too long to load into a Recorder. Events are
+// decoded lazily as replay reaches them and pages already played are handed
+// back to the OS, so resident memory stays bounded by the read-ahead window
+// and a sparse seek index, however long the file.
+//
+// open() makes one decoding pass to validate the file and build that index:
+// every kIndexStride-th event's timestamp, byte offset and decoder state,
+// releasing pages behind it just as replay does. A seek is then a binary
+// search over the index plus at most kIndexStride decodes, so any time window
+// starts in constant time.
+class MappedRecording {
+ public:
+  static constexpr std::size_t kIndexStride = 1024;
+
+  // Map the recording at path and index it. Fails with InvalidArgument when
+  // the file is not a recording and IoError when it is truncated or corrupt.
+  [[nodiscard]] static std::expected<MappedRecording, Error> open(
+      std::string_view path
+  );
+
+  MappedRecording(MappedRecording&&) noexcept;
+  MappedRecording& operator=(MappedRecording&&) noexcept;
+  ~MappedRecording();
+
+  [[nodiscard]] std::size_t size() const;
+  [[nodiscard]] bool empty() const { return size() == 0; }
+  // Timestamp of the last event.
+  [[nodiscard]] std::chrono::microseconds duration() const;
+
+  // A forward reader over the mapping. Valid while its MappedRecording is.
+  class Cursor {
+   public:
+    Cursor(Cursor&&) noexcept;
+    Cursor& operator=(Cursor&&) noexcept;
+    ~Cursor();
+
+    // The next event, or nullopt past the last one.
+    [[nodiscard]] std::optional<RecordedEvent> next();
+
+   private:
+    friend class MappedRecording;
+    struct State;
+    explicit Cursor(std::unique_ptr<State> state);
+    std::unique_ptr<State> state_;
+  };
+
+  // A cursor whose first event is the first one stamped at or after from.
+  [[nodiscard]] Cursor seek(std::chrono::microseconds from) const;
+
+  // Replay like Recorder::replay, including the options' window and loops,
+  // decoding each event only as it becomes due.
+  [[nodiscard]] std::expected<ReplayStats, Error> replay(
+      Session& session, const ReplayOptions& options = {}
+  ) const;
+
+  // Replay to several Sessions at once, like Recorder's multi-target replay.
+  // Each target decodes the mapping independently.
+  [[nodiscard]] std::expected<std::vector<ReplayStats>, Error> replay(
+      std::span<const ReplayTarget> targets, const ReplayOptions& options = {}
+  ) const;
+
+  // Replay like replay(), on a scheduler thread steered through the returned
+  // handle (see ReplayHandle). The recording must outlive the handle.
+  [[nodiscard]] ReplayHandle replayAsync(
+      Session& session, const ReplayOptions& options = {}
+  ) const;
+
+ private:
+  struct Impl;
+  class ReplaySource;
+  explicit MappedRecording(std::unique_ptr<Impl> impl);
+  std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace robot
@@ -19,6 +19,8 @@ namespace robot {
 //                    typical Retina panel, 1.5 at 150% on Windows). Different
 //                    monitors can have different factors in one session, which is
 //                    exactly why a single global scale is not enough.
+//   refreshRate    : the current mode's vertical refresh in Hz, or 0 when the
+//                    platform does not report one (some built-in panels).
 //
 // Two displays never share an id within a session, but ids are not stable across
 // sessions or hot-plug events; re-enumerate rather than caching them.
@@ -29,6 +31,7 @@ struct Monitor {
   LogicalRect logicalBounds;
   PhysicalRect physicalBounds;
   double scaleFactor = 1.0;
+  double refreshRate = 0.0;
 };
 
 }  // namespace robot
\ No newline at end of file
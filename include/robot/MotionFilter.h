@@ -0,0 +1,101 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <variant>
+#include <vector>
+
+#include "robot/Event.h"
+#include "robot/Geometry.h"
+
+namespace robot {
+
+// What the motion filter may drop. All zero (the default) keeps every move.
+struct MotionFilterOptions {
+  // Coalescing: a move that arrives within minInterval of the last kept
+  // position, or lands within minDistance logical units of it, replaces the
+  // pending move instead of adding one. The newest sample always wins, so a
+  // coalesced stretch still ends exactly where the pointer came to rest.
+  std::chrono::milliseconds minInterval{0};
+  double minDistance = 0.0;
+  // Path simplification: each run of moves between two non-motion events is
+  // reduced with Ramer-Douglas-Peucker, dropping any point that lies within
+  // tolerance logical units of the simplified path. Zero disables it.
+  double tolerance = 0.0;
+};
+
+// Thins out pointer motion in a recorded timeline. Moves usually dominate a
+// capture (every MotionNotify is an event) but carry little information
+// between the points where the path turns; this keeps the turns.
+//
+// Only MouseMoveEvents are ever dropped, and no event is re-stamped: key,
+// button and scroll events pass through at their own time and position, and
+// each one first releases the moves before it, so event order is preserved.
+// Moves are held back until the run they belong to ends (a non-motion event,
+// flush(), or kMaxRun pending moves), since simplification needs the run.
+class MotionFilter {
+ public:
+  // Upper bound on moves held back at once, which bounds the filter's memory
+  // and the delay before a long uninterrupted drag reaches the output.
+  static constexpr std::size_t kMaxRun = 4096;
+
+  explicit MotionFilter(const MotionFilterOptions& options)
+      : options_(options) {}
+
+  // Filter one event, passing every event it releases to out, in order.
+  template <class Out>
+  void add(const RecordedEvent& event, Out&& out) {
+    if (const auto* move = std::get_if<MouseMoveEvent>(&event.event)) {
+      addMove(event.timestamp, move->position);
+      if (run_.size() >= kMaxRun) flush(out);
+      return;
+    }
+    flush(out);
+    if (const auto p = positionOf(event.event)) anchor_ = {event.timestamp, *p};
+    out(event);
+  }
+
+  // Release every move still held back, simplified.
+  template <class Out>
+  void flush(Out&& out) {
+    simplify();
+    for (const RecordedEvent& e : run_) out(e);
+    if (!run_.empty()) {
+      anchor_ = {
+          run_.back().timestamp,
+          std::get<MouseMoveEvent>(run_.back().event).position,
+      };
+    }
+    run_.clear();
+  }
+
+  // Moves dropped so far, by coalescing and simplification together.
+  [[nodiscard]] std::size_t dropped() const { return dropped_; }
+
+  // Discard held-back moves and the dropped count, keeping the options.
+  void reset() {
+    run_.clear();
+    anchor_.reset();
+    dropped_ = 0;
+  }
+
+ private:
+  struct Anchor {
+    std::chrono::microseconds timestamp{0};
+    LogicalPoint position;
+  };
+
+  static std::optional<LogicalPoint> positionOf(const InputEvent& event);
+  void addMove(std::chrono::microseconds timestamp, LogicalPoint position);
+  void simplify();
+
+  MotionFilterOptions options_;
+  std::vector<RecordedEvent> run_;
+  // The last position released or passed through: what coalescing measures
+  // against when the run has fewer than two moves.
+  std::optional<Anchor> anchor_;
+  std::size_t dropped_ = 0;
+};
+
+}  // namespace robot
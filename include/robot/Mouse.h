@@ -1,26 +1,92 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
 #include <expected>
+#include <span>
 
 #include "robot/Error.h"
 #include "robot/Geometry.h"
 #include "robot/MouseButton.h"
+#include "robot/Pacing.h"
 #include "robot/Scroll.h"
+#include "robot/Trajectory.h"
 
 namespace robot {
 namespace backend {
 class IMouseBackend;
-}
+class IScreenBackend;
+}  // namespace backend
+
+// How an interpolated move chooses its step count and what happens when the
+// emitter falls behind its schedule.
+enum class MotionSync : std::uint8_t {
+  // steps (or the distance-derived count) exactly; every point is warped even
+  // if its deadline has already passed.
+  Steps,
+  // One warp per display frame: steps = ceil(duration * refresh rate), with the
+  // rate read from the monitor under the start point. When a wake-up lands
+  // after later frames' deadlines, the skipped points are coalesced into the
+  // latest due one instead of being replayed in a burst, so the display and the
+  // toolkit never see more than one motion per frame.
+  DisplayRefresh,
+};
 
 // Parameters for an interpolated move. The path is sampled at a fixed number of
 // steps over a fixed duration, so a given move is reproducible and its timing is
 // predictable (no speed-derived jitter). steps == 0 derives a step count from
 // the pixel distance, capped internally, so short hops are cheap and long
 // sweeps stay smooth.
+//
+// Step i is issued at the absolute deadline start + duration * i / steps, so
+// time spent inside the backend and scheduler oversleep are absorbed by the
+// next wait instead of stretching the move. pacing selects how each deadline is
+// waited for (see PacingMode); spinWindow is the busy-wait tail in Hybrid mode.
+//
+// trajectory selects the path itself (shape, velocity profile, overshoot,
+// Fitts-law duration). The whole path is generated before the first step is
+// timed, so the choice costs nothing inside the paced loop.
+//
+// sync == DisplayRefresh replaces steps with a per-frame count (see
+// MotionSync). frameRate overrides the monitor's reported rate; when both are
+// 0 (no screen backend, or a panel that reports no rate) 60 Hz is assumed.
 struct MouseMoveOptions {
   std::chrono::milliseconds duration{300};
   int steps = 0;
+  PacingMode pacing = PacingMode::Sleep;
+  std::chrono::microseconds spinWindow{1000};
+  TrajectoryOptions trajectory;
+  MotionSync sync = MotionSync::Steps;
+  double frameRate = 0.0;
+};
+
+// What an interpolated move actually did, so callers can verify its timing.
+// achieved runs from the start of the move to the return of the final warp;
+// jitter is the per-step lateness against each step's absolute deadline.
+// coalesced counts points dropped under MotionSync::DisplayRefresh because a
+// later frame was already due; steps - coalesced warps were issued.
+struct MoveStats {
+  int steps = 0;
+  int coalesced = 0;
+  std::chrono::microseconds requested{0};
+  std::chrono::microseconds achieved{0};
+  Lateness jitter;
+};
+
+// Parameters for a scroll spread over time. The total is cut into steps whose
+// cumulative sums are rounded to quantum, so no fraction is lost or doubled
+// however the steps fall: the emitted deltas always add up to the total (itself
+// rounded to the quantum). quantum == 0 means whole units, right for backends
+// that scroll in discrete notches; with supportsHighResolutionScroll use a
+// finer one such as 1.0 / 120 (one high-resolution wheel unit). steps == 0
+// derives one step per quantum of the larger axis, capped internally.
+struct ScrollSmoothOptions {
+  std::chrono::milliseconds duration{200};
+  int steps = 0;
+  double quantum = 0.0;
+  VelocityProfile velocity = VelocityProfile::MinimumJerk;
+  PacingMode pacing = PacingMode::Sleep;
+  std::chrono::microseconds spinWindow{1000};
 };
 
 // Mouse control operating in global logical coordinates (the virtual desktop
@@ -33,19 +99,35 @@ struct MouseMoveOptions {
 // composing atomic backend operations with timed delays, so they behave
 // identically on every platform and can be tested against a mock backend.
 //
-// Obtained from Session::mouse(); holds a non-owning reference to the backend.
+// Obtained from Session::mouse(); holds non-owning references to the backend.
+// The screen backend is optional and only consulted for refresh rates by
+// MotionSync::DisplayRefresh.
 class Mouse {
  public:
-  explicit Mouse(backend::IMouseBackend& backend) : backend_(&backend) {}
+  explicit Mouse(
+      backend::IMouseBackend& backend,
+      backend::IScreenBackend* screen = nullptr
+  )
+      : backend_(&backend), screen_(screen) {}
 
   // Absolute warp to a logical point on the virtual desktop.
   [[nodiscard]] std::expected<void, Error> move(LogicalPoint point);
 
   // Interpolated move from the current position to point (see MouseMoveOptions).
-  [[nodiscard]] std::expected<void, Error> moveSmooth(
+  // Returns the achieved timing on success.
+  [[nodiscard]] std::expected<MoveStats, Error> moveSmooth(
       LogicalPoint point, const MouseMoveOptions& options = {}
   );
 
+  // Emit a caller-built path (for example from a reused Trajectory, or any
+  // custom generator) with the same paced loop as moveSmooth: one warp per
+  // point, spread evenly over options.duration. options.steps and
+  // options.trajectory are ignored; the path already fixes both. Under
+  // MotionSync::DisplayRefresh late points are coalesced as in moveSmooth.
+  [[nodiscard]] std::expected<MoveStats, Error> followPath(
+      std::span<const LogicalPoint> path, const MouseMoveOptions& options = {}
+  );
+
   [[nodiscard]] std::expected<LogicalPoint, Error> position();
 
   [[nodiscard]] std::expected<void, Error> press(MouseButton button);
@@ -84,8 +166,16 @@ class Mouse {
   // pixels to lines behind the caller's back.
   [[nodiscard]] std::expected<void, Error> scroll(ScrollDelta delta);
 
+  // Scroll total over options.duration in eased, quantized steps (see
+  // ScrollSmoothOptions), paced like moveSmooth. Steps whose rounded delta is
+  // zero are skipped and counted as coalesced in the returned stats.
+  [[nodiscard]] std::expected<MoveStats, Error> scrollSmooth(
+      ScrollDelta total, const ScrollSmoothOptions& options = {}
+  );
+
  private:
   backend::IMouseBackend* backend_;
+  backend::IScreenBackend* screen_;
 };
 
 }  // namespace robot
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace robot {
+
+// How a timed loop (an interpolated move, a replay) waits for each of its
+// deadlines. Deadlines are always absolute offsets from one steady start time,
+// so per-step overhead and oversleep never accumulate across a sequence; the
+// mode only decides how closely each individual deadline is hit.
+enum class PacingMode : std::uint8_t {
+  // sleep_until the deadline. Cheap on CPU, but every wake-up can land up to a
+  // scheduler quantum late (commonly 50 us - 1 ms, worse on a loaded box).
+  Sleep,
+  // Sleep until spinWindow before the deadline, then busy-wait the remainder.
+  // Sub-millisecond accuracy at the cost of one core for the spin window of
+  // every step.
+  Hybrid,
+};
+
+// How late a sequence of deadlines was actually met. Lateness is measured from
+// each deadline to the moment its action was issued; an early wake-up cannot
+// happen (every wait loops until the deadline has passed), so all samples are
+// non-negative.
+struct Lateness {
+  std::size_t samples = 0;
+  std::chrono::microseconds mean{0};
+  std::chrono::microseconds max{0};
+};
+
+}  // namespace robot
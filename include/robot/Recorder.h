@@ -1,23 +1,58 @@
 #pragma once
 
+#include <atomic>
 #include <chrono>
+#include <cstddef>
 #include <expected>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
 #include <vector>
 
 #include "robot/Error.h"
 #include "robot/Event.h"
+#include "robot/EventStore.h"
+#include "robot/MotionFilter.h"
+#include "robot/ReplayHandle.h"
+#include "robot/SpscRing.h"
 
 namespace robot {
 
 class Session;
 
-// Options controlling replay pacing.
-struct ReplayOptions {
-  // Multiplies every inter-event gap: 2.0 replays at half speed, 0.5 at double.
-  double timeScale = 1.0;
-  // Upper bound on any single wait, so a long idle gap in the recording does not
-  // freeze replay. Zero disables the cap.
-  std::chrono::milliseconds maxGap{0};
+// How a Recorder accepts events. With ringCapacity == 0 (the default) capture()
+// appends straight to the event store, and capture, events() and replay() must
+// all run on one thread or be externally synchronized. A non-zero ringCapacity
+// selects concurrent mode: capture() only stamps the event and pushes it into a
+// lock-free ring of that many slots (rounded up to a power of two), so the tap
+// thread never allocates or blocks; a consumer thread calls drain() to move
+// queued events into the store. When the ring is full the event is dropped and
+// counted, rather than stalling the tap.
+//
+// motionFilter thins pointer motion as events are stored (see MotionFilter);
+// it runs on the storing thread, never on the tap thread.
+struct RecorderOptions {
+  std::size_t ringCapacity = 0;
+  std::optional<MotionFilterOptions> motionFilter;
+};
+
+// Counters for a recording. highWater is the most events ever queued in the
+// ring at once; if it approaches the capacity, drain more often or enlarge it.
+// filtered counts moves the motion filter discarded.
+struct RecorderStats {
+  std::size_t captured = 0;
+  std::size_t dropped = 0;
+  std::size_t highWater = 0;
+  std::size_t filtered = 0;
+
+  // Events captured per event stored: 1.0 without a motion filter.
+  [[nodiscard]] double compressionRatio() const {
+    const std::size_t stored = captured - filtered;
+    return stored == 0 ? 1.0
+                       : static_cast<double>(captured) /
+                             static_cast<double>(stored);
+  }
 };
 
 // Captures a timeline of normalized input events and replays it through a
@@ -26,33 +61,110 @@ struct ReplayOptions {
 // no dynamic_cast in the replay loop), dispatched by std::visit. Timing is
 // driven off a steady clock against timestamps relative to recording start, so a
 // timeline replays with the same cadence every time.
+//
+// Events are kept in a segmented EventStore, so a long recording grows without
+// ever copying what it has already captured. events() returns that store
+// rather than a std::vector; it indexes and iterates the same way. A Recorder
+// is move-only.
 class Recorder {
  public:
   Recorder() = default;
+  explicit Recorder(const RecorderOptions& options);
 
   // Append an event, stamped with the elapsed time since the first recorded
-  // event (or since reset). Typically wired to an EventTap as its sink.
+  // event (or since reset). Typically wired to an EventTap as its sink; in
+  // concurrent mode this is the single producer and may run on the tap thread.
+  // The TimedEvent overload stamps with the event's own time, which keeps
+  // callback scheduling delay out of the timeline; the other uses the time of
+  // the call. The span overload takes a whole batch from an EventBatchSink,
+  // updating the counters once per batch.
+  void capture(const TimedEvent& event);
   void capture(const InputEvent& event);
+  void capture(std::span<const TimedEvent> batch);
 
-  [[nodiscard]] const std::vector<RecordedEvent>& events() const {
-    return events_;
-  }
+  // Concurrent mode: move every event queued so far into the store and return
+  // how many were moved. Call from one consumer thread, periodically while
+  // the tap runs and once after it stops. A no-op returning 0 otherwise.
+  std::size_t drain();
+
+  // With a motion filter: store the moves it is still holding back. Call once
+  // capture has stopped (after the final drain() in concurrent mode); until
+  // then the tail of the motion is not in events(). A no-op otherwise.
+  void flush();
+
+  // The stored timeline. In concurrent mode, read it only from the thread that
+  // calls drain(); events still in the ring are not visible until drained.
+  [[nodiscard]] const EventStore& events() const { return events_; }
   [[nodiscard]] bool empty() const { return events_.empty(); }
 
-  // Discard all events and restart the clock at the next capture.
+  [[nodiscard]] RecorderStats stats() const;
+
+  // Discard all events, counters and queued events, and restart the clock at
+  // the next capture. Not safe while a tap is still capturing.
   void reset();
 
+  // Write the stored timeline to path in the compact recording format (see
+  // RecordingFile.h). Concurrent mode: drain() first; queued events are not
+  // saved.
+  [[nodiscard]] std::expected<void, Error> save(std::string_view path) const;
+
+  // Replace the stored timeline with the recording at path, resetting
+  // everything else as reset() does: counters, queued events and the motion
+  // filter. A later capture continues the loaded timeline from its last
+  // timestamp. On failure nothing is changed. Not safe while a tap is
+  // capturing.
+  [[nodiscard]] std::expected<void, Error> load(std::string_view path);
+
   // Replay every event in order against the given Session, honoring the recorded
   // gaps (scaled/capped per options). Physical key events replay by position and
   // are therefore layout-independent. Returns the first error encountered.
-  [[nodiscard]] std::expected<void, Error> replay(
+  [[nodiscard]] std::expected<ReplayStats, Error> replay(
+      Session& session, const ReplayOptions& options = {}
+  ) const;
+
+  // Replay to every target at once, each with its own position in the
+  // timeline, from the calling thread. One scheduler issues every target's
+  // events in deadline order against a shared clock, so dozens of Sessions
+  // (say, one per Xvfb display) need no thread each. Stops at the first
+  // injection error, releasing whatever any target still holds. Returns stats
+  // per target, in order.
+  [[nodiscard]] std::expected<std::vector<ReplayStats>, Error> replay(
+      std::span<const ReplayTarget> targets, const ReplayOptions& options = {}
+  ) const;
+
+  // Replay as replay() does, on a scheduler thread steered through the
+  // returned handle: pause, resume, cancel, seek and progress (see
+  // ReplayHandle). Invalid options make the result ready with the error. The
+  // stored timeline must not change until the handle is destroyed.
+  [[nodiscard]] ReplayHandle replayAsync(
       Session& session, const ReplayOptions& options = {}
   ) const;
 
  private:
-  std::vector<RecordedEvent> events_;
+  [[nodiscard]] RecordedEvent stamp(
+      std::chrono::steady_clock::time_point time, const InputEvent& event
+  );
+  void store(const RecordedEvent& event);
+  // Everything reset() clears except the stored events.
+  void restartCapture();
+
+  EventStore events_;
+  std::optional<MotionFilter> filter_;
+  std::unique_ptr<SpscRing<RecordedEvent>> ring_;
+  // Read from anywhere through stats(). Held by pointer so the Recorder
+  // stays movable; a moved-from Recorder may only be destroyed or assigned.
+  struct Counters {
+    // Written by the producer.
+    std::atomic<std::size_t> captured{0};
+    std::atomic<std::size_t> dropped{0};
+    std::atomic<std::size_t> highWater{0};
+    // Written by the storing thread.
+    std::atomic<std::size_t> filtered{0};
+  };
+  std::unique_ptr<Counters> counters_ = std::make_unique<Counters>();
   bool started_ = false;
   std::chrono::steady_clock::time_point start_{};
+  std::chrono::microseconds last_{0};
 };
 
 }  // namespace robot
\ No newline at end of file
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <expected>
+#include <memory>
+#include <optional>
+#include <string_view>
+
+#include "robot/Error.h"
+#include "robot/Event.h"
+
+namespace robot {
+
+// Streaming access to the compact on-disk recording format. Events are coded
+// one after another with a one-byte tag, a varint time delta and delta-coded,
+// quantized positions (1/8 of a logical unit; scroll amounts to 1/120 of a
+// notch), which typically shrinks a recording to a few bytes per event. Both
+// ends move data through a fixed 64 KiB chunk buffer, so neither holds the
+// whole recording in memory.
+//
+// Positions are rounded to the quantum above; every other field, including the
+// microsecond timestamps, round-trips exactly.
+
+// Writes a recording file event by event. Events must be written in timestamp
+// order, from zero up: write() rejects one stamped before the last with
+// InvalidArgument and writes nothing. Call close() to flush and see any final
+// I/O error; the destructor flushes too but has nowhere to report a failure.
+class RecordingWriter {
+ public:
+  // Create (or truncate) the file at path and write the format header.
+  [[nodiscard]] static std::expected<RecordingWriter, Error> create(
+      std::string_view path
+  );
+
+  RecordingWriter(RecordingWriter&&) noexcept;
+  RecordingWriter& operator=(RecordingWriter&&) noexcept;
+  ~RecordingWriter();
+
+  [[nodiscard]] std::expected<void, Error> write(const RecordedEvent& event);
+  [[nodiscard]] std::expected<void, Error> close();
+
+ private:
+  struct Impl;
+  explicit RecordingWriter(std::unique_ptr<Impl> impl);
+  std::unique_ptr<Impl> impl_;
+};
+
+// Reads a recording file event by event.
+class RecordingReader {
+ public:
+  // Open path and validate its header. Fails with InvalidArgument when the
+  // file is not a recording or uses an unknown format version.
+  [[nodiscard]] static std::expected<RecordingReader, Error> open(
+      std::string_view path
+  );
+
+  RecordingReader(RecordingReader&&) noexcept;
+  RecordingReader& operator=(RecordingReader&&) noexcept;
+  ~RecordingReader();
+
+  // The next event, nullopt at a clean end of file, or IoError on a read
+  // failure or a truncated or corrupt event.
+  [[nodiscard]] std::expected<std::optional<RecordedEvent>, Error> next();
+
+ private:
+  struct Impl;
+  explicit RecordingReader(std::unique_ptr<Impl> impl);
+  std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace robot
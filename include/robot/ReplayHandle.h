@@ -0,0 +1,127 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <future>
+#include <memory>
+
+#include "robot/Error.h"
+#include "robot/Pacing.h"
+
+namespace robot {
+
+class Session;
+
+// Options controlling replay pacing.
+struct ReplayOptions {
+  // Multiplies every inter-event gap: 2.0 replays at half speed, 0.5 at double.
+  double timeScale = 1.0;
+  // Upper bound on any single wait, so a long idle gap in the recording does not
+  // freeze replay. Zero disables the cap.
+  std::chrono::milliseconds maxGap{0};
+  // The window of the recording to replay: events stamped in [from, to]. A
+  // zero `to` runs to the end. Replay starts at the first event in the window
+  // without waiting out the time before it.
+  std::chrono::microseconds from{0};
+  std::chrono::microseconds to{0};
+  // Passes over the window, back to back. Must be at least 1.
+  std::size_t loops = 1;
+  // How each event's deadline is waited for (see PacingMode). Events whose
+  // deadline has already passed - the rest of a burst, or everything after a
+  // stall - are issued back to back without waiting at all.
+  PacingMode pacing = PacingMode::Sleep;
+  std::chrono::microseconds spinWindow{1000};
+  // Raise the replaying thread's scheduling priority for the duration, so a
+  // busy machine preempts it less (best effort; see ReplayStats).
+  bool raisePriority = false;
+};
+
+// What a replay actually did. lateness is measured from each event's deadline
+// to the moment it was issued; immediate counts events that were already due
+// when reached, so were issued without any wait.
+// cancelled is set when an asynchronous replay was cancelled before the end.
+struct ReplayStats {
+  std::size_t events = 0;
+  std::size_t immediate = 0;
+  Lateness lateness;
+  bool priorityRaised = false;
+  bool cancelled = false;
+};
+
+// One Session driven by a multi-session replay. offset delays this target's
+// whole timeline; jitter moves each of its events by a random amount in
+// [-jitter, +jitter] (never reordering them), so many displays replaying one
+// recording do not act in lockstep. The jitter sequence is seeded from the
+// target's position in the list, so a run is reproducible.
+struct ReplayTarget {
+  Session* session = nullptr;
+  std::chrono::microseconds offset{0};
+  std::chrono::microseconds jitter{0};
+};
+
+enum class ReplayState : std::uint8_t {
+  Running,
+  Paused,
+  Finished,
+  Cancelled,
+  Failed,
+};
+
+// A snapshot of an asynchronous replay. position is the timestamp of the last
+// event issued and duration that of the last event in the recording, so
+// position / duration is the fraction done within one pass.
+struct ReplayProgress {
+  ReplayState state = ReplayState::Running;
+  std::size_t issued = 0;
+  std::size_t pass = 0;
+  std::chrono::microseconds position{0};
+  std::chrono::microseconds duration{0};
+};
+
+// Controls a replay running on its own scheduler thread, started by
+// Recorder::replayAsync or MappedRecording::replayAsync. The caller's thread
+// stays free to watch the screen, steer the replay, or wait on result().
+//
+// Every control call is thread-safe and returns immediately; the scheduler
+// acts on it before its next event, interrupting a long wait if need be.
+// Whenever replay stops early (cancel, an injection error) and before a seek,
+// every key and mouse button the replay pressed and has not yet released is
+// released, so nothing is left stuck down.
+//
+// The Session and the recording must outlive the handle. Destroying the
+// handle cancels the replay and joins the thread.
+class ReplayHandle {
+ public:
+  ReplayHandle(ReplayHandle&&) noexcept;
+  ReplayHandle& operator=(ReplayHandle&&) noexcept;
+  ~ReplayHandle();
+
+  // Hold the next event until resume(). Time spent paused is not counted
+  // against any deadline: the remaining gaps are replayed in full.
+  void pause();
+  void resume();
+  // Stop before the next event. result() then holds stats with cancelled set.
+  void cancel();
+  // Continue from the first event stamped at or after timestamp (clamped into
+  // the options' window), within the current pass. It is issued at once.
+  void seek(std::chrono::microseconds timestamp);
+
+  [[nodiscard]] ReplayProgress progress() const;
+
+  // Becomes ready when the replay ends for any reason: the stats, or the
+  // error that stopped it.
+  [[nodiscard]] std::shared_future<std::expected<ReplayStats, Error>> result()
+      const;
+
+  struct State;  // Defined with the replay engine.
+
+ private:
+  friend class Recorder;
+  friend class MappedRecording;
+  explicit ReplayHandle(std::unique_ptr<State> state);
+  std::unique_ptr<State> state_;
+};
+
+}  // namespace robot
@@ -7,19 +7,31 @@
 // entirely behind the backend interfaces, which this public surface only
 // forward-declares.
 
+#include "robot/AsyncSession.h"
 #include "robot/Capabilities.h"
 #include "robot/Error.h"
 #include "robot/Event.h"
+#include "robot/EventStore.h"
 #include "robot/EventTap.h"
 #include "robot/Geometry.h"
 #include "robot/Image.h"
 #include "robot/Key.h"
 #include "robot/Keyboard.h"
+#include "robot/MappedRecording.h"
 #include "robot/Modifiers.h"
 #include "robot/Monitor.h"
+#include "robot/MotionFilter.h"
 #include "robot/Mouse.h"
 #include "robot/MouseButton.h"
+#include "robot/Pacing.h"
 #include "robot/Recorder.h"
+#include "robot/RecordingFile.h"
+#include "robot/ReplayHandle.h"
 #include "robot/Scroll.h"
 #include "robot/Screen.h"
-#include "robot/Session.h"
\ No newline at end of file
+#include "robot/ScriptExecutor.h"
+#include "robot/ScriptSession.h"
+#include "robot/Session.h"
+#include "robot/SpscRing.h"
+#include "robot/Task.h"
+#include "robot/Trajectory.h"
\ No newline at end of file
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <expected>
+#include <future>
+#include <memory>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "robot/Error.h"
+#include "robot/Task.h"
+
+namespace robot {
+
+namespace scripting {
+class TimerWheel;
+}
+
+// Runs input scripts - Tasks built from ScriptSession operations - as
+// coroutines on the thread that calls run(). A script that waits (a gesture's
+// gap, a settle, sleepFor) parks on a timer wheel instead of blocking the
+// thread, so thousands of scripts can interleave on one thread, each keeping
+// its own timing against its own deadlines.
+//
+// A wait is met no earlier than its deadline and as close after it as the
+// thread's sleeps and the other scripts' work allow. PacingMode::Hybrid
+// spinning is not used, since a spinning script would stall every other
+// one. Not thread-safe: spawn and run from one thread.
+class ScriptExecutor {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  // resolution is the width of one wheel slot. It bounds nothing about
+  // precision - deadlines are kept exact - and only trades slot count
+  // against how many timers share a slot.
+  explicit ScriptExecutor(
+      std::chrono::microseconds resolution = std::chrono::milliseconds(1)
+  );
+  // Destroys every unfinished script; their futures hold Cancelled. A gesture
+  // destroyed mid-way releases what it holds, so the sessions the scripts
+  // use must still exist.
+  ~ScriptExecutor();
+  ScriptExecutor(const ScriptExecutor&) = delete;
+  ScriptExecutor& operator=(const ScriptExecutor&) = delete;
+  ScriptExecutor(ScriptExecutor&&) = delete;
+  ScriptExecutor& operator=(ScriptExecutor&&) = delete;
+
+  // Queue script to start at the next run(), or, when called from a running
+  // script, once that script next waits. The future is ready when it ends.
+  template <typename T>
+  std::future<std::expected<T, Error>> spawn(
+      Task<std::expected<T, Error>> script
+  );
+
+  // Run scripts until every spawned one has finished.
+  void run() { (void)runUntil(Clock::time_point::max()); }
+
+  // Run scripts until every spawned one has finished or limit has passed,
+  // whichever is first; true if none is left. Scripts still waiting stay
+  // parked, and the next run picks them up where they are.
+  bool runUntil(Clock::time_point limit);
+
+  // Scripts spawned and not yet finished.
+  [[nodiscard]] std::size_t active() const { return roots_.size(); }
+
+  // co_await sleepUntil(t): resume this script once t has passed. Always
+  // suspends, so a past deadline lets the other scripts run first.
+  class Sleep {
+   public:
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle) const {
+      executor_->addTimer(deadline_, handle);
+    }
+    void await_resume() const noexcept {}
+
+   private:
+    friend class ScriptExecutor;
+    Sleep(ScriptExecutor& executor, Clock::time_point deadline)
+        : executor_(&executor), deadline_(deadline) {}
+
+    ScriptExecutor* executor_;
+    Clock::time_point deadline_;
+  };
+
+  [[nodiscard]] Sleep sleepUntil(Clock::time_point deadline) {
+    return {*this, deadline};
+  }
+  [[nodiscard]] Sleep sleepFor(Clock::duration duration) {
+    return {*this, Clock::now() + duration};
+  }
+
+ private:
+  // The frame spawn() wraps each script in: it owns the script's Task, and
+  // leaves the executor's books when it finishes.
+  struct Root {
+    struct promise_type {
+      ScriptExecutor* executor = nullptr;
+
+      Root get_return_object() {
+        return {std::coroutine_handle<promise_type>::from_promise(*this)};
+      }
+      std::suspend_always initial_suspend() noexcept { return {}; }
+      std::suspend_never final_suspend() noexcept { return {}; }
+      void return_void() {
+        executor->retire(
+            std::coroutine_handle<promise_type>::from_promise(*this)
+        );
+      }
+      void unhandled_exception() noexcept { std::terminate(); }
+    };
+    std::coroutine_handle<promise_type> handle;
+  };
+
+  // Sets the result on every path, Cancelled if the frame is destroyed first.
+  template <typename T>
+  struct Completion {
+    std::promise<std::expected<T, Error>> promise;
+    bool set = false;
+
+    void complete(std::expected<T, Error> result) {
+      promise.set_value(std::move(result));
+      set = true;
+    }
+    Completion() = default;
+    Completion(Completion&& other) noexcept
+        : promise(std::move(other.promise)),
+          set(std::exchange(other.set, true)) {}
+    Completion& operator=(Completion&&) = delete;
+    Completion(const Completion&) = delete;
+    Completion& operator=(const Completion&) = delete;
+    ~Completion() {
+      if (!set) promise.set_value(std::unexpected(Error::cancelled("script")));
+    }
+  };
+
+  template <typename T>
+  static Root start(
+      Task<std::expected<T, Error>> script, Completion<T> completion
+  ) {
+    completion.complete(co_await std::move(script));
+  }
+
+  void addTimer(Clock::time_point deadline, std::coroutine_handle<> handle);
+  void adopt(std::coroutine_handle<Root::promise_type> root);
+  void retire(std::coroutine_handle<Root::promise_type> root);
+
+  std::unique_ptr<scripting::TimerWheel> wheel_;
+  std::deque<std::coroutine_handle<>> ready_;
+  std::vector<std::coroutine_handle<>> due_;
+  std::unordered_set<void*> roots_;
+};
+
+template <typename T>
+std::future<std::expected<T, Error>> ScriptExecutor::spawn(
+    Task<std::expected<T, Error>> script
+) {
+  Completion<T> completion;
+  auto future = completion.promise.get_future();
+  adopt(start<T>(std::move(script), std::move(completion)).handle);
+  return future;
+}
+
+}  // namespace robot
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstdint>
+#include <expected>
+#include <string>
+#include <vector>
+
+#include "robot/Error.h"
+#include "robot/Image.h"
+#include "robot/Keyboard.h"
+#include "robot/Monitor.h"
+#include "robot/Mouse.h"
+#include "robot/Screen.h"
+#include "robot/ScriptExecutor.h"
+#include "robot/Task.h"
+
+namespace robot {
+namespace backend {
+class IPlatformBackend;
+}
+
+// Awaitable Keyboard, Mouse and Screen operations for scripts run by a
+// ScriptExecutor:
+//
+//   robot::Task<std::expected<void, robot::Error>> login(
+//       robot::ScriptSession& s
+//   ) {
+//     auto moved = co_await s.moveSmooth({400.0, 300.0});
+//     if (!moved) co_return std::unexpected(moved.error());
+//     if (auto r = co_await s.click(); !r) co_return r;
+//     co_return co_await s.typeTextHumanLike("user");
+//   }
+//
+// Each operation issues the same backend calls as its synchronous namesake,
+// against the same deadlines, but every wait inside it - a gesture's gaps, a
+// drag's settle - suspends the script on the executor's timers rather than
+// sleeping. Operations that never wait run straight through when awaited.
+//
+// Obtained from Session::script(), or built directly over a backend; it, the
+// executor and the backend must outlive every script using it. Arguments are
+// taken by value, since a Task runs after the call that made it returns.
+class ScriptSession {
+ public:
+  ScriptSession(ScriptExecutor& executor, backend::IPlatformBackend& backend);
+
+  template <typename T>
+  using Op = Task<std::expected<T, Error>>;
+
+  // Keyboard: as the methods of the same name on Keyboard.
+  Op<void> press(Key key);
+  Op<void> release(Key key);
+  Op<void> tap(Key key, Modifiers modifiers = {});
+  Op<void> sequence(std::vector<KeyTransition> transitions);
+  Op<void> typeChar(char32_t codepoint);
+  Op<void> typeText(std::string utf8);
+  Op<void> typeTextHumanLike(
+      std::string utf8, HumanTypingOptions options = {}
+  );
+
+  // Mouse: as the methods of the same name on Mouse.
+  Op<void> move(LogicalPoint point);
+  Op<MoveStats> moveSmooth(LogicalPoint point, MouseMoveOptions options = {});
+  Op<MoveStats> followPath(
+      std::vector<LogicalPoint> path, MouseMoveOptions options = {}
+  );
+  Op<LogicalPoint> position();
+  Op<void> press(MouseButton button);
+  Op<void> release(MouseButton button);
+  Op<void> click(MouseButton button = MouseButton::Left);
+  Op<void> doubleClick(MouseButton button = MouseButton::Left);
+  Op<void> drag(LogicalPoint to, MouseButton button = MouseButton::Left);
+  Op<void> dragSmooth(
+      LogicalPoint to, MouseButton button = MouseButton::Left,
+      MouseMoveOptions options = {}
+  );
+  Op<void> scroll(ScrollDelta delta);
+  Op<MoveStats> scrollSmooth(
+      ScrollDelta total, ScrollSmoothOptions options = {}
+  );
+
+  // Screen: as the methods of the same name on Screen.
+  Op<std::vector<Monitor>> monitors();
+  Op<Image> capture(PhysicalRect region);
+  Op<Image> captureMonitor(std::uint32_t monitorId);
+
+  // co_await sleepFor(d): let the other scripts run for d.
+  [[nodiscard]] ScriptExecutor::Sleep sleepFor(
+      ScriptExecutor::Clock::duration duration
+  ) {
+    return executor_->sleepFor(duration);
+  }
+
+  [[nodiscard]] ScriptExecutor& executor() { return *executor_; }
+
+ private:
+  ScriptExecutor* executor_;
+  backend::IPlatformBackend* backend_;
+  Keyboard keyboard_;
+  Mouse mouse_;
+  Screen screen_;
+};
+
+}  // namespace robot
@@ -50,6 +50,8 @@ struct ScrollDelta {
             .vertical = vertical,
             .unit = ScrollUnit::Pixel};
   }
+
+  friend bool operator==(ScrollDelta, ScrollDelta) = default;
 };
 
 }  // namespace robot
@@ -3,6 +3,8 @@
 #include <cstdint>
 #include <expected>
 #include <memory>
+#include <mutex>
+#include <string>
 #include <vector>
 
 #include "robot/Capabilities.h"
@@ -18,6 +20,10 @@ namespace backend {
 class IPlatformBackend;
 }
 
+class AsyncSession;
+class ScriptExecutor;
+class ScriptSession;
+
 // Which Linux backend to select. Ignored on macOS and Windows.
 enum class LinuxBackend : std::uint8_t {
   // Pick the best available at runtime: X11/XTest under an X session, otherwise
@@ -28,8 +34,27 @@ enum class LinuxBackend : std::uint8_t {
   X11,
   // Force the uinput virtual-device backend (needs /dev/uinput write access).
   // This injects at the kernel level and so also works under a Wayland
-  // compositor, but cannot warp the absolute cursor or read pointer position.
+  // compositor. Cursor warps go through a virtual absolute pointer sized to
+  // SessionOptions::uinputDesktop; the pointer position it reports is the last
+  // one it emitted, not a compositor query.
   Uinput,
+  // X11 through XCB instead of Xlib: one thread-safe connection on which
+  // independent requests are pipelined rather than serialized behind a lock,
+  // and capture through MIT-SHM. Only in builds configured with
+  // ROBOT_LINUX_ENABLE_XCB; create() reports Unsupported otherwise. Never
+  // chosen by Auto.
+  Xcb,
+};
+
+// Which X11 facility the event tap reads. Ignored on every other backend.
+enum class X11TapSource : std::uint8_t {
+  // XRecord: copies of the core protocol events, on a second connection.
+  // Needs only the RECORD extension, which every server ships.
+  Record,
+  // XInput2 raw device events on one connection, with fractional positions
+  // and smooth-scroll deltas. Less work per event than XRecord, so events
+  // reach the sink sooner; needs XInput 2.
+  RawInput,
 };
 
 struct SessionOptions {
@@ -40,6 +65,24 @@ struct SessionOptions {
   bool requireInputPermission = false;
   bool requireCapturePermission = false;
   LinuxBackend linuxBackend = LinuxBackend::Auto;
+  // The virtual desktop the uinput absolute pointer spans, in logical units.
+  // Compositors map an absolute device's full axis range onto the whole output
+  // layout, so this must be the layout's bounding box for warps to land where
+  // asked. An empty size probes the connected DRM connectors and assumes they
+  // sit side by side at scale 1; set it explicitly for any other arrangement.
+  // Ignored by every other backend.
+  LogicalRect uinputDesktop;
+  // The uinput backend records by reading /dev/input/event* (which needs read
+  // access: root, or the input group). When true its event tap grabs each
+  // device exclusively while running, so recorded input reaches nothing else;
+  // meant for dedicated recording rigs. Ignored by every other backend.
+  bool evdevGrab = false;
+  // The X display to connect to, such as ":1" for an Xvfb server. Empty uses
+  // $DISPLAY. Lets one process drive several displays, one Session each.
+  // Ignored by every other backend.
+  std::string x11Display;
+  // What the X11 backend's event tap reads (see X11TapSource).
+  X11TapSource x11TapSource = X11TapSource::Record;
 };
 
 // The single entry point and the sole owner of platform state. There is no
@@ -53,12 +96,28 @@ struct SessionOptions {
 // facades it exposes borrow the Session-owned backend, so the Session must
 // outlive any reference taken from it. Non-copyable and non-movable to keep those
 // borrowed references stable.
+//
+// Keyboard, Mouse and Screen may be used from any number of threads at once.
+// Each call is atomic with respect to the others, but a multi-step operation
+// such as a chord or smooth move can interleave with another thread's input.
+// On X11 injection and capture use separate server connections, so a capture
+// never waits for injection, or the reverse. Calls that share a connection
+// are serialized. async() queues the same operations on a worker thread
+// instead, returning futures; script() offers them to coroutines sharing one
+// thread.
 class Session {
  public:
   [[nodiscard]] static std::expected<std::unique_ptr<Session>, Error> create(
       const SessionOptions& options = {}
   );
 
+  // A Session over a backend the caller supplies, such as a test double,
+  // skipping platform selection and probing. The backend's capabilities are
+  // taken as they are.
+  [[nodiscard]] static std::unique_ptr<Session> fromBackend(
+      std::unique_ptr<backend::IPlatformBackend> backend
+  );
+
   ~Session();
   Session(const Session&) = delete;
   Session& operator=(const Session&) = delete;
@@ -69,6 +128,15 @@ class Session {
   [[nodiscard]] Mouse& mouse() { return mouse_; }
   [[nodiscard]] Screen& screen() { return screen_; }
 
+  // The same operations queued on one worker thread and answered with futures
+  // (see AsyncSession). Created on first use; safe to call from any thread.
+  [[nodiscard]] AsyncSession& async();
+
+  // The same operations as awaitables for coroutine scripts run by executor
+  // (see ScriptSession). The executor must outlive the scripts, and this
+  // Session must outlive both.
+  [[nodiscard]] ScriptSession script(ScriptExecutor& executor);
+
   // Always present; start() reports Unsupported if this platform build has no tap
   // implementation (see EventTap).
   [[nodiscard]] EventTap& eventTap() { return eventTap_; }
@@ -96,6 +164,9 @@ class Session {
   Mouse mouse_;
   Screen screen_;
   EventTap eventTap_;
+  std::once_flag asyncOnce_;
+  // Last, so its worker stops before anything it borrows is destroyed.
+  std::unique_ptr<AsyncSession> async_;
 };
 
 }  // namespace robot
\ No newline at end of file
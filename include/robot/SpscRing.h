@@ -0,0 +1,82 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace robot {
+
+// A bounded, lock-free, single-producer / single-consumer queue. Exactly one
+// thread may call tryPush and exactly one (possibly different) thread may call
+// drain; neither ever blocks or allocates after construction, which is what a
+// platform event callback needs: a full ring rejects the push instead of
+// stalling the thread that must return to the OS promptly.
+//
+// Indices grow monotonically and are masked into a power-of-two slot array, so
+// full and empty are distinguishable without a spare slot. Each side keeps a
+// cached copy of the other's index and only reloads it when the cache says the
+// ring is full (producer) or empty (consumer), so the two threads touch each
+// other's cache line rarely.
+template <class T>
+class SpscRing {
+ public:
+  // capacity is rounded up to a power of two (minimum 2).
+  explicit SpscRing(const std::size_t capacity)
+      : capacity_(std::bit_ceil(capacity < 2 ? std::size_t{2} : capacity)),
+        slots_(std::make_unique<T[]>(capacity_)) {}
+
+  SpscRing(const SpscRing&) = delete;
+  SpscRing& operator=(const SpscRing&) = delete;
+
+  // Producer only. False when the ring is full; the value is not enqueued.
+  [[nodiscard]] bool tryPush(const T& value) {
+    const std::size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - producerHead_ == capacity_) {
+      producerHead_ = head_.load(std::memory_order_acquire);
+      if (tail - producerHead_ == capacity_) return false;
+    }
+    slots_[tail & (capacity_ - 1)] = value;
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer only. Hands every element currently queued to consume(T&&), in
+  // order, and returns how many there were.
+  template <class F>
+  std::size_t drain(F&& consume) {
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    if (head == consumerTail_) {
+      consumerTail_ = tail_.load(std::memory_order_acquire);
+      if (head == consumerTail_) return 0;
+    }
+    for (std::size_t i = head; i != consumerTail_; ++i) {
+      consume(std::move(slots_[i & (capacity_ - 1)]));
+    }
+    head_.store(consumerTail_, std::memory_order_release);
+    return consumerTail_ - head;
+  }
+
+  // Elements queued at the moment of the call; exact only when the other side
+  // is idle.
+  [[nodiscard]] std::size_t size() const {
+    return tail_.load(std::memory_order_acquire) -
+           head_.load(std::memory_order_acquire);
+  }
+  [[nodiscard]] std::size_t capacity() const { return capacity_; }
+
+ private:
+  // Fixed rather than std::hardware_destructive_interference_size, whose value
+  // varies by compiler flags and so is unsafe to bake into a public header.
+  static constexpr std::size_t kCacheLine = 64;
+
+  const std::size_t capacity_;
+  const std::unique_ptr<T[]> slots_;
+  alignas(kCacheLine) std::atomic<std::size_t> head_{0};  // Consumer writes.
+  std::size_t consumerTail_ = 0;
+  alignas(kCacheLine) std::atomic<std::size_t> tail_{0};  // Producer writes.
+  std::size_t producerHead_ = 0;
+};
+
+}  // namespace robot
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "robot/Geometry.h"
+
+namespace robot {
+
+// The geometric shape of a pointer path.
+enum class PathShape : std::uint8_t {
+  // The chord from start to target.
+  Straight,
+  // A cubic Bezier whose two inner control points are pushed off the chord by a
+  // random amount (see TrajectoryOptions::curvature), giving the gentle arc of
+  // a hand-driven pointer.
+  Bezier,
+};
+
+// How progress along the path is distributed over time.
+enum class VelocityProfile : std::uint8_t {
+  // Equal path-parameter increments per step: constant speed.
+  Constant,
+  // The minimum-jerk polynomial s(t) = 10t^3 - 15t^4 + 6t^5 (Flash & Hogan):
+  // smooth acceleration from rest and deceleration into the target, the
+  // profile measured in human point-to-point reaching.
+  MinimumJerk,
+};
+
+// Fraction of the distance covered at normalized time t in [0, 1] under a
+// velocity profile. Shared by every gesture that eases along a path.
+[[nodiscard]] double progressAt(VelocityProfile velocity, double t);
+
+// Fitts' law movement time, MT = intercept + slope * log2(distance / width + 1).
+// Long moves to small targets take longer; a zero-distance move takes exactly
+// the intercept. The defaults sit in the range reported for mouse pointing.
+struct FittsTiming {
+  std::chrono::milliseconds intercept{50};
+  std::chrono::milliseconds slope{150};  // Per bit of index of difficulty.
+  double targetWidth = 20.0;             // Logical units.
+
+  [[nodiscard]] std::chrono::milliseconds durationFor(double distance) const;
+};
+
+// Options for a generated pointer path. The defaults (straight, constant
+// speed, no overshoot, no Fitts timing) reproduce plain linear interpolation.
+struct TrajectoryOptions {
+  PathShape shape = PathShape::Straight;
+  VelocityProfile velocity = VelocityProfile::Constant;
+  // Bezier only: each inner control point is displaced perpendicular to the
+  // chord by a uniform random amount in [-curvature, curvature] * distance.
+  double curvature = 0.25;
+  // Overshoot-and-correct: travel past the target by this fraction of the
+  // distance, then correct back onto it. 0 disables. The correction takes
+  // correctionShare of the steps and always uses a minimum-jerk profile.
+  double overshoot = 0.0;
+  double correctionShare = 0.2;
+  // When set, the move's duration comes from Fitts' law for its distance
+  // instead of MouseMoveOptions::duration.
+  std::optional<FittsTiming> fitts;
+  // 0 selects a nondeterministic seed; any other value makes the path (and
+  // thus tests) reproducible, as with HumanTypingOptions::seed.
+  std::uint64_t seed = 0;
+};
+
+// A precomputed pointer path: exactly `steps` points, the last of which is the
+// target. Generation happens entirely before any timed emission, so the emit
+// loop only reads from the buffer; regenerating into the same Trajectory reuses
+// its storage, so a long-lived instance allocates only when a path outgrows
+// every previous one.
+class Trajectory {
+ public:
+  void generate(
+      LogicalPoint from, LogicalPoint to, int steps,
+      const TrajectoryOptions& options
+  );
+
+  [[nodiscard]] std::span<const LogicalPoint> points() const {
+    return points_;
+  }
+
+ private:
+  std::vector<LogicalPoint> points_;
+};
+
+}  // namespace robot
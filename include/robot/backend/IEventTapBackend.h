@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <expected>
 
 #include "robot/Error.h"
@@ -8,10 +9,12 @@
 namespace robot::backend {
 
 // Native global input tap. Translates OS events into normalized InputEvents and
-// forwards them to the sink. A platform build that has no tap implementation
-// simply exposes no IEventTapBackend (IPlatformBackend::eventTap() returns
-// nullptr), and the EventTap facade then reports Unsupported; a build that has
-// one but lacks permission returns PermissionDenied from start().
+// forwards them to the sink in batches per TapOptions, timed with the OS's own
+// event timestamp mapped onto std::chrono::steady_clock where one exists. A
+// platform build that has no tap implementation simply exposes no
+// IEventTapBackend (IPlatformBackend::eventTap() returns nullptr), and the
+// EventTap facade then reports Unsupported; a build that has one but lacks
+// permission returns PermissionDenied from start().
 //
 // start() blocks the calling thread on the platform run loop / message pump
 // until stop() is invoked. The implementation must translate native key events
@@ -24,10 +27,32 @@ class IEventTapBackend {
 
   // Begin tapping and block until stop(). ErrorCode::PermissionDenied when the
   // OS withholds the required access (macOS Accessibility).
-  [[nodiscard]] virtual std::expected<void, Error> start(EventSink sink) = 0;
+  [[nodiscard]] virtual std::expected<void, Error> start(
+      EventBatchSink sink, const TapOptions& options
+  ) = 0;
+
+  // Non-blocking mode, for backends whose event source is a file descriptor:
+  // open the tap and return the descriptor to poll for readability. Unsupported
+  // by default.
+  [[nodiscard]] virtual std::expected<int, Error> startPollable(
+      EventBatchSink /*sink*/, const TapOptions& /*options*/
+  ) {
+    return std::unexpected(
+        Error::unsupported("this event tap has no pollable mode")
+    );
+  }
+
+  // Pollable mode: read what is pending without blocking, deliver it to the
+  // sink on the calling thread, and return how many events were delivered.
+  [[nodiscard]] virtual std::expected<std::size_t, Error> dispatch() {
+    return std::unexpected(
+        Error::unsupported("this event tap has no pollable mode")
+    );
+  }
 
   // Signal the run loop to exit; safe to call from another thread or from inside
-  // the sink. Idempotent.
+  // the sink. Idempotent. In pollable mode, call it from the dispatching
+  // thread: it delivers what was read and closes the tap before returning.
   virtual void stop() = 0;
 
   [[nodiscard]] virtual bool isRunning() const = 0;
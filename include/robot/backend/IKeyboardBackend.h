@@ -1,6 +1,8 @@
 #pragma once
 
 #include <expected>
+#include <span>
+#include <vector>
 
 #include "robot/Error.h"
 #include "robot/Key.h"
@@ -27,6 +29,10 @@ namespace robot::backend {
 // keycodes and layout entirely (CGEventKeyboardSetUnicodeString, KEYEVENTF_
 // UNICODE, XTest with a temporarily remapped keysym). It is the only correct way
 // to emit arbitrary characters and must not be emulated with keyDown/keyUp.
+//
+// keySequence is the batched form of keyDown/keyUp. The default issues them one
+// at a time; a backend whose OS accepts several events per call (SendInput,
+// a uinput write) overrides it to cut the per-event system-call cost.
 class IKeyboardBackend {
  public:
   virtual ~IKeyboardBackend() = default;
@@ -41,6 +47,30 @@ class IKeyboardBackend {
   [[nodiscard]] virtual std::expected<void, Error> typeUnicode(
       char32_t codepoint
   ) = 0;
+
+  // Apply transitions in order. On failure, keys this sequence pressed and had
+  // not yet released are released before the error is returned, so a failed
+  // chord never leaves a modifier stuck.
+  [[nodiscard]] virtual std::expected<void, Error> keySequence(
+      std::span<const KeyTransition> transitions
+  ) {
+    std::vector<Key> held;
+    for (const KeyTransition& t : transitions) {
+      auto r = t.down ? keyDown(t.key) : keyUp(t.key);
+      if (!r) {
+        for (auto it = held.rbegin(); it != held.rend(); ++it) {
+          (void)keyUp(*it);
+        }
+        return r;
+      }
+      if (t.down) {
+        held.push_back(t.key);
+      } else {
+        std::erase(held, t.key);
+      }
+    }
+    return {};
+  }
 };
 
 }  // namespace robot::backend
\ No newline at end of file
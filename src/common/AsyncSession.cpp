@@ -0,0 +1,314 @@
+#include "robot/AsyncSession.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "Gesture.h"
+#include "Pacing.h"
+#include "robot/backend/IPlatformBackend.h"
+
+namespace robot {
+namespace {
+
+// A worker waiting out a gesture's gap on the queue's condition variable
+// hands over to the precise wait this long before the deadline; a cancel
+// arriving later takes effect at the gesture's next wait.
+constexpr auto kInterruptMargin = std::chrono::milliseconds(2);
+
+// One queued call. A gesture is stepped by the worker, which calls finish
+// once it has ended; a plain call does all its work in finish.
+struct Job {
+  std::unique_ptr<gesture::Gesture> gesture{};
+  std::move_only_function<void(bool)> finish{};
+};
+
+}  // namespace
+
+struct AsyncSession::State {
+  explicit State(backend::IPlatformBackend& backend)
+      : keyboard(&backend.keyboard()),
+        mouse(&backend.mouse()),
+        screen(&backend.screen()),
+        worker([this] { run(); }) {}
+
+  ~State() {
+    std::deque<Job> dropped;
+    {
+      const std::lock_guard lock(mutex);
+      stopping = true;
+      ++generation;
+      dropped.swap(queue);
+    }
+    cv.notify_all();
+    worker.join();
+    for (auto& job : dropped) job.finish(false);
+  }
+
+  State(const State&) = delete;
+  State& operator=(const State&) = delete;
+
+  void push(Job job) {
+    {
+      const std::lock_guard lock(mutex);
+      queue.push_back(std::move(job));
+    }
+    cv.notify_all();
+  }
+
+  void cancel() {
+    std::deque<Job> dropped;
+    {
+      const std::lock_guard lock(mutex);
+      ++generation;
+      dropped.swap(queue);
+    }
+    cv.notify_all();
+    for (auto& job : dropped) job.finish(false);
+  }
+
+  // Queue gesture; the future receives its result, or Cancelled.
+  template <typename G>
+  auto gesture(std::unique_ptr<G> g)
+      -> std::future<decltype(std::declval<const G&>().result())> {
+    using R = decltype(std::declval<const G&>().result());
+    std::promise<R> promise;
+    auto future = promise.get_future();
+    const G* raw = g.get();
+    push(Job{
+        .gesture = std::move(g),
+        .finish = [raw, promise = std::move(promise)](const bool done) mutable {
+          if (done) {
+            promise.set_value(raw->result());
+          } else {
+            promise.set_value(std::unexpected(Error::cancelled("gesture")));
+          }
+        },
+    });
+    return future;
+  }
+
+  void run() {
+    std::unique_lock lock(mutex);
+    for (;;) {
+      cv.wait(lock, [this] { return stopping || !queue.empty(); });
+      if (queue.empty()) return;
+      Job job = std::move(queue.front());
+      queue.pop_front();
+      const std::uint64_t started = generation;
+      lock.unlock();
+      execute(job, started);
+      lock.lock();
+    }
+  }
+
+  void execute(Job& job, const std::uint64_t started) {
+    if (!job.gesture) {
+      job.finish(true);
+      return;
+    }
+    while (const auto wait = job.gesture->step()) {
+      if (!waitOut(*wait, started)) {
+        job.gesture->abandon();
+        job.finish(false);
+        return;
+      }
+    }
+    job.finish(true);
+  }
+
+  // Wait until wait.deadline; false if cancel() or shutdown came first.
+  bool waitOut(const gesture::Wait& wait, const std::uint64_t started) {
+    {
+      std::unique_lock lock(mutex);
+      if (cv.wait_until(lock, wait.deadline - kInterruptMargin, [&] {
+            return generation != started;
+          })) {
+        return false;
+      }
+    }
+    pacing::waitUntil(wait.deadline, wait.pacing, wait.spinWindow);
+    return true;
+  }
+
+  backend::IKeyboardBackend* keyboard;
+  backend::IMouseBackend* mouse;
+  backend::IScreenBackend* screen;
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::deque<Job> queue;
+  // Bumped by cancel() and shutdown; a gesture started under an older value
+  // is abandoned at its next wait.
+  std::uint64_t generation = 0;
+  bool stopping = false;
+  // Last: started once everything it reads is constructed.
+  std::thread worker;
+};
+
+AsyncSession::AsyncSession(backend::IPlatformBackend& backend)
+    : keyboard_(backend.keyboard()),
+      mouse_(backend.mouse(), &backend.screen()),
+      screen_(backend.screen()),
+      state_(std::make_unique<State>(backend)) {}
+
+AsyncSession::~AsyncSession() = default;
+
+void AsyncSession::post(std::move_only_function<void(bool)> call) {
+  state_->push(Job{.finish = std::move(call)});
+}
+
+void AsyncSession::cancel() { state_->cancel(); }
+
+// ── Keyboard ─────────────────────────────────────────────────────────────────
+
+AsyncSession::Result<void> AsyncSession::press(const Key key) {
+  return run([key](Keyboard& k, Mouse&, Screen&) { return k.press(key); });
+}
+
+AsyncSession::Result<void> AsyncSession::release(const Key key) {
+  return run([key](Keyboard& k, Mouse&, Screen&) { return k.release(key); });
+}
+
+AsyncSession::Result<void> AsyncSession::tap(
+    const Key key, const Modifiers modifiers
+) {
+  return run([key, modifiers](Keyboard& k, Mouse&, Screen&) {
+    return k.tap(key, modifiers);
+  });
+}
+
+AsyncSession::Result<void> AsyncSession::sequence(
+    const std::span<const KeyTransition> transitions
+) {
+  std::vector copy(transitions.begin(), transitions.end());
+  return run([copy = std::move(copy)](Keyboard& k, Mouse&, Screen&) {
+    return k.sequence(copy);
+  });
+}
+
+AsyncSession::Result<void> AsyncSession::typeChar(const char32_t codepoint) {
+  return run([codepoint](Keyboard& k, Mouse&, Screen&) {
+    return k.typeChar(codepoint);
+  });
+}
+
+AsyncSession::Result<void> AsyncSession::typeText(const std::string_view utf8) {
+  return run([text = std::string(utf8)](Keyboard& k, Mouse&, Screen&) {
+    return k.typeText(text);
+  });
+}
+
+AsyncSession::Result<void> AsyncSession::typeTextHumanLike(
+    const std::string_view utf8, const HumanTypingOptions& options
+) {
+  return state_->gesture(
+      std::make_unique<gesture::TypeText>(*state_->keyboard, utf8, options)
+  );
+}
+
+// ── Mouse ────────────────────────────────────────────────────────────────────
+
+AsyncSession::Result<void> AsyncSession::move(const LogicalPoint point) {
+  return run([point](Keyboard&, Mouse& m, Screen&) { return m.move(point); });
+}
+
+AsyncSession::Result<MoveStats> AsyncSession::moveSmooth(
+    const LogicalPoint point, const MouseMoveOptions& options
+) {
+  return state_->gesture(std::make_unique<gesture::MoveSmooth>(
+      *state_->mouse, state_->screen, point, options
+  ));
+}
+
+AsyncSession::Result<MoveStats> AsyncSession::followPath(
+    const std::span<const LogicalPoint> path, const MouseMoveOptions& options
+) {
+  return state_->gesture(std::make_unique<gesture::FollowPath>(
+      *state_->mouse, std::vector(path.begin(), path.end()), options
+  ));
+}
+
+AsyncSession::Result<LogicalPoint> AsyncSession::position() {
+  return run([](Keyboard&, Mouse& m, Screen&) { return m.position(); });
+}
+
+AsyncSession::Result<void> AsyncSession::press(const MouseButton button) {
+  return run([button](Keyboard&, Mouse& m, Screen&) {
+    return m.press(button);
+  });
+}
+
+AsyncSession::Result<void> AsyncSession::release(const MouseButton button) {
+  return run([button](Keyboard&, Mouse& m, Screen&) {
+    return m.release(button);
+  });
+}
+
+AsyncSession::Result<void> AsyncSession::click(const MouseButton button) {
+  return run([button](Keyboard&, Mouse& m, Screen&) {
+    return m.click(button);
+  });
+}
+
+AsyncSession::Result<void> AsyncSession::doubleClick(const MouseButton button) {
+  return run([button](Keyboard&, Mouse& m, Screen&) {
+    return m.doubleClick(button);
+  });
+}
+
+AsyncSession::Result<void> AsyncSession::drag(
+    const LogicalPoint to, const MouseButton button
+) {
+  return state_->gesture(std::make_unique<gesture::Drag>(
+      *state_->mouse, state_->screen, to, button, std::nullopt
+  ));
+}
+
+AsyncSession::Result<void> AsyncSession::dragSmooth(
+    const LogicalPoint to, const MouseButton button,
+    const MouseMoveOptions& options
+) {
+  return state_->gesture(std::make_unique<gesture::Drag>(
+      *state_->mouse, state_->screen, to, button, options
+  ));
+}
+
+AsyncSession::Result<void> AsyncSession::scroll(const ScrollDelta delta) {
+  return run([delta](Keyboard&, Mouse& m, Screen&) { return m.scroll(delta); });
+}
+
+AsyncSession::Result<MoveStats> AsyncSession::scrollSmooth(
+    const ScrollDelta total, const ScrollSmoothOptions& options
+) {
+  return state_->gesture(
+      std::make_unique<gesture::ScrollSmooth>(*state_->mouse, total, options)
+  );
+}
+
+// ── Screen ───────────────────────────────────────────────────────────────────
+
+AsyncSession::Result<std::vector<Monitor>> AsyncSession::monitors() {
+  return run([](Keyboard&, Mouse&, Screen& s) { return s.monitors(); });
+}
+
+AsyncSession::Result<Image> AsyncSession::capture(const PhysicalRect region) {
+  return run([region](Keyboard&, Mouse&, Screen& s) {
+    return s.capture(region);
+  });
+}
+
+AsyncSession::Result<Image> AsyncSession::captureMonitor(
+    const std::uint32_t monitorId
+) {
+  return run([monitorId](Keyboard&, Mouse&, Screen& s) {
+    return s.captureMonitor(monitorId);
+  });
+}
+
+}  // namespace robot
@@ -0,0 +1,152 @@
+#include "EventHub.h"
+
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <utility>
+
+#include "robot/backend/IEventTapBackend.h"
+
+namespace robot::tap {
+namespace {
+
+// How often subscribe() checks whether a newly started tap is up.
+constexpr auto kStartPoll = std::chrono::milliseconds(1);
+
+}  // namespace
+
+void Subscriber::offer(const std::span<const TimedEvent> batch) {
+  std::size_t pushed = 0;
+  std::size_t lost = 0;
+  for (const TimedEvent& e : batch) {
+    if (!filter.accepts(e.event)) continue;
+    if (ring.tryPush(e)) {
+      ++pushed;
+    } else {
+      ++lost;
+    }
+  }
+  if (lost > 0) dropped.fetch_add(lost, std::memory_order_relaxed);
+  if (pushed > 0) {
+    signal.fetch_add(1, std::memory_order_release);
+    signal.notify_one();
+  }
+}
+
+void Subscriber::run() {
+  std::vector<TimedEvent> batch;
+  batch.reserve(ring.capacity());
+  while (true) {
+    // Read the signal before draining: a push that lands after the drain
+    // changes it, so the wait below cannot miss it.
+    const std::uint32_t seen = signal.load(std::memory_order_acquire);
+    batch.clear();
+    ring.drain([&](TimedEvent&& e) { batch.push_back(std::move(e)); });
+    if (!batch.empty()) {
+      sink(batch);
+      continue;
+    }
+    if (stopping.load()) return;
+    signal.wait(seen, std::memory_order_acquire);
+  }
+}
+
+void Subscriber::shutdown() {
+  stopping.store(true);
+  signal.fetch_add(1, std::memory_order_release);
+  signal.notify_one();
+  if (!thread.joinable()) return;
+  if (thread.get_id() == std::this_thread::get_id()) {
+    thread.detach();  // The thread's own reference keeps this alive.
+  } else {
+    thread.join();
+  }
+}
+
+Hub::~Hub() {
+  std::vector<std::shared_ptr<Subscriber>> remaining;
+  {
+    const std::lock_guard lock(mutex_);
+    remaining.swap(subscribers_);
+  }
+  stopTap();
+  for (const auto& s : remaining) s->shutdown();
+}
+
+std::expected<std::shared_ptr<Subscriber>, Error> Hub::subscribe(
+    EventBatchSink sink, const SubscriberOptions& options
+) {
+  const std::lock_guard lifecycle(lifecycle_);
+  if (!serving_.load()) {
+    if (auto r = startTap(); !r) return std::unexpected(r.error());
+  }
+
+  auto subscriber = std::make_shared<Subscriber>(std::move(sink), options);
+  subscriber->thread = std::thread([s = subscriber] { s->run(); });
+  const std::lock_guard lock(mutex_);
+  subscribers_.push_back(subscriber);
+  return subscriber;
+}
+
+void Hub::unsubscribe(const std::shared_ptr<Subscriber>& subscriber) {
+  const std::lock_guard lifecycle(lifecycle_);
+  bool last = false;
+  {
+    const std::lock_guard lock(mutex_);
+    const auto it =
+        std::find(subscribers_.begin(), subscribers_.end(), subscriber);
+    if (it == subscribers_.end()) return;
+    subscribers_.erase(it);
+    last = subscribers_.empty();
+  }
+  // Off the list, so the tap no longer pushes to it: its ring has one
+  // producer fewer and can drain to empty.
+  subscriber->shutdown();
+  if (last) stopTap();
+}
+
+std::expected<void, Error> Hub::startTap() {
+  if (backend_.isRunning()) {
+    return std::unexpected(Error::unsupported(
+        "the event tap is already running through EventTap::start"
+    ));
+  }
+
+  std::promise<std::expected<void, Error>> finished;
+  auto result = finished.get_future();
+  thread_ = std::thread([this, finished = std::move(finished)]() mutable {
+    finished.set_value(backend_.start(
+        [this](std::span<const TimedEvent> batch) { publish(batch); },
+        TapOptions{}
+    ));
+  });
+
+  // start() blocks for the life of the tap, so success shows as the backend
+  // running and failure as start() returning.
+  while (!backend_.isRunning()) {
+    if (result.wait_for(kStartPoll) == std::future_status::ready) {
+      thread_.join();
+      auto r = result.get();
+      if (!r) return r;
+      return std::unexpected(
+          Error::backendUnavailable("the event tap stopped as it started")
+      );
+    }
+  }
+  serving_.store(true);
+  return {};
+}
+
+void Hub::stopTap() {
+  if (!thread_.joinable()) return;
+  backend_.stop();
+  thread_.join();
+  serving_.store(false);
+}
+
+void Hub::publish(const std::span<const TimedEvent> batch) {
+  const std::lock_guard lock(mutex_);
+  for (const auto& s : subscribers_) s->offer(batch);
+}
+
+}  // namespace robot::tap
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "TapFilter.h"
+#include "robot/Error.h"
+#include "robot/EventTap.h"
+#include "robot/SpscRing.h"
+
+namespace robot::backend {
+class IEventTapBackend;
+}
+
+// Common internal: one platform tap shared by any number of subscribers. The
+// backend runs once, on the hub's own thread; each batch it reads is filtered
+// per subscriber and copied into that subscriber's bounded ring, and every
+// subscriber drains its ring on its own delivery thread. The tap thread only
+// ever pushes into rings, so a slow subscriber loses its own events (counted)
+// and never delays the tap or anyone else.
+namespace robot::tap {
+
+struct Subscriber {
+  Subscriber(EventBatchSink s, const SubscriberOptions& options)
+      : sink(std::move(s)),
+        filter(options.filter),
+        ring(options.queueCapacity) {}
+
+  // Tap thread: queue the accepted events and wake the delivery thread once.
+  void offer(std::span<const TimedEvent> batch);
+  // Delivery thread: hand queued events to the sink until stopped, then
+  // deliver whatever is left.
+  void run();
+  // Stop and join the delivery thread; detached instead when called from the
+  // sink itself.
+  void shutdown();
+
+  EventBatchSink sink;
+  Filter filter;
+  SpscRing<TimedEvent> ring;
+  std::atomic<std::uint32_t> signal{0};
+  std::atomic<bool> stopping{false};
+  std::atomic<std::size_t> dropped{0};
+  std::thread thread;
+};
+
+class Hub {
+ public:
+  explicit Hub(backend::IEventTapBackend& backend) : backend_(backend) {}
+  ~Hub();
+
+  Hub(const Hub&) = delete;
+  Hub& operator=(const Hub&) = delete;
+
+  // The first subscriber starts the tap; the error is the backend's if it
+  // cannot.
+  [[nodiscard]] std::expected<std::shared_ptr<Subscriber>, Error> subscribe(
+      EventBatchSink sink, const SubscriberOptions& options
+  );
+  // The last subscriber to leave stops the tap.
+  void unsubscribe(const std::shared_ptr<Subscriber>& subscriber);
+
+  [[nodiscard]] bool serving() const { return serving_.load(); }
+
+ private:
+  [[nodiscard]] std::expected<void, Error> startTap();
+  void stopTap();
+  void publish(std::span<const TimedEvent> batch);
+
+  backend::IEventTapBackend& backend_;
+  // Serializes subscribe and unsubscribe, and so starting and stopping.
+  std::mutex lifecycle_;
+  // Guards subscribers_, held by the tap thread for one batch at a time.
+  std::mutex mutex_;
+  std::vector<std::shared_ptr<Subscriber>> subscribers_;
+  std::thread thread_;
+  std::atomic<bool> serving_{false};
+};
+
+}  // namespace robot::tap
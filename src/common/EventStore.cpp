@@ -0,0 +1,20 @@
+#include "robot/EventStore.h"
+
+namespace robot {
+
+void EventStore::push_back(const RecordedEvent& event) {
+  if (size_ == segments_.size() * kSegmentSize) {
+    segments_.push_back(std::make_unique<RecordedEvent[]>(kSegmentSize));
+  }
+  segments_[size_ / kSegmentSize][size_ % kSegmentSize] = event;
+  ++size_;
+}
+
+void EventStore::clear() {
+  // Keep the first segment: a recorder that is reset and reused does not pay
+  // for the allocation again.
+  if (segments_.size() > 1) segments_.resize(1);
+  size_ = 0;
+}
+
+}  // namespace robot
@@ -2,25 +2,134 @@
 
 #include <utility>
 
+#include "EventHub.h"
 #include "robot/backend/IEventTapBackend.h"
 
 namespace robot {
 
+Subscription::Subscription(
+    tap::Hub* hub, std::shared_ptr<tap::Subscriber> subscriber
+)
+    : hub_(hub), subscriber_(std::move(subscriber)) {}
+
+Subscription::Subscription(Subscription&& other) noexcept
+    : hub_(std::exchange(other.hub_, nullptr)),
+      subscriber_(std::move(other.subscriber_)) {}
+
+Subscription& Subscription::operator=(Subscription&& other) noexcept {
+  if (this != &other) {
+    unsubscribe();
+    hub_ = std::exchange(other.hub_, nullptr);
+    subscriber_ = std::move(other.subscriber_);
+  }
+  return *this;
+}
+
+Subscription::~Subscription() { unsubscribe(); }
+
+void Subscription::unsubscribe() {
+  if (subscriber_ == nullptr) return;
+  hub_->unsubscribe(subscriber_);
+  subscriber_.reset();
+  hub_ = nullptr;
+}
+
+std::size_t Subscription::dropped() const {
+  return subscriber_ == nullptr
+             ? 0
+             : subscriber_->dropped.load(std::memory_order_relaxed);
+}
+
+EventTap::EventTap(backend::IEventTapBackend* backend)
+    : backend_(backend),
+      hub_(backend != nullptr ? std::make_unique<tap::Hub>(*backend)
+                              : nullptr) {}
+
+// Defined here, where Hub is complete; stops a shared tap still serving.
+EventTap::~EventTap() = default;
+
 std::expected<void, Error> EventTap::start(EventSink sink) {
+  return start(TimedEventSink(
+      [sink = std::move(sink)](const TimedEvent& e) { sink(e.event); }
+  ));
+}
+
+std::expected<void, Error> EventTap::start(TimedEventSink sink) {
+  // Batches of one: each event is delivered the moment it is read.
+  return start(
+      EventBatchSink([sink = std::move(sink)](std::span<const TimedEvent> b) {
+        for (const TimedEvent& e : b) sink(e);
+      }),
+      TapOptions{.maxBatch = 1}
+  );
+}
+
+std::expected<void, Error> EventTap::start(
+    EventBatchSink sink, const TapOptions& options
+) {
+  if (auto r = checkStart(options); !r) return r;
+  return backend_->start(std::move(sink), options);
+}
+
+std::expected<int, Error> EventTap::startPollable(
+    EventBatchSink sink, const TapOptions& options
+) {
+  if (auto r = checkStart(options); !r) return std::unexpected(r.error());
+  return backend_->startPollable(std::move(sink), options);
+}
+
+std::expected<std::size_t, Error> EventTap::dispatch() {
+  if (backend_ == nullptr) {
+    return std::unexpected(Error::unsupported(
+        "global event recording is not available in this platform build"
+    ));
+  }
+  return backend_->dispatch();
+}
+
+std::expected<void, Error> EventTap::checkStart(
+    const TapOptions& options
+) const {
   if (backend_ == nullptr) {
     return std::unexpected(Error::unsupported(
         "global event recording is not available in this platform build"
     ));
   }
-  return backend_->start(std::move(sink));
+  if (hub_->serving()) {
+    return std::unexpected(
+        Error::unsupported("the event tap is serving subscribers")
+    );
+  }
+  const EventFilter& f = options.filter;
+  if (!f.keys && !f.motion && !f.buttons && !f.scroll) {
+    return std::unexpected(
+        Error::invalidArgument("the tap's EventFilter excludes every event")
+    );
+  }
+  return {};
 }
 
 void EventTap::stop() {
-  if (backend_ != nullptr) backend_->stop();
+  // The shared tap belongs to its subscribers; only start() and
+  // startPollable() taps are stopped here.
+  if (backend_ != nullptr && !hub_->serving()) backend_->stop();
 }
 
 bool EventTap::isRunning() const {
   return backend_ != nullptr && backend_->isRunning();
 }
 
-}  // namespace robot
\ No newline at end of file
+std::expected<Subscription, Error> EventTap::subscribe(
+    EventBatchSink sink, const SubscriberOptions& options
+) {
+  if (backend_ == nullptr) {
+    return std::unexpected(Error::unsupported(
+        "global event recording is not available in this platform build"
+    ));
+  }
+  auto subscriber = hub_->subscribe(std::move(sink), options);
+  if (!subscriber) return std::unexpected(subscriber.error());
+  return Subscription(hub_.get(), std::move(*subscriber));
+}
+
+}  // namespace robot
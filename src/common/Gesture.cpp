@@ -0,0 +1,377 @@
+#include "Gesture.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "Utf8.h"
+#include "robot/backend/IKeyboardBackend.h"
+#include "robot/backend/IMouseBackend.h"
+#include "robot/backend/IScreenBackend.h"
+
+namespace robot::gesture {
+namespace {
+
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+
+// One interpolation sample per ~4 logical units of travel keeps short hops cheap
+// and long sweeps smooth; the cap bounds work and event volume on huge moves.
+constexpr int kMaxDerivedSteps = 200;
+constexpr double kLogicalUnitsPerStep = 4.0;
+constexpr auto kDragSettle = std::chrono::milliseconds(10);
+// Used by MotionSync::DisplayRefresh when no rate is known; the common floor
+// for desktop panels, so at worst a faster display sees every other frame.
+constexpr double kFallbackFrameRate = 60.0;
+constexpr int kMaxFrameSteps = 10000;
+
+int deriveSteps(const double distance) {
+  const int raw = static_cast<int>(std::lround(distance / kLogicalUnitsPerStep));
+  return std::clamp(raw, 1, kMaxDerivedSteps);
+}
+
+int frameSteps(const std::chrono::milliseconds duration, const double rate) {
+  const double frames =
+      std::ceil(static_cast<double>(duration.count()) * rate / 1000.0);
+  return std::clamp(static_cast<int>(frames), 1, kMaxFrameSteps);
+}
+
+double frameRateAt(
+    backend::IScreenBackend* screen, const LogicalPoint point,
+    const double requested
+) {
+  if (requested > 0.0) return requested;
+  if (screen == nullptr) return kFallbackFrameRate;
+
+  // Enumerated per move rather than cached, since modes change and monitors
+  // hot-plug. Backends answer from the display server's current
+  // configuration without reprobing outputs (RandR's "current" resources on
+  // X11), so this is a few round trips per move, never one per frame.
+  auto monitors = screen->enumerateMonitors();
+  if (!monitors || monitors->empty()) return kFallbackFrameRate;
+  const Monitor* chosen = &monitors->front();  // Primary first.
+  for (const auto& m : *monitors) {
+    if (m.logicalBounds.contains(point)) {
+      chosen = &m;
+      break;
+    }
+  }
+  return chosen->refreshRate > 0.0 ? chosen->refreshRate : kFallbackFrameRate;
+}
+
+}  // namespace
+
+void runBlocking(Gesture& gesture) {
+  while (const auto wait = gesture.step()) {
+    pacing::waitUntil(wait->deadline, wait->pacing, wait->spinWindow);
+  }
+}
+
+// ── TypeText ─────────────────────────────────────────────────────────────────
+
+TypeText::TypeText(
+    backend::IKeyboardBackend& backend, const std::string_view utf8,
+    const HumanTypingOptions& options
+)
+    : backend_(&backend),
+      engine_(options.seed == 0 ? std::random_device{}() : options.seed),
+      gap_(
+          static_cast<double>(options.meanDelay.count()),
+          static_cast<double>(options.stddev.count())
+      ),
+      minMs_(options.minDelay.count()),
+      maxMs_(options.maxDelay.count()) {
+  auto codepoints = decodeUtf8(utf8);
+  if (!codepoints) {
+    result_ = std::unexpected(codepoints.error());
+    return;
+  }
+  text_ = std::move(*codepoints);
+}
+
+std::optional<Wait> TypeText::step() {
+  if (!result_ || next_ == text_.size()) return std::nullopt;
+  if (auto r = backend_->typeUnicode(text_[next_]); !r) {
+    result_ = std::unexpected(r.error());
+    return std::nullopt;
+  }
+  ++next_;
+  long long ms = std::lround(gap_(engine_));
+  ms = std::clamp(ms, minMs_, maxMs_);
+  return Wait{.deadline = Clock::now() + std::chrono::milliseconds(ms)};
+}
+
+// ── FollowPath ───────────────────────────────────────────────────────────────
+
+FollowPath::FollowPath(
+    backend::IMouseBackend& backend, const std::span<const LogicalPoint> path,
+    const MouseMoveOptions& options
+)
+    : backend_(&backend),
+      path_(path),
+      options_(options),
+      duration_(duration_cast<Clock::duration>(options.duration)),
+      steps_(static_cast<int>(path.size())) {}
+
+FollowPath::FollowPath(
+    backend::IMouseBackend& backend, std::vector<LogicalPoint> path,
+    const MouseMoveOptions& options
+)
+    : FollowPath(backend, std::span<const LogicalPoint>(), options) {
+  owned_ = std::move(path);
+  path_ = owned_;
+  steps_ = static_cast<int>(owned_.size());
+}
+
+Wait FollowPath::waitFor(const int i) const {
+  // Every deadline is an absolute offset from one start time: a slow warp or a
+  // late wake-up shortens the following wait rather than pushing the whole
+  // remaining schedule back.
+  return {
+      .deadline = start_ + duration_ * i / steps_,
+      .pacing = options_.pacing,
+      .spinWindow = options_.spinWindow,
+  };
+}
+
+std::optional<Wait> FollowPath::step() {
+  if (i_ == 0) {
+    start_ = Clock::now();
+    if (steps_ == 0) {
+      finish();
+      return std::nullopt;
+    }
+    i_ = 1;
+    return waitFor(i_);
+  }
+
+  const auto now = Clock::now();
+  jitter_.add(now - waitFor(i_).deadline);
+  // Frames whose deadlines have also passed are folded into the latest due
+  // point: one warp now rather than a burst the display cannot show.
+  if (options_.sync == MotionSync::DisplayRefresh) {
+    while (i_ < steps_ && start_ + duration_ * (i_ + 1) / steps_ <= now) {
+      ++i_;
+      ++coalesced_;
+    }
+  }
+
+  const LogicalPoint p = path_[static_cast<std::size_t>(i_ - 1)];
+  if (auto r = backend_->warpCursor(p); !r) {
+    result_ = std::unexpected(r.error());
+    return std::nullopt;
+  }
+  if (i_ == steps_) {
+    finish();
+    return std::nullopt;
+  }
+  return waitFor(++i_);
+}
+
+void FollowPath::finish() {
+  result_ = MoveStats{
+      .steps = steps_,
+      .coalesced = coalesced_,
+      .requested = duration_cast<microseconds>(options_.duration),
+      .achieved = duration_cast<microseconds>(Clock::now() - start_),
+      .jitter = jitter_.result(),
+  };
+}
+
+// ── MoveSmooth ───────────────────────────────────────────────────────────────
+
+MoveSmooth::MoveSmooth(
+    backend::IMouseBackend& backend, backend::IScreenBackend* screen,
+    const LogicalPoint to, const MouseMoveOptions& options, Trajectory* buffer
+)
+    : backend_(&backend),
+      screen_(screen),
+      to_(to),
+      options_(options),
+      buffer_(buffer != nullptr ? buffer : &own_) {}
+
+std::optional<Wait> MoveSmooth::step() {
+  if (follow_) return follow_->step();
+
+  auto from = backend_->cursorPosition();
+  if (!from) {
+    error_ = from.error();
+    return std::nullopt;
+  }
+  const double distance = from->distanceTo(to_);
+
+  MouseMoveOptions timed = options_;
+  if (options_.trajectory.fitts) {
+    timed.duration = options_.trajectory.fitts->durationFor(distance);
+  }
+  int steps = options_.steps > 0 ? options_.steps : deriveSteps(distance);
+  if (options_.sync == MotionSync::DisplayRefresh) {
+    steps = frameSteps(
+        timed.duration, frameRateAt(screen_, *from, options_.frameRate)
+    );
+  }
+
+  // The whole path exists before the first step is timed.
+  buffer_->generate(*from, to_, steps, options_.trajectory);
+  follow_.emplace(*backend_, buffer_->points(), timed);
+  return follow_->step();
+}
+
+std::expected<MoveStats, Error> MoveSmooth::result() const {
+  if (error_) return std::unexpected(*error_);
+  if (!follow_) return std::unexpected(Error::cancelled("smooth move"));
+  return follow_->result();
+}
+
+// ── Drag ─────────────────────────────────────────────────────────────────────
+
+Drag::Drag(
+    backend::IMouseBackend& backend, backend::IScreenBackend* screen,
+    const LogicalPoint to, const MouseButton button,
+    const std::optional<MouseMoveOptions> smooth, Trajectory* buffer
+)
+    : backend_(&backend), to_(to), button_(button) {
+  if (smooth) smooth_.emplace(backend, screen, to, *smooth, buffer);
+}
+
+Wait Drag::settle() { return {.deadline = Clock::now() + kDragSettle}; }
+
+std::optional<Wait> Drag::step() {
+  switch (phase_) {
+    case Phase::Press:
+      if (auto r = backend_->button(button_, ButtonAction::Down, 1); !r) {
+        result_ = r;
+        phase_ = Phase::Done;
+        return std::nullopt;
+      }
+      phase_ = Phase::Move;
+      return settle();
+
+    case Phase::Move:
+      if (!smooth_) {
+        // While the button is held, the backend emits drag events for this
+        // warp.
+        if (auto r = backend_->warpCursor(to_); !r) {
+          (void)backend_->button(button_, ButtonAction::Up, 1);
+          result_ = std::unexpected(r.error());
+          phase_ = Phase::Done;
+          return std::nullopt;
+        }
+        phase_ = Phase::Release;
+        return settle();
+      }
+      phase_ = Phase::Moving;
+      [[fallthrough]];
+
+    case Phase::Moving:
+      if (auto wait = smooth_->step()) return wait;
+      if (auto moved = smooth_->result(); !moved) {
+        moved_ = std::unexpected(moved.error());
+      }
+      phase_ = Phase::Release;
+      return settle();
+
+    case Phase::Release: {
+      auto released = backend_->button(button_, ButtonAction::Up, 1);
+      result_ = moved_ ? released : moved_;
+      phase_ = Phase::Done;
+      return std::nullopt;
+    }
+
+    case Phase::Done:
+      break;
+  }
+  return std::nullopt;
+}
+
+void Drag::abandon() {
+  if (phase_ != Phase::Press && phase_ != Phase::Done) {
+    (void)backend_->button(button_, ButtonAction::Up, 1);
+  }
+  phase_ = Phase::Done;
+}
+
+// ── ScrollSmooth ─────────────────────────────────────────────────────────────
+
+ScrollSmooth::ScrollSmooth(
+    backend::IMouseBackend& backend, const ScrollDelta total,
+    const ScrollSmoothOptions& options
+)
+    : backend_(&backend),
+      total_(total),
+      options_(options),
+      quantum_(options.quantum > 0.0 ? options.quantum : 1.0),
+      duration_(duration_cast<Clock::duration>(options.duration)),
+      sent_{.unit = total.unit} {
+  const double extent =
+      std::max(std::abs(total.vertical), std::abs(total.horizontal));
+  steps_ = options.steps > 0
+               ? options.steps
+               : std::clamp(
+                     static_cast<int>(std::ceil(extent / quantum_)), 1,
+                     kMaxDerivedSteps
+                 );
+}
+
+Wait ScrollSmooth::waitFor(const int i) const {
+  return {
+      .deadline = start_ + duration_ * i / steps_,
+      .pacing = options_.pacing,
+      .spinWindow = options_.spinWindow,
+  };
+}
+
+double ScrollSmooth::quantize(const double v) const {
+  return std::round(v / quantum_) * quantum_;
+}
+
+std::optional<Wait> ScrollSmooth::step() {
+  if (i_ == 0) {
+    start_ = Clock::now();
+    i_ = 1;
+    return waitFor(i_);
+  }
+  jitter_.add(Clock::now() - waitFor(i_).deadline);
+
+  // Each step emits the difference between consecutive rounded cumulative
+  // positions, so the sum telescopes to exactly the rounded total.
+  const double s = progressAt(
+      options_.velocity, static_cast<double>(i_) / static_cast<double>(steps_)
+  );
+  const ScrollDelta target{
+      .horizontal = quantize(total_.horizontal * s),
+      .vertical = quantize(total_.vertical * s),
+      .unit = total_.unit,
+  };
+  const ScrollDelta delta{
+      .horizontal = target.horizontal - sent_.horizontal,
+      .vertical = target.vertical - sent_.vertical,
+      .unit = total_.unit,
+  };
+  if (delta.horizontal == 0.0 && delta.vertical == 0.0) {
+    ++skipped_;
+  } else {
+    if (auto r = backend_->scroll(delta); !r) {
+      result_ = std::unexpected(r.error());
+      return std::nullopt;
+    }
+    sent_ = target;
+  }
+  if (i_ == steps_) {
+    finish();
+    return std::nullopt;
+  }
+  return waitFor(++i_);
+}
+
+void ScrollSmooth::finish() {
+  result_ = MoveStats{
+      .steps = steps_,
+      .coalesced = skipped_,
+      .requested = duration_cast<microseconds>(options_.duration),
+      .achieved = duration_cast<microseconds>(Clock::now() - start_),
+      .jitter = jitter_.result(),
+  };
+}
+
+}  // namespace robot::gesture
@@ -0,0 +1,207 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <optional>
+#include <random>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "Pacing.h"
+#include "robot/Error.h"
+#include "robot/Keyboard.h"
+#include "robot/Mouse.h"
+#include "robot/Trajectory.h"
+
+namespace robot::backend {
+class IKeyboardBackend;
+class IMouseBackend;
+class IScreenBackend;
+}  // namespace robot::backend
+
+// Common internal: the timed gestures of the Keyboard and Mouse facades, cut
+// into steps at each wait. A gesture never waits itself; step() does what is
+// due and says when the next step is. The synchronous facades run a gesture
+// straight through on the calling thread (runBlocking); AsyncSession runs it on
+// its worker and waits out each step on a timer that cancellation interrupts.
+// Either way the backend sees the same calls against the same deadlines.
+namespace robot::gesture {
+
+using Clock = pacing::Clock;
+
+// When the next step is due and how closely to hit it (see PacingMode).
+struct Wait {
+  Clock::time_point deadline;
+  PacingMode pacing = PacingMode::Sleep;
+  std::chrono::microseconds spinWindow{0};
+};
+
+class Gesture {
+ public:
+  Gesture() = default;
+  virtual ~Gesture() = default;
+  // Gestures hold spans into themselves; they stay where they were built.
+  Gesture(const Gesture&) = delete;
+  Gesture& operator=(const Gesture&) = delete;
+
+  // Do what is due now. Returns the next wait, or nullopt once the gesture has
+  // finished and its result is final. The first call starts the gesture.
+  [[nodiscard]] virtual std::optional<Wait> step() = 0;
+
+  // Stop before finishing, releasing whatever the gesture holds down. No step()
+  // follows.
+  virtual void abandon() {}
+};
+
+// Run a gesture to the end on the calling thread, sleeping through each wait.
+void runBlocking(Gesture& gesture);
+
+// typeTextHumanLike: one character per step, each followed by a gap drawn from
+// the options' clamped normal distribution.
+class TypeText final : public Gesture {
+ public:
+  TypeText(
+      backend::IKeyboardBackend& backend, std::string_view utf8,
+      const HumanTypingOptions& options
+  );
+
+  std::optional<Wait> step() override;
+  [[nodiscard]] std::expected<void, Error> result() const { return result_; }
+
+ private:
+  backend::IKeyboardBackend* backend_;
+  std::vector<char32_t> text_;
+  std::size_t next_ = 0;
+  std::mt19937_64 engine_;
+  std::normal_distribution<double> gap_;
+  long long minMs_;
+  long long maxMs_;
+  std::expected<void, Error> result_;
+};
+
+// followPath: one warp per point at start + duration * i / steps, coalescing
+// late points under MotionSync::DisplayRefresh. The path is borrowed unless
+// handed over by value.
+class FollowPath final : public Gesture {
+ public:
+  FollowPath(
+      backend::IMouseBackend& backend, std::span<const LogicalPoint> path,
+      const MouseMoveOptions& options
+  );
+  FollowPath(
+      backend::IMouseBackend& backend, std::vector<LogicalPoint> path,
+      const MouseMoveOptions& options
+  );
+
+  std::optional<Wait> step() override;
+  [[nodiscard]] std::expected<MoveStats, Error> result() const {
+    return result_;
+  }
+
+ private:
+  [[nodiscard]] Wait waitFor(int i) const;
+  void finish();
+
+  backend::IMouseBackend* backend_;
+  std::vector<LogicalPoint> owned_;
+  std::span<const LogicalPoint> path_;
+  MouseMoveOptions options_;
+  Clock::duration duration_{0};
+  int steps_ = 0;
+  int i_ = 0;  // 0 until started; then the point the pending wait is for.
+  int coalesced_ = 0;
+  Clock::time_point start_;
+  pacing::LatenessAccumulator jitter_;
+  std::expected<MoveStats, Error> result_;
+};
+
+// moveSmooth: reads the start position when it starts, generates the whole
+// trajectory into buffer (or a buffer of its own), then follows it.
+class MoveSmooth final : public Gesture {
+ public:
+  MoveSmooth(
+      backend::IMouseBackend& backend, backend::IScreenBackend* screen,
+      LogicalPoint to, const MouseMoveOptions& options,
+      Trajectory* buffer = nullptr
+  );
+
+  std::optional<Wait> step() override;
+  [[nodiscard]] std::expected<MoveStats, Error> result() const;
+
+ private:
+  backend::IMouseBackend* backend_;
+  backend::IScreenBackend* screen_;
+  LogicalPoint to_;
+  MouseMoveOptions options_;
+  Trajectory own_;
+  Trajectory* buffer_;
+  std::optional<FollowPath> follow_;
+  std::optional<Error> error_;
+};
+
+// drag and dragSmooth: press, settle, move (one warp, or a smooth move when
+// options are given), settle, release. The button is released even when the
+// move fails, and by abandon().
+class Drag final : public Gesture {
+ public:
+  Drag(
+      backend::IMouseBackend& backend, backend::IScreenBackend* screen,
+      LogicalPoint to, MouseButton button,
+      std::optional<MouseMoveOptions> smooth, Trajectory* buffer = nullptr
+  );
+
+  std::optional<Wait> step() override;
+  void abandon() override;
+  [[nodiscard]] std::expected<void, Error> result() const { return result_; }
+
+ private:
+  enum class Phase : std::uint8_t { Press, Move, Moving, Release, Done };
+
+  [[nodiscard]] static Wait settle();
+
+  backend::IMouseBackend* backend_;
+  LogicalPoint to_;
+  MouseButton button_;
+  std::optional<MoveSmooth> smooth_;
+  Phase phase_ = Phase::Press;
+  std::expected<void, Error> moved_;
+  std::expected<void, Error> result_;
+};
+
+// scrollSmooth: the total cut into eased steps whose cumulative sums are
+// rounded to the quantum, so the emitted deltas add up to the total.
+class ScrollSmooth final : public Gesture {
+ public:
+  ScrollSmooth(
+      backend::IMouseBackend& backend, ScrollDelta total,
+      const ScrollSmoothOptions& options
+  );
+
+  std::optional<Wait> step() override;
+  [[nodiscard]] std::expected<MoveStats, Error> result() const {
+    return result_;
+  }
+
+ private:
+  [[nodiscard]] Wait waitFor(int i) const;
+  [[nodiscard]] double quantize(double v) const;
+  void finish();
+
+  backend::IMouseBackend* backend_;
+  ScrollDelta total_;
+  ScrollSmoothOptions options_;
+  double quantum_ = 1.0;
+  Clock::duration duration_{0};
+  int steps_ = 0;
+  int i_ = 0;  // 0 until started; then the step the pending wait is for.
+  int skipped_ = 0;
+  ScrollDelta sent_;
+  Clock::time_point start_;
+  pacing::LatenessAccumulator jitter_;
+  std::expected<MoveStats, Error> result_;
+};
+
+}  // namespace robot::gesture
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <span>
+#include <string_view>
+#include <utility>
+
+#include "robot/Error.h"
+
+// Common internal: a read-only memory mapping of a whole file. Portable code
+// only sees a byte span; mapping, paging advice and unmapping are implemented
+// once per OS family (src/platform/posix, src/platform/windows), selected by
+// CMake like every other platform seam.
+namespace robot::mapping {
+
+class MappedFile {
+ public:
+  // Map path read-only. An empty file maps to an empty span.
+  [[nodiscard]] static std::expected<MappedFile, Error> open(
+      std::string_view path
+  );
+
+  MappedFile(MappedFile&& other) noexcept
+      : data_(std::exchange(other.data_, nullptr)),
+        size_(std::exchange(other.size_, 0)) {}
+  MappedFile& operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+      unmap();
+      data_ = std::exchange(other.data_, nullptr);
+      size_ = std::exchange(other.size_, 0);
+    }
+    return *this;
+  }
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  ~MappedFile() { unmap(); }
+
+  [[nodiscard]] std::span<const std::uint8_t> bytes() const {
+    return {data_, size_};
+  }
+
+  // Hint that the mapping will be read front to back, so the OS reads ahead
+  // aggressively and may drop pages behind the reader early.
+  void adviseSequential() const;
+
+  // Hint that [offset, offset + length) will not be read again soon and its
+  // pages can leave the working set. Pages are refetched if touched again.
+  void release(std::size_t offset, std::size_t length) const;
+
+ private:
+  MappedFile(const std::uint8_t* data, const std::size_t size)
+      : data_(data), size_(size) {}
+  void unmap();
+
+  const std::uint8_t* data_ = nullptr;
+  std::size_t size_ = 0;
+};
+
+}  // namespace robot::mapping
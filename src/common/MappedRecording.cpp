@@ -0,0 +1,226 @@
+#include "robot/MappedRecording.h"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "MappedFile.h"
+#include "RecordingCodec.h"
+#include "Replay.h"
+#include "robot/Session.h"
+
+namespace robot {
+namespace {
+
+// Replay and indexing hand pages back to the OS in steps of this many bytes
+// read.
+constexpr std::size_t kReleaseChunk = 1 << 20;
+
+// Release what lies between released and a reader at offset once it reaches
+// kReleaseChunk bytes. A reader behind released (after a seek backwards)
+// releases nothing until it passes it again.
+void releaseBehind(
+    const mapping::MappedFile& file, std::size_t& released,
+    const std::size_t offset
+) {
+  if (offset > released && offset - released >= kReleaseChunk) {
+    file.release(released, offset - released);
+    released = offset;
+  }
+}
+
+// Where decoding can resume: a byte offset and the codec state at it.
+struct Position {
+  std::size_t offset = recording::kHeaderSize;
+  recording::Decoder decoder;
+};
+
+struct IndexEntry {
+  std::chrono::microseconds timestamp{0};
+  std::size_t offset = 0;
+  recording::CodecState state;
+};
+
+}  // namespace
+
+struct MappedRecording::Impl {
+  explicit Impl(mapping::MappedFile mapped) : file(std::move(mapped)) {}
+
+  mapping::MappedFile file;
+  std::vector<IndexEntry> index;
+  std::size_t count = 0;
+  std::chrono::microseconds duration{0};
+
+  // Decode the event at p and advance past it. open() validated every event,
+  // so this only returns false at the end of the file.
+  bool read(Position& p, RecordedEvent& out) const {
+    const auto bytes = file.bytes();
+    if (p.offset >= bytes.size()) return false;
+    const auto n = p.decoder.decode(bytes.subspan(p.offset), out);
+    if (!n) return false;
+    p.offset += *n;
+    return true;
+  }
+
+  // The position of the first event stamped at or after from.
+  Position seek(const std::chrono::microseconds from) const {
+    Position p;
+    // The last index entry strictly before from: the target is at most one
+    // stride of decoding beyond it.
+    const auto it = std::lower_bound(
+        index.begin(), index.end(), from,
+        [](const IndexEntry& e, const std::chrono::microseconds t) {
+          return e.timestamp < t;
+        }
+    );
+    if (it != index.begin()) {
+      const IndexEntry& entry = *std::prev(it);
+      p.offset = entry.offset;
+      p.decoder = recording::Decoder(entry.state);
+    }
+    RecordedEvent event;
+    while (true) {
+      Position probe = p;
+      if (!read(probe, event) || event.timestamp >= from) return p;
+      p = probe;
+    }
+  }
+};
+
+// The mapping as a replay source. Pages already played are handed back to the
+// OS every kReleaseChunk bytes, so a long replay stays lightly resident.
+class MappedRecording::ReplaySource final : public replay::Source {
+ public:
+  explicit ReplaySource(const Impl& impl) : impl_(impl) {}
+
+  void seek(const std::chrono::microseconds from) override {
+    position_ = impl_.seek(from);
+    released_ = position_.offset;
+  }
+
+  bool next(RecordedEvent& out) override {
+    if (!impl_.read(position_, out)) return false;
+    // A seek backwards may start before released_; those pages fault back in.
+    releaseBehind(impl_.file, released_, position_.offset);
+    return true;
+  }
+
+  [[nodiscard]] std::chrono::microseconds duration() const override {
+    return impl_.duration;
+  }
+
+ private:
+  const Impl& impl_;
+  Position position_;
+  std::size_t released_ = recording::kHeaderSize;
+};
+
+struct MappedRecording::Cursor::State {
+  const Impl* impl = nullptr;
+  Position position;
+};
+
+MappedRecording::Cursor::Cursor(std::unique_ptr<State> state)
+    : state_(std::move(state)) {}
+MappedRecording::Cursor::Cursor(Cursor&&) noexcept = default;
+MappedRecording::Cursor& MappedRecording::Cursor::operator=(Cursor&&) noexcept =
+    default;
+MappedRecording::Cursor::~Cursor() = default;
+
+std::optional<RecordedEvent> MappedRecording::Cursor::next() {
+  RecordedEvent event;
+  if (!state_->impl->read(state_->position, event)) return std::nullopt;
+  return event;
+}
+
+MappedRecording::MappedRecording(std::unique_ptr<Impl> impl)
+    : impl_(std::move(impl)) {}
+MappedRecording::MappedRecording(MappedRecording&&) noexcept = default;
+MappedRecording& MappedRecording::operator=(MappedRecording&&) noexcept =
+    default;
+MappedRecording::~MappedRecording() = default;
+
+std::expected<MappedRecording, Error> MappedRecording::open(
+    const std::string_view path
+) {
+  auto file = mapping::MappedFile::open(path);
+  if (!file) return std::unexpected(file.error());
+  auto impl = std::make_unique<Impl>(std::move(*file));
+  const auto bytes = impl->file.bytes();
+  if (auto r = recording::checkHeader(bytes); !r) {
+    return std::unexpected(r.error());
+  }
+  impl->file.adviseSequential();
+
+  // One validating pass, snapshotting the decoder every kIndexStride events.
+  // Pages behind it are released as it goes, so opening a recording larger
+  // than memory does not leave it all resident.
+  Position p;
+  std::size_t released = recording::kHeaderSize;
+  RecordedEvent event;
+  while (p.offset < bytes.size()) {
+    const Position before = p;
+    const auto n = p.decoder.decode(bytes.subspan(p.offset), event);
+    if (!n) return std::unexpected(n.error());
+    // The index's binary search and replay's pacing both need sorted time.
+    if (impl->count > 0 && event.timestamp < impl->duration) {
+      return std::unexpected(
+          Error::ioError("recording timestamps go back in time")
+      );
+    }
+    if (impl->count % kIndexStride == 0) {
+      impl->index.push_back({
+          .timestamp = event.timestamp,
+          .offset = before.offset,
+          .state = before.decoder.state(),
+      });
+    }
+    p.offset += *n;
+    impl->duration = event.timestamp;
+    ++impl->count;
+    releaseBehind(impl->file, released, p.offset);
+  }
+  impl->file.release(released, p.offset - released);
+  return MappedRecording(std::move(impl));
+}
+
+std::size_t MappedRecording::size() const { return impl_->count; }
+
+std::chrono::microseconds MappedRecording::duration() const {
+  return impl_->duration;
+}
+
+MappedRecording::Cursor MappedRecording::seek(
+    const std::chrono::microseconds from
+) const {
+  return Cursor(std::make_unique<Cursor::State>(
+      Cursor::State{.impl = impl_.get(), .position = impl_->seek(from)}
+  ));
+}
+
+std::expected<ReplayStats, Error> MappedRecording::replay(
+    Session& session, const ReplayOptions& options
+) const {
+  ReplaySource source(*impl_);
+  return replay::run(session, source, options, nullptr);
+}
+
+std::expected<std::vector<ReplayStats>, Error> MappedRecording::replay(
+    const std::span<const ReplayTarget> targets, const ReplayOptions& options
+) const {
+  return replay::run(
+      targets, [this] { return std::make_unique<ReplaySource>(*impl_); },
+      options
+  );
+}
+
+ReplayHandle MappedRecording::replayAsync(
+    Session& session, const ReplayOptions& options
+) const {
+  return ReplayHandle(
+      replay::launch(session, std::make_unique<ReplaySource>(*impl_), options)
+  );
+}
+
+}  // namespace robot
@@ -0,0 +1,112 @@
+#include "robot/MotionFilter.h"
+
+#include <cmath>
+#include <utility>
+#include <variant>
+
+namespace robot {
+namespace {
+
+template <class... Ts>
+struct Overloaded : Ts... {
+  using Ts::operator()...;
+};
+
+const LogicalPoint& positionAt(
+    const std::vector<RecordedEvent>& run, const std::size_t i
+) {
+  return std::get<MouseMoveEvent>(run[i].event).position;
+}
+
+// Distance from p to the segment a-b.
+double distanceToSegment(
+    const LogicalPoint p, const LogicalPoint a, const LogicalPoint b
+) {
+  const double dx = b.x - a.x;
+  const double dy = b.y - a.y;
+  const double lengthSquared = dx * dx + dy * dy;
+  if (lengthSquared == 0.0) return p.distanceTo(a);
+  double t = ((p.x - a.x) * dx + (p.y - a.y) * dy) / lengthSquared;
+  t = t < 0.0 ? 0.0 : (t > 1.0 ? 1.0 : t);
+  return p.distanceTo({a.x + t * dx, a.y + t * dy});
+}
+
+}  // namespace
+
+std::optional<LogicalPoint> MotionFilter::positionOf(const InputEvent& event) {
+  return std::visit(
+      Overloaded{
+          [](const KeyEvent&) -> std::optional<LogicalPoint> {
+            return std::nullopt;
+          },
+          [](const auto& e) -> std::optional<LogicalPoint> {
+            return e.position;
+          },
+      },
+      event
+  );
+}
+
+void MotionFilter::addMove(
+    const std::chrono::microseconds timestamp, const LogicalPoint position
+) {
+  // Measure against the last move that is staying: the one before the pending
+  // tail, or the anchor when the run holds at most the tail.
+  std::optional<Anchor> reference = anchor_;
+  if (run_.size() >= 2) {
+    reference = Anchor{run_[run_.size() - 2].timestamp,
+                       positionAt(run_, run_.size() - 2)};
+  }
+  const bool coalesce =
+      !run_.empty() && reference &&
+      (timestamp - reference->timestamp < options_.minInterval ||
+       position.distanceTo(reference->position) < options_.minDistance);
+
+  const RecordedEvent event{timestamp, MouseMoveEvent{position}};
+  if (coalesce) {
+    run_.back() = event;
+    ++dropped_;
+  } else {
+    run_.push_back(event);
+  }
+}
+
+void MotionFilter::simplify() {
+  if (options_.tolerance <= 0.0 || run_.size() < 3) return;
+
+  // Iterative Ramer-Douglas-Peucker over [first, last] spans: keep the point
+  // furthest from the chord if it is out of tolerance and split there.
+  std::vector<bool> keep(run_.size(), false);
+  keep.front() = true;
+  keep.back() = true;
+  std::vector<std::pair<std::size_t, std::size_t>> spans{{0, run_.size() - 1}};
+  while (!spans.empty()) {
+    const auto [first, last] = spans.back();
+    spans.pop_back();
+    double furthest = 0.0;
+    std::size_t split = first;
+    for (std::size_t i = first + 1; i < last; ++i) {
+      const double d = distanceToSegment(
+          positionAt(run_, i), positionAt(run_, first), positionAt(run_, last)
+      );
+      if (d > furthest) {
+        furthest = d;
+        split = i;
+      }
+    }
+    if (furthest > options_.tolerance) {
+      keep[split] = true;
+      spans.emplace_back(first, split);
+      spans.emplace_back(split, last);
+    }
+  }
+
+  std::size_t kept = 0;
+  for (std::size_t i = 0; i < run_.size(); ++i) {
+    if (keep[i]) run_[kept++] = run_[i];
+  }
+  dropped_ += run_.size() - kept;
+  run_.resize(kept);
+}
+
+}  // namespace robot
@@ -1,53 +1,33 @@
 #include "robot/Mouse.h"
 
-#include <algorithm>
-#include <chrono>
-#include <cmath>
 #include <expected>
-#include <thread>
 
+#include "Gesture.h"
 #include "robot/backend/IMouseBackend.h"
 
 namespace robot {
-namespace {
-
-// One interpolation sample per ~4 logical units of travel keeps short hops cheap
-// and long sweeps smooth; the cap bounds work and event volume on huge moves.
-constexpr int kMaxDerivedSteps = 200;
-constexpr double kLogicalUnitsPerStep = 4.0;
-constexpr auto kDragSettle = std::chrono::milliseconds(10);
-
-int deriveSteps(const double distance) {
-  const int raw = static_cast<int>(std::lround(distance / kLogicalUnitsPerStep));
-  return std::clamp(raw, 1, kMaxDerivedSteps);
-}
-
-}  // namespace
 
 std::expected<void, Error> Mouse::move(const LogicalPoint point) {
   return backend_->warpCursor(point);
 }
 
-std::expected<void, Error> Mouse::moveSmooth(
+std::expected<MoveStats, Error> Mouse::moveSmooth(
     const LogicalPoint point, const MouseMoveOptions& options
 ) {
-  auto from = backend_->cursorPosition();
-  if (!from) return std::unexpected(from.error());
-
-  const double dx = point.x - from->x;
-  const double dy = point.y - from->y;
-  const double distance = std::sqrt(dx * dx + dy * dy);
-
-  const int steps = options.steps > 0 ? options.steps : deriveSteps(distance);
-  const auto stepDelay = options.duration / steps;
-
-  for (int i = 1; i <= steps; ++i) {
-    const double t = static_cast<double>(i) / static_cast<double>(steps);
-    const LogicalPoint p{from->x + dx * t, from->y + dy * t};
-    if (auto r = backend_->warpCursor(p); !r) return std::unexpected(r.error());
-    if (stepDelay.count() > 0) std::this_thread::sleep_for(stepDelay);
-  }
-  return {};
+  // One buffer per thread, reused across moves: generation allocates only when
+  // a path is longer than any this thread has produced before.
+  thread_local Trajectory trajectory;
+  gesture::MoveSmooth move(*backend_, screen_, point, options, &trajectory);
+  gesture::runBlocking(move);
+  return move.result();
+}
+
+std::expected<MoveStats, Error> Mouse::followPath(
+    const std::span<const LogicalPoint> path, const MouseMoveOptions& options
+) {
+  gesture::FollowPath follow(*backend_, path, options);
+  gesture::runBlocking(follow);
+  return follow.result();
 }
 
 std::expected<LogicalPoint, Error> Mouse::position() {
@@ -85,35 +65,31 @@ std::expected<void, Error> Mouse::doubleClick(const MouseButton button) {
 std::expected<void, Error> Mouse::drag(
     const LogicalPoint to, const MouseButton button
 ) {
-  if (auto r = backend_->button(button, ButtonAction::Down, 1); !r) return r;
-  std::this_thread::sleep_for(kDragSettle);
-
-  // While the button is held, the backend emits drag events for this warp.
-  if (auto r = backend_->warpCursor(to); !r) {
-    (void)backend_->button(button, ButtonAction::Up, 1);
-    return std::unexpected(r.error());
-  }
-  std::this_thread::sleep_for(kDragSettle);
-  return backend_->button(button, ButtonAction::Up, 1);
+  gesture::Drag drag(*backend_, screen_, to, button, std::nullopt);
+  gesture::runBlocking(drag);
+  return drag.result();
 }
 
 std::expected<void, Error> Mouse::dragSmooth(
     const LogicalPoint to, const MouseButton button,
     const MouseMoveOptions& options
 ) {
-  if (auto r = backend_->button(button, ButtonAction::Down, 1); !r) return r;
-  std::this_thread::sleep_for(kDragSettle);
-
-  auto moved = moveSmooth(to, options);
-  std::this_thread::sleep_for(kDragSettle);
-  auto released = backend_->button(button, ButtonAction::Up, 1);
-
-  if (!moved) return moved;
-  return released;
+  thread_local Trajectory trajectory;
+  gesture::Drag drag(*backend_, screen_, to, button, options, &trajectory);
+  gesture::runBlocking(drag);
+  return drag.result();
 }
 
 std::expected<void, Error> Mouse::scroll(const ScrollDelta delta) {
   return backend_->scroll(delta);
 }
 
+std::expected<MoveStats, Error> Mouse::scrollSmooth(
+    const ScrollDelta total, const ScrollSmoothOptions& options
+) {
+  gesture::ScrollSmooth scroll(*backend_, total, options);
+  gesture::runBlocking(scroll);
+  return scroll.result();
+}
+
 }  // namespace robot
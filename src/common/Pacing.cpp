@@ -0,0 +1,45 @@
+#include "Pacing.h"
+
+#include <algorithm>
+
+namespace robot::pacing {
+
+void waitUntil(
+    const Clock::time_point deadline, const PacingMode mode,
+    const std::chrono::microseconds spinWindow
+) {
+  if (mode == PacingMode::Hybrid && spinWindow.count() > 0) {
+    // Sleep the coarse part, then spin: the scheduler's wake-up error is
+    // absorbed by the spin window instead of landing on the deadline.
+    const auto sleepTarget = deadline - spinWindow;
+    if (Clock::now() < sleepTarget) sleepUntil(sleepTarget);
+    while (Clock::now() < deadline) {
+    }
+    return;
+  }
+  // The platform timer may return early (clock conversions, signals); loop so
+  // the deadline is never undershot.
+  while (Clock::now() < deadline) sleepUntil(deadline);
+}
+
+void LatenessAccumulator::add(const Clock::duration late) {
+  const Clock::duration clamped = std::max(late, Clock::duration::zero());
+  ++samples_;
+  total_ += clamped;
+  max_ = std::max(max_, clamped);
+}
+
+Lateness LatenessAccumulator::result() const {
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+  Lateness out;
+  out.samples = samples_;
+  if (samples_ == 0) return out;
+  out.mean = duration_cast<microseconds>(
+      total_ / static_cast<Clock::rep>(samples_)
+  );
+  out.max = duration_cast<microseconds>(max_);
+  return out;
+}
+
+}  // namespace robot::pacing
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <chrono>
+
+#include "robot/Pacing.h"
+
+// Common internal: deadline waiting and lateness bookkeeping shared by every
+// timed loop in the portable layer, so moves and replays pace identically.
+namespace robot::pacing {
+
+using Clock = std::chrono::steady_clock;
+
+// Sleep until about deadline on the platform's most precise absolute timer
+// (clock_nanosleep on Linux, a high-resolution waitable timer on Windows,
+// sleep_until elsewhere). Implemented once per platform; it may wake slightly
+// early or late, so callers needing "not before" loop (waitUntil does).
+void sleepUntil(Clock::time_point deadline);
+
+// Raises the calling thread's scheduling priority for its lifetime and
+// restores it on destruction: SCHED_FIFO on Linux (needs CAP_SYS_NICE or an
+// RLIMIT_RTPRIO allowance), the user-interactive QoS class on macOS,
+// THREAD_PRIORITY_TIME_CRITICAL on Windows. Best effort: raised() reports
+// whether the OS agreed. Constructed with enable == false it does nothing.
+class ScopedPriorityBoost {
+ public:
+  explicit ScopedPriorityBoost(bool enable);
+  ~ScopedPriorityBoost();
+  ScopedPriorityBoost(const ScopedPriorityBoost&) = delete;
+  ScopedPriorityBoost& operator=(const ScopedPriorityBoost&) = delete;
+
+  [[nodiscard]] bool raised() const { return raised_; }
+
+ private:
+  bool raised_ = false;
+  // Whatever the platform needs to restore: policy and priority, QoS class.
+  int savedPolicy_ = 0;
+  int savedPriority_ = 0;
+};
+
+// Block until deadline has passed. In Hybrid mode the final spinWindow is
+// busy-waited instead of slept. Returns immediately for a deadline in the past.
+void waitUntil(
+    Clock::time_point deadline, PacingMode mode,
+    std::chrono::microseconds spinWindow
+);
+
+// Running mean/max of how late each deadline was met.
+class LatenessAccumulator {
+ public:
+  void add(Clock::duration late);
+  [[nodiscard]] Lateness result() const;
+
+ private:
+  std::size_t samples_ = 0;
+  Clock::duration total_{0};
+  Clock::duration max_{0};
+};
+
+}  // namespace robot::pacing
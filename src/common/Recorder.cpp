@@ -1,95 +1,216 @@
 #include "robot/Recorder.h"
 
+#include <algorithm>
 #include <chrono>
-#include <cmath>
-#include <thread>
-#include <variant>
+#include <memory>
+#include <utility>
 
+#include "Replay.h"
+#include "robot/RecordingFile.h"
 #include "robot/Session.h"
 
 namespace robot {
 namespace {
 
-template <class... Ts>
-struct Overloaded : Ts... {
-  using Ts::operator()...;
+// The in-memory timeline as a replay source. The store is sorted by
+// timestamp, so seeking is a binary search.
+class StoreSource final : public replay::Source {
+ public:
+  explicit StoreSource(const EventStore& events)
+      : events_(events), it_(events.begin()) {}
+
+  void seek(const std::chrono::microseconds from) override {
+    it_ = std::lower_bound(
+        events_.begin(), events_.end(), from,
+        [](const RecordedEvent& e, const std::chrono::microseconds t) {
+          return e.timestamp < t;
+        }
+    );
+  }
+
+  bool next(RecordedEvent& out) override {
+    if (it_ == events_.end()) return false;
+    out = *it_++;
+    return true;
+  }
+
+  [[nodiscard]] std::chrono::microseconds duration() const override {
+    return events_.empty() ? std::chrono::microseconds(0)
+                           : events_.back().timestamp;
+  }
+
+ private:
+  const EventStore& events_;
+  EventStore::Iterator it_;
 };
 
 }  // namespace
 
-void Recorder::capture(const InputEvent& event) {
-  const auto now = std::chrono::steady_clock::now();
+Recorder::Recorder(const RecorderOptions& options) {
+  if (options.motionFilter) filter_.emplace(*options.motionFilter);
+  if (options.ringCapacity > 0) {
+    ring_ = std::make_unique<SpscRing<RecordedEvent>>(options.ringCapacity);
+  }
+}
+
+RecordedEvent Recorder::stamp(
+    const std::chrono::steady_clock::time_point time, const InputEvent& event
+) {
+  // The first capture is stamped where the timeline ends: at zero, or after
+  // the last event of a loaded recording.
   if (!started_) {
     started_ = true;
-    start_ = now;
+    start_ = time - last_;
   }
-  const auto timestamp =
-      std::chrono::duration_cast<std::chrono::milliseconds>(now - start_);
-  events_.push_back({.timestamp = timestamp, .event = event});
+  // Platform timestamps from different devices can interleave slightly out of
+  // order; clamp so the timeline stays sorted, which replay and seeking rely on.
+  last_ = std::max(
+      last_,
+      std::chrono::duration_cast<std::chrono::microseconds>(time - start_)
+  );
+  return {.timestamp = last_, .event = event};
 }
 
-void Recorder::reset() {
-  events_.clear();
-  started_ = false;
+void Recorder::capture(const InputEvent& event) {
+  capture(TimedEvent{std::chrono::steady_clock::now(), event});
 }
 
-std::expected<void, Error> Recorder::replay(
-    Session& session, const ReplayOptions& options
-) const {
-  if (events_.empty()) return {};
-
-  Keyboard& keyboard = session.keyboard();
-  Mouse& mouse = session.mouse();
-
-  // Dispatch a normalized event to the injection facades. Button and scroll
-  // events warp to their recorded position first so replay reproduces location.
-  const auto dispatch = [&](const InputEvent& e) -> std::expected<void, Error> {
-    return std::visit(
-        Overloaded{
-            [&](const KeyEvent& k) -> std::expected<void, Error> {
-              return k.down ? keyboard.press(k.key) : keyboard.release(k.key);
-            },
-            [&](const MouseMoveEvent& m) -> std::expected<void, Error> {
-              return mouse.move(m.position);
-            },
-            [&](const MouseButtonEvent& m) -> std::expected<void, Error> {
-              if (auto r = mouse.move(m.position); !r) return r;
-              return m.down ? mouse.press(m.button) : mouse.release(m.button);
-            },
-            [&](const ScrollEvent& s) -> std::expected<void, Error> {
-              if (auto r = mouse.move(s.position); !r) return r;
-              return mouse.scroll(s.delta);
-            },
-        },
-        e
-    );
-  };
+void Recorder::capture(const TimedEvent& event) {
+  const RecordedEvent recorded = stamp(event.time, event.event);
+  if (!ring_) {
+    store(recorded);
+    counters_->captured.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
 
-  // Timing is reconstructed from per-event gaps (not absolute timestamps) so
-  // timeScale and maxGap apply cleanly and a long idle gap cannot freeze replay.
-  const auto replayStart = std::chrono::steady_clock::now();
-  std::chrono::milliseconds virtualElapsed{0};
-  std::chrono::milliseconds previous = events_.front().timestamp;
+  // Only the producer writes the counters; they are atomic so stats() can read
+  // them from any thread.
+  if (!ring_->tryPush(recorded)) {
+    counters_->dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  counters_->captured.fetch_add(1, std::memory_order_relaxed);
+  const std::size_t queued = ring_->size();
+  if (queued > counters_->highWater.load(std::memory_order_relaxed)) {
+    counters_->highWater.store(queued, std::memory_order_relaxed);
+  }
+}
 
-  for (const RecordedEvent& rec : events_) {
-    std::chrono::milliseconds gap = rec.timestamp - previous;
-    previous = rec.timestamp;
+void Recorder::capture(const std::span<const TimedEvent> batch) {
+  if (!ring_) {
+    for (const TimedEvent& e : batch) store(stamp(e.time, e.event));
+    counters_->captured.fetch_add(batch.size(), std::memory_order_relaxed);
+    return;
+  }
 
-    auto scaled = std::chrono::milliseconds(
-        static_cast<long long>(std::llround(gap.count() * options.timeScale))
-    );
-    if (options.maxGap.count() > 0 && scaled > options.maxGap) {
-      scaled = options.maxGap;
-    }
-    virtualElapsed += scaled;
+  std::size_t pushed = 0;
+  for (const TimedEvent& e : batch) {
+    if (ring_->tryPush(stamp(e.time, e.event))) ++pushed;
+  }
+  counters_->captured.fetch_add(pushed, std::memory_order_relaxed);
+  counters_->dropped.fetch_add(
+      batch.size() - pushed, std::memory_order_relaxed
+  );
+  const std::size_t queued = ring_->size();
+  if (queued > counters_->highWater.load(std::memory_order_relaxed)) {
+    counters_->highWater.store(queued, std::memory_order_relaxed);
+  }
+}
+
+std::size_t Recorder::drain() {
+  if (!ring_) return 0;
+  return ring_->drain([this](RecordedEvent&& e) { store(e); });
+}
+
+void Recorder::store(const RecordedEvent& event) {
+  if (!filter_) {
+    events_.push_back(event);
+    return;
+  }
+  filter_->add(event, [this](const RecordedEvent& e) { events_.push_back(e); });
+  counters_->filtered.store(filter_->dropped(), std::memory_order_relaxed);
+}
+
+void Recorder::flush() {
+  if (!filter_) return;
+  filter_->flush([this](const RecordedEvent& e) { events_.push_back(e); });
+  counters_->filtered.store(filter_->dropped(), std::memory_order_relaxed);
+}
+
+RecorderStats Recorder::stats() const {
+  return {
+      .captured = counters_->captured.load(std::memory_order_relaxed),
+      .dropped = counters_->dropped.load(std::memory_order_relaxed),
+      .highWater = counters_->highWater.load(std::memory_order_relaxed),
+      .filtered = counters_->filtered.load(std::memory_order_relaxed),
+  };
+}
+
+void Recorder::reset() {
+  restartCapture();
+  events_.clear();
+}
+
+void Recorder::restartCapture() {
+  if (ring_) ring_->drain([](RecordedEvent&&) {});
+  if (filter_) filter_->reset();
+  counters_->filtered.store(0, std::memory_order_relaxed);
+  counters_->captured.store(0, std::memory_order_relaxed);
+  counters_->dropped.store(0, std::memory_order_relaxed);
+  counters_->highWater.store(0, std::memory_order_relaxed);
+  started_ = false;
+  last_ = std::chrono::microseconds(0);
+}
 
-    std::this_thread::sleep_until(replayStart + virtualElapsed);
+std::expected<void, Error> Recorder::save(const std::string_view path) const {
+  auto writer = RecordingWriter::create(path);
+  if (!writer) return std::unexpected(writer.error());
+  for (const RecordedEvent& rec : events_) {
+    if (auto r = writer->write(rec); !r) return r;
+  }
+  return writer->close();
+}
 
-    if (auto r = dispatch(rec.event); !r) {
-      return std::unexpected(r.error());
-    }
+std::expected<void, Error> Recorder::load(const std::string_view path) {
+  auto reader = RecordingReader::open(path);
+  if (!reader) return std::unexpected(reader.error());
+
+  // Decode into a scratch store so a corrupt file leaves this one untouched.
+  EventStore loaded;
+  while (true) {
+    auto next = reader->next();
+    if (!next) return std::unexpected(next.error());
+    if (!*next) break;
+    loaded.push_back(**next);
   }
+  restartCapture();
+  events_ = std::move(loaded);
+  if (!events_.empty()) last_ = events_.back().timestamp;
   return {};
 }
 
-}  // namespace robot
\ No newline at end of file
+std::expected<ReplayStats, Error> Recorder::replay(
+    Session& session, const ReplayOptions& options
+) const {
+  StoreSource source(events_);
+  return replay::run(session, source, options, nullptr);
+}
+
+std::expected<std::vector<ReplayStats>, Error> Recorder::replay(
+    const std::span<const ReplayTarget> targets, const ReplayOptions& options
+) const {
+  return replay::run(
+      targets, [this] { return std::make_unique<StoreSource>(events_); },
+      options
+  );
+}
+
+ReplayHandle Recorder::replayAsync(
+    Session& session, const ReplayOptions& options
+) const {
+  return ReplayHandle(
+      replay::launch(session, std::make_unique<StoreSource>(events_), options)
+  );
+}
+
+}  // namespace robot
@@ -0,0 +1,266 @@
+#include "RecordingCodec.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <variant>
+
+namespace robot::recording {
+namespace {
+
+enum Tag : std::uint8_t {
+  kKey = 0,
+  kMove = 1,
+  kButton = 2,
+  kScroll = 3,
+  kTypeMask = 0x07,
+  kDown = 0x08,
+  kPixel = 0x10,
+};
+
+constexpr double kPositionScale = 1 << kPositionShift;
+constexpr double kScrollScale = 120.0;
+
+template <class... Ts>
+struct Overloaded : Ts... {
+  using Ts::operator()...;
+};
+
+std::uint64_t zigzag(const std::int64_t v) {
+  return (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63);
+}
+
+std::int64_t unzigzag(const std::uint64_t v) {
+  return static_cast<std::int64_t>(v >> 1) ^ -static_cast<std::int64_t>(v & 1);
+}
+
+// Appends through a cursor; callers guarantee kMaxEventSize bytes of room.
+class Sink {
+ public:
+  explicit Sink(const std::span<std::uint8_t> out) : out_(out) {}
+
+  void byte(const std::uint8_t b) { out_[size_++] = b; }
+  void varint(std::uint64_t v) {
+    while (v >= 0x80) {
+      byte(static_cast<std::uint8_t>(v | 0x80));
+      v >>= 7;
+    }
+    byte(static_cast<std::uint8_t>(v));
+  }
+  void signedVarint(const std::int64_t v) { varint(zigzag(v)); }
+
+  [[nodiscard]] std::size_t size() const { return size_; }
+
+ private:
+  std::span<std::uint8_t> out_;
+  std::size_t size_ = 0;
+};
+
+class Source {
+ public:
+  explicit Source(const std::span<const std::uint8_t> in) : in_(in) {}
+
+  bool byte(std::uint8_t& b) {
+    if (pos_ >= in_.size()) return false;
+    b = in_[pos_++];
+    return true;
+  }
+  bool varint(std::uint64_t& v) {
+    v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      std::uint8_t b = 0;
+      if (!byte(b)) return false;
+      v |= static_cast<std::uint64_t>(b & 0x7F) << shift;
+      if ((b & 0x80) == 0) return true;
+    }
+    return false;  // Longer than any 64-bit value: corrupt.
+  }
+  bool signedVarint(std::int64_t& v) {
+    std::uint64_t raw = 0;
+    if (!varint(raw)) return false;
+    v = unzigzag(raw);
+    return true;
+  }
+
+  [[nodiscard]] std::size_t consumed() const { return pos_; }
+
+ private:
+  std::span<const std::uint8_t> in_;
+  std::size_t pos_ = 0;
+};
+
+// acc += delta, or false if the sum does not fit: decoded deltas come from
+// the file and may be anything.
+bool addChecked(std::int64_t& acc, const std::int64_t delta) {
+  constexpr auto kMax = std::numeric_limits<std::int64_t>::max();
+  constexpr auto kMin = std::numeric_limits<std::int64_t>::min();
+  if (delta > 0 ? acc > kMax - delta : acc < kMin - delta) return false;
+  acc += delta;
+  return true;
+}
+
+std::int64_t quantize(const double v, const double scale) {
+  return std::llround(v * scale);
+}
+
+}  // namespace
+
+void writeHeader(const std::span<std::uint8_t, kHeaderSize> out) {
+  std::memcpy(out.data(), kMagic, sizeof(kMagic));
+  out[4] = kVersion;
+  out[5] = static_cast<std::uint8_t>(kPositionShift);
+  out[6] = 0;
+  out[7] = 0;
+}
+
+std::expected<void, Error> checkHeader(const std::span<const std::uint8_t> in) {
+  if (in.size() < kHeaderSize ||
+      std::memcmp(in.data(), kMagic, sizeof(kMagic)) != 0) {
+    return std::unexpected(
+        Error::invalidArgument("not a robot-cpp recording (bad magic)")
+    );
+  }
+  if (in[4] != kVersion || in[5] != kPositionShift) {
+    return std::unexpected(Error::invalidArgument(
+        "unsupported recording format version"
+    ));
+  }
+  return {};
+}
+
+std::size_t Encoder::encode(
+    const RecordedEvent& event, const std::span<std::uint8_t> out
+) {
+  Sink sink(out);
+  const std::int64_t timeUs =
+      std::chrono::duration_cast<std::chrono::microseconds>(event.timestamp)
+          .count();
+
+  // Tag and time first, then the type-specific payload.
+  const auto header = [&](const std::uint8_t tag) {
+    sink.byte(tag);
+    sink.signedVarint(timeUs - state_.timeUs);
+    state_.timeUs = timeUs;
+  };
+  const auto position = [&](const LogicalPoint p) {
+    const std::int64_t x = quantize(p.x, kPositionScale);
+    const std::int64_t y = quantize(p.y, kPositionScale);
+    sink.signedVarint(x - state_.x);
+    sink.signedVarint(y - state_.y);
+    state_.x = x;
+    state_.y = y;
+  };
+
+  std::visit(
+      Overloaded{
+          [&](const KeyEvent& k) {
+            header(static_cast<std::uint8_t>(kKey | (k.down ? kDown : 0)));
+            sink.varint(keyToHidUsage(k.key));
+          },
+          [&](const MouseMoveEvent& m) {
+            header(kMove);
+            position(m.position);
+          },
+          [&](const MouseButtonEvent& b) {
+            header(static_cast<std::uint8_t>(kButton | (b.down ? kDown : 0)));
+            sink.byte(static_cast<std::uint8_t>(b.button));
+            position(b.position);
+          },
+          [&](const ScrollEvent& s) {
+            const bool pixel = s.delta.unit == ScrollUnit::Pixel;
+            header(static_cast<std::uint8_t>(kScroll | (pixel ? kPixel : 0)));
+            position(s.position);
+            sink.signedVarint(quantize(s.delta.horizontal, kScrollScale));
+            sink.signedVarint(quantize(s.delta.vertical, kScrollScale));
+          },
+      },
+      event.event
+  );
+  return sink.size();
+}
+
+std::expected<std::size_t, Error> Decoder::decode(
+    const std::span<const std::uint8_t> in, RecordedEvent& out
+) {
+  const auto corrupt = [] {
+    return std::unexpected(Error::ioError("truncated or corrupt recording"));
+  };
+
+  Source source(in);
+  std::uint8_t tag = 0;
+  std::int64_t dt = 0;
+  if (!source.byte(tag) || !source.signedVarint(dt)) return corrupt();
+  // Time never runs backwards within a recording.
+  CodecState next = state_;
+  if (dt < 0 || !addChecked(next.timeUs, dt)) return corrupt();
+
+  const auto position = [&](LogicalPoint& p) {
+    std::int64_t dx = 0;
+    std::int64_t dy = 0;
+    if (!source.signedVarint(dx) || !source.signedVarint(dy) ||
+        !addChecked(next.x, dx) || !addChecked(next.y, dy)) {
+      return false;
+    }
+    p = {static_cast<double>(next.x) / kPositionScale,
+         static_cast<double>(next.y) / kPositionScale};
+    return true;
+  };
+
+  const bool down = (tag & kDown) != 0;
+  switch (tag & kTypeMask) {
+    case kKey: {
+      std::uint64_t usage = 0;
+      if (!source.varint(usage) || usage > 0xFFFF) return corrupt();
+      const auto key = keyFromHidUsage(static_cast<std::uint16_t>(usage));
+      if (!key) return corrupt();
+      out.event = KeyEvent{*key, down};
+      break;
+    }
+    case kMove: {
+      MouseMoveEvent m;
+      if (!position(m.position)) return corrupt();
+      out.event = m;
+      break;
+    }
+    case kButton: {
+      std::uint8_t button = 0;
+      MouseButtonEvent b;
+      if (!source.byte(button) ||
+          button > static_cast<std::uint8_t>(MouseButton::X2) ||
+          !position(b.position)) {
+        return corrupt();
+      }
+      b.button = static_cast<MouseButton>(button);
+      b.down = down;
+      out.event = b;
+      break;
+    }
+    case kScroll: {
+      ScrollEvent s;
+      std::int64_t h = 0;
+      std::int64_t v = 0;
+      if (!position(s.position) || !source.signedVarint(h) ||
+          !source.signedVarint(v)) {
+        return corrupt();
+      }
+      s.delta = {
+          .horizontal = static_cast<double>(h) / kScrollScale,
+          .vertical = static_cast<double>(v) / kScrollScale,
+          .unit = (tag & kPixel) != 0 ? ScrollUnit::Pixel : ScrollUnit::Line,
+      };
+      out.event = s;
+      break;
+    }
+    default:
+      return corrupt();
+  }
+
+  out.timestamp = std::chrono::duration_cast<decltype(out.timestamp)>(
+      std::chrono::microseconds(next.timeUs)
+  );
+  state_ = next;
+  return source.consumed();
+}
+
+}  // namespace robot::recording
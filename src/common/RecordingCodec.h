@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <span>
+
+#include "robot/Error.h"
+#include "robot/Event.h"
+
+// Common internal: the event encoding shared by the recording file reader,
+// writer and mapped replay. Streams and mappings only move bytes; everything
+// about the format itself lives here.
+//
+// File layout: an 8-byte header (magic "RBRC", format version, position
+// quantization shift, two reserved zero bytes) followed by events back to back.
+// Each event is:
+//
+//   tag      1 byte: event type in bits 0-2, "down" in bit 3 (key and button),
+//            "pixel units" in bit 4 (scroll)
+//   time     zigzag varint, microseconds since the previous event; never
+//            negative
+//   payload  key: varint HID usage
+//            move: zigzag varint dx, dy
+//            button: 1 byte MouseButton, then zigzag varint dx, dy
+//            scroll: zigzag varint dx, dy, then zigzag varint horizontal and
+//                    vertical in 1/120 units
+//
+// Positions are quantized to 1/(1 << kPositionShift) logical units and coded
+// as deltas from the previous event's position, so the steady stream of small
+// pointer moves that dominates a recording costs a few bytes per event.
+namespace robot::recording {
+
+inline constexpr std::uint8_t kMagic[4] = {'R', 'B', 'R', 'C'};
+inline constexpr std::uint8_t kVersion = 1;
+inline constexpr int kPositionShift = 3;
+inline constexpr std::size_t kHeaderSize = 8;
+// Upper bound of one encoded event: tag, five 10-byte varints and a button.
+inline constexpr std::size_t kMaxEventSize = 1 + 5 * 10 + 1;
+
+void writeHeader(std::span<std::uint8_t, kHeaderSize> out);
+[[nodiscard]] std::expected<void, Error> checkHeader(
+    std::span<const std::uint8_t> in
+);
+
+// The running state both sides need: time and position of the last event.
+// Decoding from the middle of a stream means restoring one of these.
+struct CodecState {
+  std::int64_t timeUs = 0;
+  std::int64_t x = 0;  // Quantized.
+  std::int64_t y = 0;
+};
+
+class Encoder {
+ public:
+  // Encode one event into out (at least kMaxEventSize bytes) and return the
+  // number of bytes written.
+  std::size_t encode(const RecordedEvent& event, std::span<std::uint8_t> out);
+
+  [[nodiscard]] const CodecState& state() const { return state_; }
+
+ private:
+  CodecState state_;
+};
+
+class Decoder {
+ public:
+  Decoder() = default;
+  explicit Decoder(const CodecState& state) : state_(state) {}
+
+  // Decode one event from the front of in, returning the bytes consumed.
+  // Fails with IoError on truncated or malformed input, including time that
+  // runs backwards and deltas that overflow the running state.
+  [[nodiscard]] std::expected<std::size_t, Error> decode(
+      std::span<const std::uint8_t> in, RecordedEvent& out
+  );
+
+  [[nodiscard]] const CodecState& state() const { return state_; }
+
+ private:
+  CodecState state_;
+};
+
+}  // namespace robot::recording
@@ -0,0 +1,175 @@
+#include "robot/RecordingFile.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <utility>
+
+#include "RecordingCodec.h"
+
+namespace robot {
+namespace {
+
+constexpr std::size_t kChunkSize = 64 * 1024;
+
+struct FileCloser {
+  void operator()(std::FILE* f) const { std::fclose(f); }
+};
+using FilePtr = std::unique_ptr<std::FILE, FileCloser>;
+
+}  // namespace
+
+// ── Writer ───────────────────────────────────────────────────────────────────
+
+struct RecordingWriter::Impl {
+  FilePtr file;
+  recording::Encoder encoder;
+  std::array<std::uint8_t, kChunkSize> buffer{};
+  std::size_t used = 0;
+
+  std::expected<void, Error> flush() {
+    if (used > 0 && std::fwrite(buffer.data(), 1, used, file.get()) != used) {
+      return std::unexpected(Error::ioError("failed to write recording"));
+    }
+    used = 0;
+    return {};
+  }
+};
+
+RecordingWriter::RecordingWriter(std::unique_ptr<Impl> impl)
+    : impl_(std::move(impl)) {}
+RecordingWriter::RecordingWriter(RecordingWriter&&) noexcept = default;
+RecordingWriter& RecordingWriter::operator=(RecordingWriter&&) noexcept =
+    default;
+
+RecordingWriter::~RecordingWriter() {
+  if (impl_ && impl_->file) (void)impl_->flush();
+}
+
+std::expected<RecordingWriter, Error> RecordingWriter::create(
+    const std::string_view path
+) {
+  auto impl = std::make_unique<Impl>();
+  impl->file.reset(std::fopen(std::string{path}.c_str(), "wb"));
+  if (!impl->file) {
+    return std::unexpected(Error::ioError("cannot create " + std::string{path}));
+  }
+  recording::writeHeader(
+      std::span<std::uint8_t, recording::kHeaderSize>(
+          impl->buffer.data(), recording::kHeaderSize
+      )
+  );
+  impl->used = recording::kHeaderSize;
+  return RecordingWriter(std::move(impl));
+}
+
+std::expected<void, Error> RecordingWriter::write(const RecordedEvent& event) {
+  if (!impl_ || !impl_->file) {
+    return std::unexpected(Error::invalidArgument("recording writer is closed"));
+  }
+  // Readers seek and pace by timestamp, so the file must stay sorted.
+  if (std::chrono::duration_cast<std::chrono::microseconds>(event.timestamp)
+          .count() < impl_->encoder.state().timeUs) {
+    return std::unexpected(Error::invalidArgument(
+        "recording events must be written in timestamp order"
+    ));
+  }
+  if (impl_->buffer.size() - impl_->used < recording::kMaxEventSize) {
+    if (auto r = impl_->flush(); !r) return r;
+  }
+  impl_->used += impl_->encoder.encode(
+      event, std::span(impl_->buffer).subspan(impl_->used)
+  );
+  return {};
+}
+
+std::expected<void, Error> RecordingWriter::close() {
+  if (!impl_ || !impl_->file) return {};
+  auto flushed = impl_->flush();
+  // fclose reports errors from its own final flush of the stdio buffer.
+  const bool closed = std::fclose(impl_->file.release()) == 0;
+  if (!flushed) return flushed;
+  if (!closed) {
+    return std::unexpected(Error::ioError("failed to close recording"));
+  }
+  return {};
+}
+
+// ── Reader ───────────────────────────────────────────────────────────────────
+
+struct RecordingReader::Impl {
+  FilePtr file;
+  recording::Decoder decoder;
+  std::array<std::uint8_t, kChunkSize> buffer{};
+  std::size_t begin = 0;
+  std::size_t end = 0;
+  bool eof = false;
+
+  // Slide the unread tail to the front and top the buffer up from the file.
+  std::expected<void, Error> refill() {
+    std::memmove(buffer.data(), buffer.data() + begin, end - begin);
+    end -= begin;
+    begin = 0;
+    const std::size_t n =
+        std::fread(buffer.data() + end, 1, buffer.size() - end, file.get());
+    end += n;
+    if (n == 0) {
+      if (std::ferror(file.get())) {
+        return std::unexpected(Error::ioError("failed to read recording"));
+      }
+      eof = true;
+    }
+    return {};
+  }
+};
+
+RecordingReader::RecordingReader(std::unique_ptr<Impl> impl)
+    : impl_(std::move(impl)) {}
+RecordingReader::RecordingReader(RecordingReader&&) noexcept = default;
+RecordingReader& RecordingReader::operator=(RecordingReader&&) noexcept =
+    default;
+RecordingReader::~RecordingReader() = default;
+
+std::expected<RecordingReader, Error> RecordingReader::open(
+    const std::string_view path
+) {
+  auto impl = std::make_unique<Impl>();
+  impl->file.reset(std::fopen(std::string{path}.c_str(), "rb"));
+  if (!impl->file) {
+    return std::unexpected(Error::ioError("cannot open " + std::string{path}));
+  }
+  while (impl->end < recording::kHeaderSize && !impl->eof) {
+    if (auto r = impl->refill(); !r) return std::unexpected(r.error());
+  }
+  if (auto r = recording::checkHeader(
+          std::span(impl->buffer).first(impl->end)
+      );
+      !r) {
+    return std::unexpected(r.error());
+  }
+  impl->begin = recording::kHeaderSize;
+  return RecordingReader(std::move(impl));
+}
+
+std::expected<std::optional<RecordedEvent>, Error> RecordingReader::next() {
+  Impl& s = *impl_;
+  // An event never spans more than kMaxEventSize bytes, so topping up whenever
+  // less than that is buffered means decode() only fails on a real truncation.
+  if (s.end - s.begin < recording::kMaxEventSize && !s.eof) {
+    if (auto r = s.refill(); !r) return std::unexpected(r.error());
+  }
+  if (s.begin == s.end) return std::nullopt;
+
+  RecordedEvent event;
+  const auto consumed = s.decoder.decode(
+      std::span(s.buffer).subspan(s.begin, s.end - s.begin), event
+  );
+  if (!consumed) return std::unexpected(consumed.error());
+  s.begin += *consumed;
+  return event;
+}
+
+}  // namespace robot
@@ -0,0 +1,460 @@
+#include "Replay.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <queue>
+#include <random>
+#include <utility>
+#include <variant>
+
+#include "robot/Session.h"
+
+namespace robot::replay {
+namespace {
+
+template <class... Ts>
+struct Overloaded : Ts... {
+  using Ts::operator()...;
+};
+
+// A scheduler waiting on the control block hands over to the precise wait
+// this long before the deadline; requests arriving later wait for the event.
+constexpr auto kInterruptMargin = std::chrono::milliseconds(2);
+
+// Keys and buttons the replay has pressed and not yet released.
+class HeldInputs {
+ public:
+  void track(const InputEvent& event) {
+    if (const auto* k = std::get_if<KeyEvent>(&event)) {
+      keys_.set(keyToHidUsage(k->key) & 0xFF, k->down);
+    } else if (const auto* b = std::get_if<MouseButtonEvent>(&event)) {
+      buttons_.set(static_cast<std::size_t>(b->button), b->down);
+    }
+  }
+
+  // Best effort: a release that fails leaves nothing better to try.
+  void releaseAll(Keyboard& keyboard, Mouse& mouse) {
+    for (std::size_t usage = 0; usage < keys_.size(); ++usage) {
+      if (!keys_[usage]) continue;
+      if (const auto key = keyFromHidUsage(static_cast<std::uint16_t>(usage))) {
+        (void)keyboard.release(*key);
+      }
+    }
+    for (std::size_t button = 0; button < buttons_.size(); ++button) {
+      if (buttons_[button]) {
+        (void)mouse.release(static_cast<MouseButton>(button));
+      }
+    }
+    keys_.reset();
+    buttons_.reset();
+  }
+
+ private:
+  std::bitset<256> keys_;
+  std::bitset<5> buttons_;
+};
+
+// gap after timeScale and maxGap.
+std::chrono::microseconds scaledGap(
+    const ReplayOptions& options, const std::chrono::microseconds gap
+) {
+  auto scaled = std::chrono::microseconds(static_cast<long long>(
+      std::llround(static_cast<double>(gap.count()) * options.timeScale)
+  ));
+  if (options.maxGap.count() > 0 && scaled > options.maxGap) {
+    scaled = options.maxGap;
+  }
+  return scaled;
+}
+
+// One target of a multi-session replay: its own cursor into the recording,
+// schedule and held inputs.
+struct Lane {
+  Keyboard* keyboard = nullptr;
+  Mouse* mouse = nullptr;
+  std::unique_ptr<Source> source;
+  HeldInputs held;
+  std::minstd_rand rng;
+  std::chrono::microseconds jitter{0};
+  pacing::Clock::time_point start;
+  pacing::Clock::duration elapsed{0};
+  pacing::Clock::time_point deadline;
+  std::optional<std::chrono::microseconds> previous;
+  RecordedEvent pending;
+  std::size_t pass = 0;
+  pacing::LatenessAccumulator lateness;
+  std::size_t events = 0;
+  std::size_t immediate = 0;
+
+  // Load the lane's next event and its deadline; false once every pass is
+  // done. Jitter is clamped so the lane's events stay in recorded order.
+  bool advance(const ReplayOptions& options) {
+    while (!source->next(pending) || pastWindow(options, pending.timestamp)) {
+      if (++pass == options.loops) return false;
+      source->seek(options.from);
+      previous.reset();
+    }
+    const std::chrono::microseconds gap =
+        previous ? pending.timestamp - *previous : std::chrono::microseconds(0);
+    previous = pending.timestamp;
+    elapsed += scaledGap(options, gap);
+
+    auto due = start + elapsed;
+    if (jitter.count() > 0) {
+      std::uniform_int_distribution<long long> spread(
+          -jitter.count(), jitter.count()
+      );
+      due += std::chrono::microseconds(spread(rng));
+    }
+    deadline = std::max(deadline, due);
+    return true;
+  }
+};
+
+}  // namespace
+
+std::expected<void, Error> dispatch(
+    Keyboard& keyboard, Mouse& mouse, const InputEvent& event
+) {
+  return std::visit(
+      Overloaded{
+          [&](const KeyEvent& k) -> std::expected<void, Error> {
+            return k.down ? keyboard.press(k.key) : keyboard.release(k.key);
+          },
+          [&](const MouseMoveEvent& m) -> std::expected<void, Error> {
+            return mouse.move(m.position);
+          },
+          [&](const MouseButtonEvent& m) -> std::expected<void, Error> {
+            if (auto r = mouse.move(m.position); !r) return r;
+            return m.down ? mouse.press(m.button) : mouse.release(m.button);
+          },
+          [&](const ScrollEvent& s) -> std::expected<void, Error> {
+            if (auto r = mouse.move(s.position); !r) return r;
+            return mouse.scroll(s.delta);
+          },
+      },
+      event
+  );
+}
+
+// ── Pacer ────────────────────────────────────────────────────────────────────
+
+Pacer::Pacer(const ReplayOptions& options)
+    : options_(options),
+      boost_(options.raisePriority),
+      start_(pacing::Clock::now()) {}
+
+void Pacer::schedule(const std::chrono::microseconds timestamp) {
+  const std::chrono::microseconds gap =
+      previous_ ? timestamp - *previous_ : std::chrono::microseconds(0);
+  previous_ = timestamp;
+  elapsed_ += scaledGap(options_, gap);
+}
+
+void Pacer::wait() {
+  const auto due = deadline();
+  ++events_;
+  if (pacing::Clock::now() >= due) {
+    ++immediate_;
+  } else {
+    pacing::waitUntil(due, options_.pacing, options_.spinWindow);
+  }
+  lateness_.add(pacing::Clock::now() - due);
+}
+
+ReplayStats Pacer::stats() const {
+  return {
+      .events = events_,
+      .immediate = immediate_,
+      .lateness = lateness_.result(),
+      .priorityRaised = boost_.raised(),
+  };
+}
+
+// ── Control ──────────────────────────────────────────────────────────────────
+
+void Control::pause() {
+  {
+    const std::lock_guard lock(mutex_);
+    paused_ = true;
+  }
+  auto expected = ReplayState::Running;
+  state_.compare_exchange_strong(expected, ReplayState::Paused);
+  cv_.notify_all();
+}
+
+void Control::resume() {
+  {
+    const std::lock_guard lock(mutex_);
+    paused_ = false;
+  }
+  auto expected = ReplayState::Paused;
+  state_.compare_exchange_strong(expected, ReplayState::Running);
+  cv_.notify_all();
+}
+
+void Control::cancel() {
+  {
+    const std::lock_guard lock(mutex_);
+    cancel_ = true;
+  }
+  cv_.notify_all();
+}
+
+void Control::seek(const std::chrono::microseconds timestamp) {
+  {
+    const std::lock_guard lock(mutex_);
+    seek_ = timestamp;
+  }
+  cv_.notify_all();
+}
+
+Control::Command Control::take(
+    std::chrono::microseconds& seekTarget, pacing::Clock::duration& pausedFor
+) {
+  std::unique_lock lock(mutex_);
+  if (paused_ && !cancel_) {
+    const auto pausedAt = pacing::Clock::now();
+    cv_.wait(lock, [this] { return !paused_ || cancel_ || seek_; });
+    pausedFor += pacing::Clock::now() - pausedAt;
+  }
+  if (cancel_) return Command::Cancel;
+  if (seek_) {
+    seekTarget = *std::exchange(seek_, std::nullopt);
+    return Command::Seek;
+  }
+  return Command::None;
+}
+
+bool Control::sleepUntil(const pacing::Clock::time_point deadline) {
+  std::unique_lock lock(mutex_);
+  return !cv_.wait_until(lock, deadline, [this] { return pendingLocked(); });
+}
+
+void Control::published(
+    const std::chrono::microseconds position, const std::size_t pass
+) {
+  positionUs_.store(position.count(), std::memory_order_relaxed);
+  pass_.store(pass, std::memory_order_relaxed);
+  issued_.fetch_add(1, std::memory_order_relaxed);
+}
+
+ReplayProgress Control::progress() const {
+  return {
+      .state = state_.load(),
+      .issued = issued_.load(std::memory_order_relaxed),
+      .pass = pass_.load(std::memory_order_relaxed),
+      .position = std::chrono::microseconds(
+          positionUs_.load(std::memory_order_relaxed)
+      ),
+      .duration = duration_,
+  };
+}
+
+// ── Engine ───────────────────────────────────────────────────────────────────
+
+std::expected<void, Error> validate(const ReplayOptions& options) {
+  if (options.loops == 0) {
+    return std::unexpected(
+        Error::invalidArgument("ReplayOptions::loops must be at least 1")
+    );
+  }
+  if (options.to.count() > 0 && options.to < options.from) {
+    return std::unexpected(
+        Error::invalidArgument("ReplayOptions window ends before it starts")
+    );
+  }
+  return {};
+}
+
+std::expected<ReplayStats, Error> run(
+    Session& session, Source& source, const ReplayOptions& options,
+    Control* control
+) {
+  if (auto r = validate(options); !r) return std::unexpected(r.error());
+
+  Keyboard& keyboard = session.keyboard();
+  Mouse& mouse = session.mouse();
+  HeldInputs held;
+  Pacer pacer(options);
+  std::optional<RecordedEvent> pending;
+  std::size_t pass = 0;
+  source.seek(options.from);
+
+  while (true) {
+    if (control != nullptr) {
+      std::chrono::microseconds target{0};
+      pacing::Clock::duration paused{0};
+      const auto command = control->take(target, paused);
+      pacer.shift(paused);
+      if (command == Control::Command::Cancel) {
+        held.releaseAll(keyboard, mouse);
+        ReplayStats stats = pacer.stats();
+        stats.cancelled = true;
+        return stats;
+      }
+      if (command == Control::Command::Seek) {
+        held.releaseAll(keyboard, mouse);
+        pending.reset();
+        source.seek(std::max(target, options.from));
+        pacer.rebase();
+        continue;
+      }
+    }
+
+    if (!pending) {
+      RecordedEvent next;
+      if (!source.next(next) || pastWindow(options, next.timestamp)) {
+        if (++pass == options.loops) break;
+        source.seek(options.from);
+        pacer.restart();
+        continue;
+      }
+      pacer.schedule(next.timestamp);
+      pending = next;
+    }
+
+    // Wait interruptibly for the coarse part; a request goes back to the top
+    // with the event still pending.
+    if (control != nullptr &&
+        !control->sleepUntil(pacer.deadline() - kInterruptMargin)) {
+      continue;
+    }
+    pacer.wait();
+    if (auto r = dispatch(keyboard, mouse, pending->event); !r) {
+      held.releaseAll(keyboard, mouse);
+      return std::unexpected(r.error());
+    }
+    held.track(pending->event);
+    if (control != nullptr) control->published(pending->timestamp, pass);
+    pending.reset();
+  }
+  return pacer.stats();
+}
+
+std::expected<std::vector<ReplayStats>, Error> run(
+    const std::span<const ReplayTarget> targets,
+    const std::function<std::unique_ptr<Source>()>& open,
+    const ReplayOptions& options
+) {
+  if (auto r = validate(options); !r) return std::unexpected(r.error());
+  for (const ReplayTarget& target : targets) {
+    if (target.session == nullptr || target.offset.count() < 0 ||
+        target.jitter.count() < 0) {
+      return std::unexpected(Error::invalidArgument(
+          "ReplayTarget needs a session and a non-negative offset and jitter"
+      ));
+    }
+  }
+
+  const pacing::ScopedPriorityBoost boost(options.raisePriority);
+  const auto start = pacing::Clock::now();
+  std::vector<Lane> lanes(targets.size());
+  using Due = std::pair<pacing::Clock::time_point, std::size_t>;
+  std::priority_queue<Due, std::vector<Due>, std::greater<>> queue;
+  for (std::size_t i = 0; i < targets.size(); ++i) {
+    Lane& lane = lanes[i];
+    lane.keyboard = &targets[i].session->keyboard();
+    lane.mouse = &targets[i].session->mouse();
+    lane.source = open();
+    lane.source->seek(options.from);
+    lane.rng.seed(static_cast<std::minstd_rand::result_type>(i + 1));
+    lane.jitter = targets[i].jitter;
+    lane.start = start + targets[i].offset;
+    lane.deadline = lane.start;
+    if (lane.advance(options)) queue.emplace(lane.deadline, i);
+  }
+
+  while (!queue.empty()) {
+    const auto [due, i] = queue.top();
+    queue.pop();
+    Lane& lane = lanes[i];
+    ++lane.events;
+    if (pacing::Clock::now() >= due) {
+      ++lane.immediate;
+    } else {
+      pacing::waitUntil(due, options.pacing, options.spinWindow);
+    }
+    lane.lateness.add(pacing::Clock::now() - due);
+
+    if (auto r = dispatch(*lane.keyboard, *lane.mouse, lane.pending.event);
+        !r) {
+      for (Lane& l : lanes) l.held.releaseAll(*l.keyboard, *l.mouse);
+      return std::unexpected(r.error());
+    }
+    lane.held.track(lane.pending.event);
+    if (lane.advance(options)) queue.emplace(lane.deadline, i);
+  }
+
+  std::vector<ReplayStats> stats;
+  stats.reserve(lanes.size());
+  for (const Lane& lane : lanes) {
+    stats.push_back({
+        .events = lane.events,
+        .immediate = lane.immediate,
+        .lateness = lane.lateness.result(),
+        .priorityRaised = boost.raised(),
+    });
+  }
+  return stats;
+}
+
+std::unique_ptr<ReplayHandle::State> launch(
+    Session& session, std::unique_ptr<Source> source,
+    const ReplayOptions& options
+) {
+  auto state = std::make_unique<ReplayHandle::State>();
+  state->source = std::move(source);
+  state->options = options;
+  state->control.setDuration(state->source->duration());
+
+  std::promise<std::expected<ReplayStats, Error>> promise;
+  state->result = promise.get_future().share();
+  if (auto r = validate(options); !r) {
+    state->control.finish(ReplayState::Failed);
+    promise.set_value(std::unexpected(r.error()));
+    return state;
+  }
+  ReplayHandle::State* s = state.get();
+  state->thread = std::thread(
+      [s, &session, promise = std::move(promise)]() mutable {
+        auto result = run(session, *s->source, s->options, &s->control);
+        s->control.finish(
+            !result             ? ReplayState::Failed
+            : result->cancelled ? ReplayState::Cancelled
+                                : ReplayState::Finished
+        );
+        promise.set_value(std::move(result));
+      }
+  );
+  return state;
+}
+
+}  // namespace robot::replay
+
+namespace robot {
+
+ReplayHandle::ReplayHandle(std::unique_ptr<State> state)
+    : state_(std::move(state)) {}
+ReplayHandle::ReplayHandle(ReplayHandle&&) noexcept = default;
+ReplayHandle& ReplayHandle::operator=(ReplayHandle&&) noexcept = default;
+ReplayHandle::~ReplayHandle() = default;
+
+void ReplayHandle::pause() { state_->control.pause(); }
+void ReplayHandle::resume() { state_->control.resume(); }
+void ReplayHandle::cancel() { state_->control.cancel(); }
+void ReplayHandle::seek(const std::chrono::microseconds timestamp) {
+  state_->control.seek(timestamp);
+}
+
+ReplayProgress ReplayHandle::progress() const {
+  return state_->control.progress();
+}
+
+std::shared_future<std::expected<ReplayStats, Error>> ReplayHandle::result()
+    const {
+  return state_->result;
+}
+
+}  // namespace robot
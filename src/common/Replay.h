@@ -0,0 +1,189 @@
+#pragma once
+
+#include <atomic>
+#include <bitset>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "Pacing.h"
+#include "robot/Error.h"
+#include "robot/Event.h"
+#include "robot/Keyboard.h"
+#include "robot/Mouse.h"
+#include "robot/ReplayHandle.h"
+
+namespace robot {
+class Session;
+}
+
+// Common internal: the replay engine every replay source shares, so an
+// in-memory Recorder and a MappedRecording inject, pace and obey control
+// requests identically, synchronously or on a scheduler thread.
+namespace robot::replay {
+
+// A recording as the engine sees it: a sorted stream that can be restarted
+// anywhere.
+class Source {
+ public:
+  virtual ~Source() = default;
+
+  // Position before the first event stamped at or after from.
+  virtual void seek(std::chrono::microseconds from) = 0;
+  // The next event, or false past the last one.
+  virtual bool next(RecordedEvent& out) = 0;
+  // Timestamp of the last event in the recording.
+  [[nodiscard]] virtual std::chrono::microseconds duration() const = 0;
+};
+
+// Inject one normalized event. Button and scroll events warp to their recorded
+// position first so replay reproduces location.
+[[nodiscard]] std::expected<void, Error> dispatch(
+    Keyboard& keyboard, Mouse& mouse, const InputEvent& event
+);
+
+// Turns recorded timestamps into deadlines. Timing is reconstructed from
+// per-event gaps (not absolute timestamps) so timeScale and maxGap apply
+// cleanly and a long idle gap cannot freeze replay; deadlines accumulate from
+// one start time, so oversleep on one event is not added to the next. Holds
+// the priority boost, if requested, for its own lifetime.
+class Pacer {
+ public:
+  explicit Pacer(const ReplayOptions& options);
+
+  // Advance the schedule to the event stamped timestamp. The first event, and
+  // the first after restart(), is due as soon as the previous one was.
+  void schedule(std::chrono::microseconds timestamp);
+  [[nodiscard]] pacing::Clock::time_point deadline() const {
+    return start_ + elapsed_;
+  }
+
+  // Block until the scheduled event is due - not at all if it already is -
+  // and record how late it is being issued.
+  void wait();
+
+  // Start a new pass: the next event follows the last one without a gap.
+  void restart() { previous_.reset(); }
+  // After a seek: the next event is due now, not when the event the seek
+  // interrupted would have been.
+  void rebase() {
+    start_ = pacing::Clock::now();
+    elapsed_ = pacing::Clock::duration(0);
+    previous_.reset();
+  }
+  // Push every remaining deadline back, as after a pause.
+  void shift(const pacing::Clock::duration by) { start_ += by; }
+
+  [[nodiscard]] ReplayStats stats() const;
+
+ private:
+  const ReplayOptions& options_;
+  pacing::ScopedPriorityBoost boost_;
+  pacing::Clock::time_point start_;
+  pacing::Clock::duration elapsed_{0};
+  std::optional<std::chrono::microseconds> previous_;
+  pacing::LatenessAccumulator lateness_;
+  std::size_t events_ = 0;
+  std::size_t immediate_ = 0;
+};
+
+// Requests from a ReplayHandle to its scheduler thread, plus the progress the
+// thread publishes back.
+class Control {
+ public:
+  enum class Command : std::uint8_t { None, Cancel, Seek };
+
+  // Controller side.
+  void pause();
+  void resume();
+  void cancel();
+  void seek(std::chrono::microseconds timestamp);
+
+  // Scheduler side. Block while paused, adding the time spent to pausedFor,
+  // then return the most urgent request (a cancel beats a seek).
+  Command take(
+      std::chrono::microseconds& seekTarget, pacing::Clock::duration& pausedFor
+  );
+  // Sleep until deadline, returning false early if a request arrives.
+  bool sleepUntil(pacing::Clock::time_point deadline);
+
+  void published(std::chrono::microseconds position, std::size_t pass);
+  void finish(ReplayState state) { state_.store(state); }
+  void setDuration(std::chrono::microseconds d) { duration_ = d; }
+  [[nodiscard]] ReplayProgress progress() const;
+
+ private:
+  bool pendingLocked() const { return paused_ || cancel_ || seek_; }
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  bool paused_ = false;
+  bool cancel_ = false;
+  std::optional<std::chrono::microseconds> seek_;
+
+  std::atomic<ReplayState> state_{ReplayState::Running};
+  std::atomic<std::size_t> issued_{0};
+  std::atomic<std::size_t> pass_{0};
+  std::atomic<std::int64_t> positionUs_{0};
+  std::chrono::microseconds duration_{0};  // Set before the thread starts.
+};
+
+// Replay source against the session's keyboard and mouse. With a control
+// block, obey its requests between events; without one, run to the end.
+[[nodiscard]] std::expected<ReplayStats, Error> run(
+    Session& session, Source& source, const ReplayOptions& options,
+    Control* control
+);
+
+// Replay to every target from the calling thread, one Source per target from
+// open(). Deadlines from every target share one clock and one min-heap, so the
+// next event due anywhere is always the next one issued.
+[[nodiscard]] std::expected<std::vector<ReplayStats>, Error> run(
+    std::span<const ReplayTarget> targets,
+    const std::function<std::unique_ptr<Source>()>& open,
+    const ReplayOptions& options
+);
+
+// Start run() on a new scheduler thread, for a ReplayHandle.
+[[nodiscard]] std::unique_ptr<ReplayHandle::State> launch(
+    Session& session, std::unique_ptr<Source> source,
+    const ReplayOptions& options
+);
+
+// Whether a timestamp lies past the end of the options' replay window.
+[[nodiscard]] inline bool pastWindow(
+    const ReplayOptions& options, const std::chrono::microseconds timestamp
+) {
+  return options.to.count() > 0 && timestamp > options.to;
+}
+
+// Reject option combinations no replay source can honour.
+[[nodiscard]] std::expected<void, Error> validate(const ReplayOptions& options);
+
+}  // namespace robot::replay
+
+namespace robot {
+
+struct ReplayHandle::State {
+  replay::Control control;
+  std::unique_ptr<replay::Source> source;
+  ReplayOptions options;
+  std::shared_future<std::expected<ReplayStats, Error>> result;
+  std::thread thread;
+
+  ~State() {
+    control.cancel();
+    if (thread.joinable()) thread.join();
+  }
+};
+
+}  // namespace robot
@@ -0,0 +1,70 @@
+#include "robot/ScriptExecutor.h"
+
+#include "Pacing.h"
+#include "TimerWheel.h"
+
+namespace robot {
+
+ScriptExecutor::ScriptExecutor(const std::chrono::microseconds resolution)
+    : wheel_(
+          std::make_unique<scripting::TimerWheel>(resolution, Clock::now())
+      ) {}
+
+ScriptExecutor::~ScriptExecutor() {
+  // Nothing is resumed from here on: drop every parked handle first, so a
+  // frame destroyed below is not left behind in the wheel or the queue.
+  wheel_->clear();
+  ready_.clear();
+  // A root owns its script's Task, which owns whatever that is awaiting, so
+  // destroying the roots destroys every frame. Each root's Completion fails
+  // its future with Cancelled on the way.
+  const auto roots = std::move(roots_);
+  roots_.clear();
+  for (void* root : roots) {
+    std::coroutine_handle<>::from_address(root).destroy();
+  }
+}
+
+bool ScriptExecutor::runUntil(const Clock::time_point limit) {
+  while (!roots_.empty()) {
+    while (!ready_.empty()) {
+      const auto handle = ready_.front();
+      ready_.pop_front();
+      handle.resume();
+    }
+    // Every unfinished script is now parked on a timer.
+    const auto next = wheel_->next();
+    if (!next) break;
+    if (*next > limit) {
+      pacing::sleepUntil(limit);
+      return false;
+    }
+    if (*next > Clock::now()) pacing::sleepUntil(*next);
+    wheel_->expire(Clock::now(), due_);
+    ready_.insert(ready_.end(), due_.begin(), due_.end());
+    due_.clear();
+  }
+  return roots_.empty();
+}
+
+void ScriptExecutor::addTimer(
+    const Clock::time_point deadline, const std::coroutine_handle<> handle
+) {
+  wheel_->add(deadline, handle);
+}
+
+void ScriptExecutor::adopt(
+    const std::coroutine_handle<Root::promise_type> root
+) {
+  root.promise().executor = this;
+  roots_.insert(root.address());
+  ready_.push_back(root);
+}
+
+void ScriptExecutor::retire(
+    const std::coroutine_handle<Root::promise_type> root
+) {
+  roots_.erase(root.address());
+}
+
+}  // namespace robot
@@ -0,0 +1,166 @@
+#include "robot/ScriptSession.h"
+
+#include <optional>
+#include <utility>
+
+#include "Gesture.h"
+#include "robot/backend/IPlatformBackend.h"
+
+namespace robot {
+namespace {
+
+// Step g to the end, parking on the executor's timers between steps. If the
+// script is destroyed while parked, the gesture is abandoned so it does not
+// leave a button held.
+template <typename G>
+auto drive(ScriptExecutor& executor, G& g) -> Task<decltype(g.result())> {
+  struct AbandonUnlessFinished {
+    G& gesture;
+    bool finished = false;
+    ~AbandonUnlessFinished() {
+      if (!finished) gesture.abandon();
+    }
+  } guard{g};
+  while (const auto wait = g.step()) {
+    co_await executor.sleepUntil(wait->deadline);
+  }
+  guard.finished = true;
+  co_return g.result();
+}
+
+}  // namespace
+
+ScriptSession::ScriptSession(
+    ScriptExecutor& executor, backend::IPlatformBackend& backend
+)
+    : executor_(&executor),
+      backend_(&backend),
+      keyboard_(backend.keyboard()),
+      mouse_(backend.mouse(), &backend.screen()),
+      screen_(backend.screen()) {}
+
+// ── Keyboard ─────────────────────────────────────────────────────────────────
+
+ScriptSession::Op<void> ScriptSession::press(const Key key) {
+  co_return keyboard_.press(key);
+}
+
+ScriptSession::Op<void> ScriptSession::release(const Key key) {
+  co_return keyboard_.release(key);
+}
+
+ScriptSession::Op<void> ScriptSession::tap(
+    const Key key, const Modifiers modifiers
+) {
+  co_return keyboard_.tap(key, modifiers);
+}
+
+ScriptSession::Op<void> ScriptSession::sequence(
+    std::vector<KeyTransition> transitions
+) {
+  co_return keyboard_.sequence(transitions);
+}
+
+ScriptSession::Op<void> ScriptSession::typeChar(const char32_t codepoint) {
+  co_return keyboard_.typeChar(codepoint);
+}
+
+ScriptSession::Op<void> ScriptSession::typeText(std::string utf8) {
+  co_return keyboard_.typeText(utf8);
+}
+
+ScriptSession::Op<void> ScriptSession::typeTextHumanLike(
+    std::string utf8, HumanTypingOptions options
+) {
+  gesture::TypeText type(backend_->keyboard(), utf8, options);
+  co_return co_await drive(*executor_, type);
+}
+
+// ── Mouse ────────────────────────────────────────────────────────────────────
+
+ScriptSession::Op<void> ScriptSession::move(const LogicalPoint point) {
+  co_return mouse_.move(point);
+}
+
+ScriptSession::Op<MoveStats> ScriptSession::moveSmooth(
+    const LogicalPoint point, MouseMoveOptions options
+) {
+  gesture::MoveSmooth move(
+      backend_->mouse(), &backend_->screen(), point, options
+  );
+  co_return co_await drive(*executor_, move);
+}
+
+ScriptSession::Op<MoveStats> ScriptSession::followPath(
+    std::vector<LogicalPoint> path, MouseMoveOptions options
+) {
+  gesture::FollowPath follow(backend_->mouse(), std::move(path), options);
+  co_return co_await drive(*executor_, follow);
+}
+
+ScriptSession::Op<LogicalPoint> ScriptSession::position() {
+  co_return mouse_.position();
+}
+
+ScriptSession::Op<void> ScriptSession::press(const MouseButton button) {
+  co_return mouse_.press(button);
+}
+
+ScriptSession::Op<void> ScriptSession::release(const MouseButton button) {
+  co_return mouse_.release(button);
+}
+
+ScriptSession::Op<void> ScriptSession::click(const MouseButton button) {
+  co_return mouse_.click(button);
+}
+
+ScriptSession::Op<void> ScriptSession::doubleClick(const MouseButton button) {
+  co_return mouse_.doubleClick(button);
+}
+
+ScriptSession::Op<void> ScriptSession::drag(
+    const LogicalPoint to, const MouseButton button
+) {
+  gesture::Drag drag(
+      backend_->mouse(), &backend_->screen(), to, button, std::nullopt
+  );
+  co_return co_await drive(*executor_, drag);
+}
+
+ScriptSession::Op<void> ScriptSession::dragSmooth(
+    const LogicalPoint to, const MouseButton button, MouseMoveOptions options
+) {
+  gesture::Drag drag(
+      backend_->mouse(), &backend_->screen(), to, button, options
+  );
+  co_return co_await drive(*executor_, drag);
+}
+
+ScriptSession::Op<void> ScriptSession::scroll(const ScrollDelta delta) {
+  co_return mouse_.scroll(delta);
+}
+
+ScriptSession::Op<MoveStats> ScriptSession::scrollSmooth(
+    const ScrollDelta total, ScrollSmoothOptions options
+) {
+  gesture::ScrollSmooth scroll(backend_->mouse(), total, options);
+  co_return co_await drive(*executor_, scroll);
+}
+
+// ── Screen ───────────────────────────────────────────────────────────────────
+
+ScriptSession::Op<std::vector<Monitor>> ScriptSession::monitors() {
+  co_return screen_.monitors();
+}
+
+ScriptSession::Op<Image> ScriptSession::capture(const PhysicalRect region) {
+  co_return screen_.capture(region);
+}
+
+ScriptSession::Op<Image> ScriptSession::captureMonitor(
+    const std::uint32_t monitorId
+) {
+  co_return screen_.captureMonitor(monitorId);
+}
+
+}  // namespace robot
@@ -2,6 +2,8 @@
 
 #include <utility>
 
+#include "robot/AsyncSession.h"
+#include "robot/ScriptSession.h"
 #include "robot/backend/BackendFactory.h"
 #include "robot/backend/IPlatformBackend.h"
 
@@ -15,6 +17,12 @@ std::expected<std::unique_ptr<Session>, Error> Session::create(
   return std::make_unique<Session>(PrivateTag{}, std::move(*backend));
 }
 
+std::unique_ptr<Session> Session::fromBackend(
+    std::unique_ptr<backend::IPlatformBackend> backend
+) {
+  return std::make_unique<Session>(PrivateTag{}, std::move(backend));
+}
+
 // backend_ is declared first, so it is fully constructed before the facades'
 // initializers run and can safely hand out references into it.
 Session::Session(
@@ -23,10 +31,21 @@ Session::Session(
     : backend_(std::move(backend)),
       capabilities_(backend_->capabilities()),
       keyboard_(backend_->keyboard()),
-      mouse_(backend_->mouse()),
+      mouse_(backend_->mouse(), &backend_->screen()),
       screen_(backend_->screen()),
       eventTap_(backend_->eventTap()) {}
 
+AsyncSession& Session::async() {
+  std::call_once(asyncOnce_, [this] {
+    async_ = std::make_unique<AsyncSession>(*backend_);
+  });
+  return *async_;
+}
+
+ScriptSession Session::script(ScriptExecutor& executor) {
+  return ScriptSession(executor, *backend_);
+}
+
 // Defined here, where IPlatformBackend is complete, so unique_ptr can destroy it.
 Session::~Session() = default;
 
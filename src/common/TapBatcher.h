@@ -0,0 +1,68 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "TapFilter.h"
+#include "robot/EventTap.h"
+
+// Common internal: filters and batches tap events for an EventBatchSink,
+// shared by every platform tap. Runs entirely on the tap thread.
+namespace robot::tap {
+
+class Batcher {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  Batcher(EventBatchSink sink, const TapOptions& options)
+      : sink_(std::move(sink)),
+        maxBatch_(std::max<std::size_t>(options.maxBatch, 1)),
+        maxLatency_(options.maxLatency),
+        filter_(options.filter) {
+    buffer_.reserve(maxBatch_);
+  }
+
+  // Queue one event the filter accepts, delivering the batch as soon as it is
+  // full.
+  void push(const TimedEvent& event) {
+    if (!filter_.accepts(event.event)) return;
+    if (buffer_.empty()) oldest_ = Clock::now();
+    buffer_.push_back(event);
+    if (buffer_.size() >= maxBatch_) flush();
+  }
+
+  // The tap has nothing more to read for now: deliver the partial batch if
+  // there is no latency allowance or the oldest event has used it up.
+  void idle(const Clock::time_point now) {
+    if (!buffer_.empty() && now - oldest_ >= maxLatency_) flush();
+  }
+
+  // When idle() will next deliver; time_point::max() with nothing queued.
+  [[nodiscard]] Clock::time_point due() const {
+    return buffer_.empty() ? Clock::time_point::max() : oldest_ + maxLatency_;
+  }
+
+  void flush() {
+    if (buffer_.empty()) return;
+    delivered_ += buffer_.size();
+    sink_(buffer_);
+    buffer_.clear();
+  }
+
+  // Events handed to the sink so far.
+  [[nodiscard]] std::size_t delivered() const { return delivered_; }
+
+ private:
+  EventBatchSink sink_;
+  std::size_t maxBatch_;
+  std::chrono::microseconds maxLatency_;
+  Filter filter_;
+  std::vector<TimedEvent> buffer_;
+  Clock::time_point oldest_;
+  std::size_t delivered_ = 0;
+};
+
+}  // namespace robot::tap
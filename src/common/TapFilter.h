@@ -0,0 +1,67 @@
+#pragma once
+
+#include <bitset>
+#include <cstddef>
+#include <optional>
+#include <variant>
+
+#include "robot/Event.h"
+#include "robot/EventTap.h"
+#include "robot/Key.h"
+
+// Common internal: an EventFilter compiled for the tap thread, where it runs
+// on every event the OS could not filter itself.
+namespace robot::tap {
+
+class Filter {
+ public:
+  explicit Filter(const EventFilter& filter)
+      : keys_(filter.keys),
+        motion_(filter.motion),
+        buttons_(filter.buttons),
+        scroll_(filter.scroll),
+        region_(filter.region) {
+    if (filter.onlyKeys.empty()) {
+      keySet_.set();
+    } else {
+      for (const Key k : filter.onlyKeys) keySet_.set(keyToHidUsage(k) & 0xFF);
+    }
+    if (filter.onlyButtons.empty()) {
+      buttonSet_.set();
+    } else {
+      for (const MouseButton b : filter.onlyButtons) {
+        buttonSet_.set(static_cast<std::size_t>(b));
+      }
+    }
+  }
+
+  [[nodiscard]] bool accepts(const InputEvent& event) const {
+    if (const auto* k = std::get_if<KeyEvent>(&event)) {
+      return keys_ && keySet_[keyToHidUsage(k->key) & 0xFF];
+    }
+    if (const auto* m = std::get_if<MouseMoveEvent>(&event)) {
+      return motion_ && inRegion(m->position);
+    }
+    if (const auto* b = std::get_if<MouseButtonEvent>(&event)) {
+      return buttons_ && buttonSet_[static_cast<std::size_t>(b->button)] &&
+             inRegion(b->position);
+    }
+    const auto& s = std::get<ScrollEvent>(event);
+    return scroll_ && inRegion(s.position);
+  }
+
+ private:
+  [[nodiscard]] bool inRegion(const LogicalPoint p) const {
+    return !region_ || region_->contains(p);
+  }
+
+  bool keys_;
+  bool motion_;
+  bool buttons_;
+  bool scroll_;
+  std::bitset<256> keySet_;
+  std::bitset<5> buttonSet_;
+  std::optional<LogicalRect> region_;
+};
+
+}  // namespace robot::tap
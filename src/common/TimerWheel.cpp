@@ -0,0 +1,83 @@
+#include "TimerWheel.h"
+
+#include <algorithm>
+
+namespace robot::scripting {
+
+TimerWheel::TimerWheel(
+    const Clock::duration resolution, const Clock::time_point origin
+)
+    : resolution_(std::max(resolution, Clock::duration(1))), origin_(origin) {}
+
+std::int64_t TimerWheel::tickOf(const Clock::time_point t) const {
+  if (t <= origin_) return 0;
+  return static_cast<std::int64_t>((t - origin_) / resolution_);
+}
+
+void TimerWheel::add(
+    const Clock::time_point deadline, const std::coroutine_handle<> handle
+) {
+  // A tick already expired is never visited again; its timers go in the
+  // current one, which the next expire() does visit.
+  const std::int64_t tick = std::max(tickOf(deadline), current_);
+  slot(tick).push_back({.deadline = deadline, .tick = tick, .handle = handle});
+  ++size_;
+}
+
+std::optional<TimerWheel::Clock::time_point> TimerWheel::next() const {
+  if (size_ == 0) return std::nullopt;
+
+  // The first slot from the current tick holding a timer for its own tick
+  // has the earliest deadline; only timers a revolution or more away need
+  // the full scan.
+  for (std::int64_t tick = current_;
+       tick < current_ + static_cast<std::int64_t>(kSlots); ++tick) {
+    std::optional<Clock::time_point> earliest;
+    for (const Timer& t : slots_[static_cast<std::size_t>(tick) % kSlots]) {
+      if (t.tick == tick && (!earliest || t.deadline < *earliest)) {
+        earliest = t.deadline;
+      }
+    }
+    if (earliest) return earliest;
+  }
+  std::optional<Clock::time_point> earliest;
+  for (const auto& s : slots_) {
+    for (const Timer& t : s) {
+      if (!earliest || t.deadline < *earliest) earliest = t.deadline;
+    }
+  }
+  return earliest;
+}
+
+void TimerWheel::expire(
+    const Clock::time_point now, std::vector<std::coroutine_handle<>>& due
+) {
+  if (size_ == 0) {
+    current_ = std::max(current_, tickOf(now));
+    return;
+  }
+  const std::int64_t last = tickOf(now);
+  // Past a full revolution every slot has been passed; visiting each once is
+  // enough, since the deadline test below decides what fires.
+  const std::int64_t visits =
+      std::min(last - current_ + 1, static_cast<std::int64_t>(kSlots));
+  for (std::int64_t i = 0; i < visits && size_ > 0; ++i) {
+    auto& timers = slot(current_ + i);
+    const auto kept = std::stable_partition(
+        timers.begin(), timers.end(),
+        [now](const Timer& t) { return t.deadline > now; }
+    );
+    for (auto it = kept; it != timers.end(); ++it) due.push_back(it->handle);
+    size_ -= static_cast<std::size_t>(timers.end() - kept);
+    timers.erase(kept, timers.end());
+  }
+  // The tick containing now may still hold timers due later in it.
+  current_ = std::max(current_, last);
+}
+
+void TimerWheel::clear() {
+  for (auto& s : slots_) s.clear();
+  size_ = 0;
+}
+
+}  // namespace robot::scripting
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <array>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "Pacing.h"
+
+// Common internal: the timers of ScriptExecutor. A hashed wheel of fixed
+// slots, each covering one resolution-wide tick; a timer lands in the slot of
+// its deadline's tick, so adding is O(1) however many scripts are waiting,
+// and expiring touches only the slots the clock has passed. Timers more than
+// one revolution out share a slot with nearer ones and are skipped until
+// their own tick comes round.
+namespace robot::scripting {
+
+class TimerWheel {
+ public:
+  using Clock = pacing::Clock;
+
+  TimerWheel(Clock::duration resolution, Clock::time_point origin);
+
+  // Resume handle once deadline has passed. A deadline already past is due
+  // at the next expire().
+  void add(Clock::time_point deadline, std::coroutine_handle<> handle);
+
+  // The earliest deadline of any timer, or nullopt when there are none.
+  [[nodiscard]] std::optional<Clock::time_point> next() const;
+
+  // Append to due every timer whose deadline is at or before now, in the
+  // order they were added within each tick, and forget them.
+  void expire(Clock::time_point now, std::vector<std::coroutine_handle<>>& due);
+
+  [[nodiscard]] bool empty() const { return size_ == 0; }
+  [[nodiscard]] std::size_t size() const { return size_; }
+
+  // Forget every timer without resuming it.
+  void clear();
+
+ private:
+  // 256 slots of the default 1 ms: waits up to a quarter second, which covers
+  // every gap a gesture takes, stay within one revolution.
+  static constexpr std::size_t kSlots = 256;
+
+  struct Timer {
+    Clock::time_point deadline;
+    std::int64_t tick;
+    std::coroutine_handle<> handle;
+  };
+
+  [[nodiscard]] std::int64_t tickOf(Clock::time_point t) const;
+  [[nodiscard]] std::vector<Timer>& slot(std::int64_t tick) {
+    return slots_[static_cast<std::size_t>(tick) % kSlots];
+  }
+
+  Clock::duration resolution_;
+  Clock::time_point origin_;
+  // Every tick before this one has been expired.
+  std::int64_t current_ = 0;
+  std::size_t size_ = 0;
+  std::array<std::vector<Timer>, kSlots> slots_;
+};
+
+}  // namespace robot::scripting
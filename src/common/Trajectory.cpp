@@ -0,0 +1,128 @@
+#include "robot/Trajectory.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace robot {
+namespace {
+
+double minimumJerk(const double t) {
+  return t * t * t * (10.0 + t * (-15.0 + 6.0 * t));
+}
+
+LogicalPoint lerp(const LogicalPoint a, const LogicalPoint b, const double s) {
+  return {a.x + (b.x - a.x) * s, a.y + (b.y - a.y) * s};
+}
+
+// A cubic Bezier segment from p0 to p3. A straight segment is the degenerate
+// case with the control points on the chord, so one evaluator serves both.
+struct Segment {
+  LogicalPoint p0, p1, p2, p3;
+
+  [[nodiscard]] LogicalPoint at(const double s) const {
+    const double u = 1.0 - s;
+    const double a = u * u * u;
+    const double b = 3.0 * u * u * s;
+    const double c = 3.0 * u * s * s;
+    const double d = s * s * s;
+    return {a * p0.x + b * p1.x + c * p2.x + d * p3.x,
+            a * p0.y + b * p1.y + c * p2.y + d * p3.y};
+  }
+};
+
+Segment straight(const LogicalPoint from, const LogicalPoint to) {
+  return {from, lerp(from, to, 1.0 / 3.0), lerp(from, to, 2.0 / 3.0), to};
+}
+
+Segment curved(
+    const LogicalPoint from, const LogicalPoint to, const double curvature,
+    std::mt19937_64& engine
+) {
+  const double dx = to.x - from.x;
+  const double dy = to.y - from.y;
+  // (-dy, dx) is the chord's normal scaled by its length, so a fractional
+  // offset along it is already proportional to the distance.
+  std::uniform_real_distribution<double> offset(-curvature, curvature);
+  const double o1 = offset(engine);
+  const double o2 = offset(engine);
+  const LogicalPoint c1 = lerp(from, to, 1.0 / 3.0);
+  const LogicalPoint c2 = lerp(from, to, 2.0 / 3.0);
+  return {from,
+          {c1.x - dy * o1, c1.y + dx * o1},
+          {c2.x - dy * o2, c2.y + dx * o2},
+          to};
+}
+
+void sample(
+    const Segment& segment, const VelocityProfile velocity, const int count,
+    std::vector<LogicalPoint>& out
+) {
+  for (int i = 1; i <= count; ++i) {
+    const double t = static_cast<double>(i) / static_cast<double>(count);
+    out.push_back(segment.at(progressAt(velocity, t)));
+  }
+}
+
+}  // namespace
+
+double progressAt(const VelocityProfile velocity, const double t) {
+  switch (velocity) {
+    case VelocityProfile::Constant: return t;
+    case VelocityProfile::MinimumJerk: return minimumJerk(t);
+  }
+  return t;
+}
+
+std::chrono::milliseconds FittsTiming::durationFor(const double distance) const {
+  const double width = std::max(targetWidth, 1.0);
+  const double bits = std::log2(std::max(distance, 0.0) / width + 1.0);
+  const double ms = static_cast<double>(intercept.count()) +
+                    static_cast<double>(slope.count()) * bits;
+  return std::chrono::milliseconds(std::llround(ms));
+}
+
+void Trajectory::generate(
+    const LogicalPoint from, const LogicalPoint to, int steps,
+    const TrajectoryOptions& options
+) {
+  steps = std::max(steps, 1);
+  points_.clear();
+  points_.reserve(static_cast<std::size_t>(steps));
+
+  std::mt19937_64 engine(
+      options.seed == 0 ? std::random_device{}() : options.seed
+  );
+
+  const double dx = to.x - from.x;
+  const double dy = to.y - from.y;
+
+  // Overshoot needs at least one step for each leg.
+  const bool overshoot = options.overshoot > 0.0 && steps >= 2;
+  int mainSteps = steps;
+  LogicalPoint mainTarget = to;
+  if (overshoot) {
+    const int correction = std::clamp(
+        static_cast<int>(std::lround(options.correctionShare * steps)), 1,
+        steps - 1
+    );
+    mainSteps = steps - correction;
+    mainTarget = {to.x + dx * options.overshoot, to.y + dy * options.overshoot};
+  }
+
+  const Segment main = options.shape == PathShape::Bezier
+                           ? curved(from, mainTarget, options.curvature, engine)
+                           : straight(from, mainTarget);
+  sample(main, options.velocity, mainSteps, points_);
+  if (overshoot) {
+    sample(
+        straight(mainTarget, to), VelocityProfile::MinimumJerk,
+        steps - mainSteps, points_
+    );
+  }
+
+  // Pin the endpoint exactly; the polynomial evaluation can be off by an ulp.
+  points_.back() = to;
+}
+
+}  // namespace robot
@@ -0,0 +1,78 @@
+#include "Utf8.h"
+
+#include <cstddef>
+
+namespace robot {
+
+std::expected<std::vector<char32_t>, Error> decodeUtf8(
+    const std::string_view s
+) {
+  std::vector<char32_t> out;
+  out.reserve(s.size());
+
+  const std::size_t n = s.size();
+  const auto byte = [&](const std::size_t idx) {
+    return static_cast<unsigned char>(s[idx]);
+  };
+
+  std::size_t i = 0;
+  while (i < n) {
+    const unsigned char lead = byte(i);
+    char32_t cp = 0;
+    std::size_t extra = 0;
+    char32_t minValue = 0;
+
+    if (lead < 0x80) {
+      cp = lead;
+      extra = 0;
+      minValue = 0;
+    } else if ((lead & 0xE0) == 0xC0) {
+      cp = lead & 0x1F;
+      extra = 1;
+      minValue = 0x80;
+    } else if ((lead & 0xF0) == 0xE0) {
+      cp = lead & 0x0F;
+      extra = 2;
+      minValue = 0x800;
+    } else if ((lead & 0xF8) == 0xF0) {
+      cp = lead & 0x07;
+      extra = 3;
+      minValue = 0x10000;
+    } else {
+      return std::unexpected(Error::invalidArgument("invalid UTF-8 lead byte"));
+    }
+
+    if (i + extra >= n) {
+      return std::unexpected(
+          Error::invalidArgument("truncated UTF-8 sequence")
+      );
+    }
+    for (std::size_t k = 1; k <= extra; ++k) {
+      const unsigned char cont = byte(i + k);
+      if ((cont & 0xC0) != 0x80) {
+        return std::unexpected(
+            Error::invalidArgument("invalid UTF-8 continuation byte")
+        );
+      }
+      cp = (cp << 6) | (cont & 0x3F);
+    }
+
+    if (cp < minValue) {
+      return std::unexpected(Error::invalidArgument("overlong UTF-8 encoding"));
+    }
+    if (cp > 0x10FFFF) {
+      return std::unexpected(Error::invalidArgument("codepoint out of range"));
+    }
+    if (cp >= 0xD800 && cp <= 0xDFFF) {
+      return std::unexpected(
+          Error::invalidArgument("UTF-16 surrogate is not a scalar value")
+      );
+    }
+
+    out.push_back(cp);
+    i += extra + 1;
+  }
+  return out;
+}
+
+}  // namespace robot
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <expected>
+#include <string_view>
+#include <vector>
+
+#include "robot/Error.h"
+
+// Common internal: UTF-8 decoding for the text paths of Keyboard and
+// AsyncSession.
+namespace robot {
+
+// Decode UTF-8 to Unicode scalar values, rejecting malformed input rather than
+// substituting replacement characters (typing a replacement character silently
+// would be exactly the kind of best-effort behaviour this library avoids).
+[[nodiscard]] std::expected<std::vector<char32_t>, Error> decodeUtf8(
+    std::string_view s
+);
+
+}  // namespace robot
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <linux/input.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+
+#include "robot/Error.h"
+
+namespace robot::linux_uinput {
+
+// Evdev events accumulated in a fixed stack buffer and handed to the kernel in
+// one write. uinput accepts any number of whole input_events per write and
+// injects them in order, so a report (several events plus its SYN_REPORT), or a
+// run of reports, costs one system call instead of one per event. A batch that
+// outgrows the buffer flushes itself and carries on; nothing is allocated.
+class EvdevBatch {
+ public:
+  static constexpr std::size_t kCapacity = 64;
+
+  explicit EvdevBatch(const int fd) : fd_(fd) {}
+
+  EvdevBatch(const EvdevBatch&) = delete;
+  EvdevBatch& operator=(const EvdevBatch&) = delete;
+
+  [[nodiscard]] std::expected<void, Error> add(
+      const std::uint16_t type, const std::uint16_t code,
+      const std::int32_t value
+  ) {
+    if (size_ == kCapacity) {
+      if (auto r = flush(); !r) return r;
+    }
+    input_event& ev = events_[size_++];
+    ev = input_event{};
+    ev.type = type;
+    ev.code = code;
+    ev.value = value;
+    return {};
+  }
+
+  // Close the current report.
+  [[nodiscard]] std::expected<void, Error> sync() {
+    return add(EV_SYN, SYN_REPORT, 0);
+  }
+
+  [[nodiscard]] std::expected<void, Error> flush() {
+    if (size_ == 0) return {};
+    const auto bytes = static_cast<ssize_t>(size_ * sizeof(input_event));
+    size_ = 0;
+    ++writes_;
+    if (write(fd_, events_.data(), static_cast<std::size_t>(bytes)) != bytes) {
+      return std::unexpected(Error::platformError("write to /dev/uinput"));
+    }
+    return {};
+  }
+
+  // System calls issued so far; the batching benchmark reports this.
+  [[nodiscard]] std::size_t writes() const { return writes_; }
+
+ private:
+  int fd_;
+  std::size_t size_ = 0;
+  std::size_t writes_ = 0;
+  std::array<input_event, kCapacity> events_;
+};
+
+}  // namespace robot::linux_uinput
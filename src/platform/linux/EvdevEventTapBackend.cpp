@@ -0,0 +1,493 @@
+#include "EvdevEventTapBackend.h"
+
+#include <fcntl.h>
+#include <linux/input.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <ctime>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "LinuxEvdevKeymap.h"
+#include "common/TapBatcher.h"
+#include "robot/Event.h"
+
+namespace robot::linux_evdev {
+namespace {
+
+using Clock = tap::Batcher::Clock;
+
+// input_events taken per read(); a burst longer than this takes another.
+constexpr std::size_t kReadEvents = 64;
+// Ready descriptors taken per epoll_wait().
+constexpr int kMaxReady = 16;
+// High-resolution wheel axes count 120 units per notch; the legacy axes are
+// scaled up to match so both sum in one unit.
+constexpr double kHiResPerNotch = 120.0;
+// The names UinputBackend gives its virtual devices.
+constexpr std::string_view kOwnDevicePrefix = "robot-cpp virtual";
+// epoll user data marking the stop() eventfd rather than a device index.
+constexpr std::uint64_t kWakeToken = UINT64_MAX;
+
+// One event type's capability bits, as EVIOCGBIT reports them.
+template <std::size_t Count>
+class CapabilityBits {
+ public:
+  bool read(const int fd, const unsigned type) {
+    return ioctl(fd, EVIOCGBIT(type, sizeof(words_)), words_.data()) >= 0;
+  }
+  // The keys and buttons currently held (key devices only).
+  bool readHeld(const int fd) {
+    return ioctl(fd, EVIOCGKEY(sizeof(words_)), words_.data()) >= 0;
+  }
+  [[nodiscard]] bool test(const std::size_t bit) const {
+    return ((words_[bit / kWordBits] >> (bit % kWordBits)) & 1UL) != 0;
+  }
+
+ private:
+  static constexpr std::size_t kWordBits = sizeof(unsigned long) * CHAR_BIT;
+  std::array<unsigned long, (Count + kWordBits - 1) / kWordBits> words_{};
+};
+
+std::optional<MouseButton> evdevButton(const std::uint16_t code) {
+  switch (code) {
+    case BTN_LEFT: return MouseButton::Left;
+    case BTN_RIGHT: return MouseButton::Right;
+    case BTN_MIDDLE: return MouseButton::Middle;
+    case BTN_SIDE: return MouseButton::X1;
+    case BTN_EXTRA: return MouseButton::X2;
+    default: return std::nullopt;
+  }
+}
+
+// Milliseconds until a batch falls due, rounded up so epoll_wait() never wakes
+// early; -1 (wait for input or stop()) when nothing is buffered.
+int waitTimeout(const Clock::time_point due) {
+  if (due == Clock::time_point::max()) return -1;
+  const auto wait = due - Clock::now();
+  if (wait <= wait.zero()) return 0;
+  const auto ms = std::chrono::ceil<std::chrono::milliseconds>(wait).count();
+  return static_cast<int>(std::min<long long>(ms, INT_MAX));
+}
+
+struct AbsAxis {
+  std::int32_t minimum = 0;
+  std::int32_t maximum = 0;
+};
+
+}  // namespace
+
+// One open input device, with the report it is part-way through. The kernel
+// groups the events of one physical change into a report closed by
+// SYN_REPORT, so motion, wheel and key events are collected and translated
+// together when the report closes.
+struct Device {
+  int fd = -1;
+  bool kernelClock = false;  // Timestamps are CLOCK_MONOTONIC.
+  bool absolute = false;     // ABS_X/ABS_Y position the pointer.
+  bool hiResWheel = false;   // Legacy wheel events duplicate the hi-res ones.
+  bool dropping = false;     // Overrun: discard until the next SYN_REPORT.
+  AbsAxis absX;
+  AbsAxis absY;
+  std::bitset<KEY_CNT> down;  // Keys and buttons held, for resync.
+
+  double dx = 0.0;
+  double dy = 0.0;
+  std::optional<std::int32_t> ax;
+  std::optional<std::int32_t> ay;
+  double wheelV = 0.0;  // In hi-res units.
+  double wheelH = 0.0;
+  std::vector<std::pair<std::uint16_t, bool>> keys;  // Code, pressed.
+
+  void clearReport() {
+    dx = dy = wheelV = wheelH = 0.0;
+    ax.reset();
+    ay.reset();
+    keys.clear();
+  }
+};
+
+// Everything an open tap owns besides its descriptors' registration: the
+// devices, the modelled pointer position and the batcher.
+struct TapState {
+  TapState(LogicalRect area, EventBatchSink sink, const TapOptions& options)
+      : desktop(area), batcher(std::move(sink), options) {
+    if (!empty()) {
+      position = {desktop.left() + desktop.size.width / 2.0,
+                  desktop.top() + desktop.size.height / 2.0};
+    }
+  }
+
+  [[nodiscard]] bool empty() const {
+    return desktop.size.width <= 0.0 || desktop.size.height <= 0.0;
+  }
+
+  // Drain a readable device: whole arrays of input_events per read().
+  void read(Device& d) {
+    std::array<input_event, kReadEvents> events;
+    for (;;) {
+      const ssize_t bytes = ::read(d.fd, events.data(), sizeof(events));
+      if (bytes < 0) {
+        if (errno == EINTR) continue;
+        if (errno != EAGAIN) remove(d);  // ENODEV: unplugged.
+        return;
+      }
+      const auto count = static_cast<std::size_t>(bytes) / sizeof(input_event);
+      for (std::size_t i = 0; i < count; ++i) handle(d, events[i]);
+      if (count < kReadEvents) return;
+    }
+  }
+
+  void remove(Device& d) {
+    ::close(d.fd);  // Also drops it from the epoll set.
+    d.fd = -1;
+  }
+
+  void handle(Device& d, const input_event& ev) {
+    if (ev.type == EV_SYN) {
+      if (ev.code == SYN_DROPPED) {
+        // The kernel's buffer overran; what follows up to the next report is
+        // incomplete, and any key change inside the gap is lost.
+        d.clearReport();
+        d.dropping = true;
+      } else if (ev.code == SYN_REPORT) {
+        if (d.dropping) {
+          d.dropping = false;
+          resync(d, stamp(d, ev));
+        } else {
+          report(d, stamp(d, ev));
+        }
+      }
+      return;
+    }
+    if (d.dropping) return;
+
+    switch (ev.type) {
+      case EV_KEY:
+        // 2 is auto-repeat, regenerated by whatever replays the held key.
+        if (ev.value != 2 && ev.code < KEY_CNT) {
+          d.keys.emplace_back(ev.code, ev.value != 0);
+        }
+        break;
+      case EV_REL:
+        switch (ev.code) {
+          case REL_X: d.dx += ev.value; break;
+          case REL_Y: d.dy += ev.value; break;
+          case REL_WHEEL:
+            if (!d.hiResWheel) d.wheelV += ev.value * kHiResPerNotch;
+            break;
+          case REL_HWHEEL:
+            if (!d.hiResWheel) d.wheelH += ev.value * kHiResPerNotch;
+            break;
+          case REL_WHEEL_HI_RES: d.wheelV += ev.value; break;
+          case REL_HWHEEL_HI_RES: d.wheelH += ev.value; break;
+          default: break;
+        }
+        break;
+      case EV_ABS:
+        if (!d.absolute) break;
+        if (ev.code == ABS_X) d.ax = ev.value;
+        if (ev.code == ABS_Y) d.ay = ev.value;
+        break;
+      default:
+        break;
+    }
+  }
+
+  [[nodiscard]] static Clock::time_point stamp(
+      const Device& d, const input_event& ev
+  ) {
+    if (!d.kernelClock) return Clock::now();
+    return Clock::time_point(std::chrono::duration_cast<Clock::duration>(
+        std::chrono::seconds(ev.input_event_sec) +
+        std::chrono::microseconds(ev.input_event_usec)
+    ));
+  }
+
+  [[nodiscard]] double scale(
+      const std::int32_t value, const AbsAxis axis, const double origin,
+      const double extent
+  ) const {
+    const double range = static_cast<double>(axis.maximum) - axis.minimum;
+    if (range <= 0.0) return origin;
+    const double offset = static_cast<double>(value) - axis.minimum;
+    return origin + offset / range * (extent - 1.0);
+  }
+
+  void report(Device& d, const Clock::time_point at) {
+    const auto emit = [&](const InputEvent& e) { batcher.push({at, e}); };
+
+    if (d.dx != 0.0 || d.dy != 0.0 || d.ax || d.ay) {
+      LogicalPoint p = position;
+      if (d.ax) p.x = scale(*d.ax, d.absX, desktop.left(), desktop.size.width);
+      if (d.ay) p.y = scale(*d.ay, d.absY, desktop.top(), desktop.size.height);
+      p.x += d.dx;
+      p.y += d.dy;
+      if (!empty()) {
+        p.x = std::clamp(p.x, desktop.left(), desktop.right() - 1.0);
+        p.y = std::clamp(p.y, desktop.top(), desktop.bottom() - 1.0);
+      }
+      if (p.x != position.x || p.y != position.y) {
+        position = p;
+        emit(MouseMoveEvent{position});
+      }
+    }
+    if (d.wheelV != 0.0 || d.wheelH != 0.0) {
+      emit(ScrollEvent{ScrollDelta::lines(d.wheelV / kHiResPerNotch,
+                                          d.wheelH / kHiResPerNotch),
+                       position});
+    }
+    for (const auto& [code, pressed] : d.keys) key(d, code, pressed, at);
+    d.clearReport();
+  }
+
+  void key(
+      Device& d, const std::uint16_t code, const bool pressed,
+      const Clock::time_point at
+  ) {
+    d.down.set(code, pressed);
+    if (const auto button = evdevButton(code)) {
+      batcher.push({at, MouseButtonEvent{*button, pressed, position}});
+    } else if (const auto k = evdevToKey(code)) {
+      batcher.push({at, KeyEvent{*k, pressed}});
+    }
+  }
+
+  // After an overrun, read the device's actual key state and report whatever
+  // changed during the gap, so no press is left without its release.
+  void resync(Device& d, const Clock::time_point at) {
+    CapabilityBits<KEY_CNT> state;
+    if (!state.readHeld(d.fd)) return;
+    for (std::uint16_t code = 0; code < KEY_CNT; ++code) {
+      if (state.test(code) != d.down.test(code)) {
+        key(d, code, state.test(code), at);
+      }
+    }
+  }
+
+  LogicalRect desktop;
+  LogicalPoint position;
+  std::vector<Device> devices;
+  tap::Batcher batcher;
+};
+
+EvdevEventTapBackend::EvdevEventTapBackend(
+    const LogicalRect desktop, const bool grab
+)
+    : desktop_(desktop),
+      grab_(grab),
+      wake_(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) {}
+
+EvdevEventTapBackend::~EvdevEventTapBackend() {
+  if (pollable_) stop();
+  if (wake_ >= 0) ::close(wake_);
+}
+
+std::expected<void, Error> EvdevEventTapBackend::open(
+    EventBatchSink sink, const TapOptions& options
+) {
+  if (running_.load()) {
+    return std::unexpected(
+        Error::unsupported("the event tap is already running")
+    );
+  }
+  epoll_ = epoll_create1(EPOLL_CLOEXEC);
+  if (epoll_ < 0 || wake_ < 0) {
+    close();
+    return std::unexpected(Error::platformError("epoll_create1 / eventfd"));
+  }
+  // Clear a wakeup left by a stop() that raced the previous run's exit.
+  std::uint64_t stale = 0;
+  (void)::read(wake_, &stale, sizeof(stale));
+  epoll_event wake{.events = EPOLLIN, .data = {.u64 = kWakeToken}};
+  epoll_ctl(epoll_, EPOLL_CTL_ADD, wake_, &wake);
+
+  state_ = std::make_unique<TapState>(desktop_, std::move(sink), options);
+  const EventFilter& filter = options.filter;
+  const bool wantPointer = filter.motion || filter.buttons || filter.scroll;
+
+  bool denied = false;
+  std::error_code ec;
+  for (const auto& entry :
+       std::filesystem::directory_iterator("/dev/input", ec)) {
+    if (!entry.path().filename().string().starts_with("event")) continue;
+    const int fd =
+        ::open(entry.path().c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) {
+      denied = denied || errno == EACCES || errno == EPERM;
+      continue;
+    }
+
+    std::array<char, 256> name{};
+    ioctl(fd, EVIOCGNAME(name.size() - 1), name.data());
+    CapabilityBits<EV_CNT> types;
+    CapabilityBits<KEY_CNT> keys;
+    CapabilityBits<REL_CNT> rels;
+    CapabilityBits<ABS_CNT> abs;
+    types.read(fd, 0);
+    if (types.test(EV_KEY)) keys.read(fd, EV_KEY);
+    if (types.test(EV_REL)) rels.read(fd, EV_REL);
+    if (types.test(EV_ABS)) abs.read(fd, EV_ABS);
+
+    bool keyboard = false;
+    for (std::uint16_t code = 0; code < KEY_CNT && !keyboard; ++code) {
+      keyboard = keys.test(code) && evdevToKey(code).has_value();
+    }
+    // Touch devices report finger positions, not the pointer's.
+    const bool absolute = abs.test(ABS_X) && abs.test(ABS_Y) &&
+                          !keys.test(BTN_TOUCH) && !state_->empty();
+    const bool pointer = (rels.test(REL_X) && rels.test(REL_Y)) || absolute ||
+                         rels.test(REL_WHEEL) || rels.test(REL_HWHEEL) ||
+                         keys.test(BTN_LEFT);
+    const bool own =
+        std::string_view(name.data()).starts_with(kOwnDevicePrefix);
+    if (own || !((keyboard && filter.keys) || (pointer && wantPointer))) {
+      ::close(fd);
+      continue;
+    }
+
+    Device d;
+    d.fd = fd;
+    const int clock = CLOCK_MONOTONIC;
+    d.kernelClock = ioctl(fd, EVIOCSCLOCKID, &clock) == 0;
+    d.absolute = absolute;
+    d.hiResWheel = rels.test(REL_WHEEL_HI_RES);
+    if (absolute) {
+      input_absinfo info{};
+      if (ioctl(fd, EVIOCGABS(ABS_X), &info) == 0) {
+        d.absX = {info.minimum, info.maximum};
+      }
+      if (ioctl(fd, EVIOCGABS(ABS_Y), &info) == 0) {
+        d.absY = {info.minimum, info.maximum};
+      }
+    }
+    // Start from the keys already held, so their releases are not mistaken
+    // for state lost in an overrun.
+    CapabilityBits<KEY_CNT> held;
+    if (held.readHeld(fd)) {
+      for (std::size_t code = 0; code < KEY_CNT; ++code) {
+        d.down.set(code, held.test(code));
+      }
+    }
+    if (grab_) (void)ioctl(fd, EVIOCGRAB, 1);
+
+    epoll_event ready{
+        .events = EPOLLIN, .data = {.u64 = state_->devices.size()}
+    };
+    if (epoll_ctl(epoll_, EPOLL_CTL_ADD, fd, &ready) < 0) {
+      ::close(fd);
+      continue;
+    }
+    state_->devices.push_back(std::move(d));
+  }
+
+  if (state_->devices.empty()) {
+    close();
+    if (denied) {
+      return std::unexpected(Error::permissionDenied(
+          "cannot read /dev/input/event*; run as root or add the user to the "
+          "input group"
+      ));
+    }
+    return std::unexpected(Error::backendUnavailable(
+        "no keyboard or pointer device under /dev/input"
+    ));
+  }
+  running_.store(true);
+  return {};
+}
+
+void EvdevEventTapBackend::process(const int timeoutMs) {
+  std::array<epoll_event, kMaxReady> ready;
+  const int count = epoll_wait(epoll_, ready.data(), kMaxReady, timeoutMs);
+  for (int i = 0; i < count; ++i) {
+    const std::uint64_t token = ready[static_cast<std::size_t>(i)].data.u64;
+    if (token == kWakeToken) {
+      std::uint64_t value = 0;
+      (void)::read(wake_, &value, sizeof(value));
+      continue;
+    }
+    Device& d = state_->devices[token];
+    if (d.fd >= 0) state_->read(d);
+  }
+}
+
+void EvdevEventTapBackend::close() {
+  if (state_) {
+    for (Device& d : state_->devices) {
+      if (d.fd < 0) continue;
+      if (grab_) (void)ioctl(d.fd, EVIOCGRAB, 0);
+      ::close(d.fd);
+    }
+  }
+  if (epoll_ >= 0) ::close(epoll_);
+  epoll_ = -1;
+  state_.reset();
+}
+
+std::expected<void, Error> EvdevEventTapBackend::start(
+    EventBatchSink sink, const TapOptions& options
+) {
+  if (auto r = open(std::move(sink), options); !r) return r;
+
+  tap::Batcher& batcher = state_->batcher;
+  while (running_.load()) {
+    process(waitTimeout(batcher.due()));
+    batcher.idle(Clock::now());
+  }
+  batcher.flush();
+  close();
+  return {};
+}
+
+std::expected<int, Error> EvdevEventTapBackend::startPollable(
+    EventBatchSink sink, const TapOptions& options
+) {
+  if (auto r = open(std::move(sink), options); !r) {
+    return std::unexpected(r.error());
+  }
+  pollable_ = true;
+  // An epoll descriptor polls readable while any device in it is.
+  return epoll_;
+}
+
+std::expected<std::size_t, Error> EvdevEventTapBackend::dispatch() {
+  if (!pollable_) {
+    return std::unexpected(
+        Error::invalidArgument("dispatch() needs a tap from startPollable()")
+    );
+  }
+  const std::size_t before = state_->batcher.delivered();
+  process(0);
+  state_->batcher.flush();
+  return state_->batcher.delivered() - before;
+}
+
+void EvdevEventTapBackend::stop() {
+  running_.store(false);
+  // Wakes the blocking wait in start(); the eventfd outlives every run.
+  const std::uint64_t one = 1;
+  if (wake_ >= 0) (void)::write(wake_, &one, sizeof(one));
+  if (pollable_) {
+    pollable_ = false;
+    process(0);
+    state_->batcher.flush();
+    close();
+  }
+}
+
+}  // namespace robot::linux_evdev
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+#include "robot/Geometry.h"
+#include "robot/backend/IEventTapBackend.h"
+
+namespace robot::linux_evdev {
+
+struct TapState;
+
+// Global input tap that reads the kernel's input devices, /dev/input/event*,
+// directly. It needs no display server, so it is the uinput backend's tap: it
+// records under Wayland and on headless machines alike, given read access to
+// the devices (root, or membership of the input group). Every keyboard and
+// pointer present at start() is opened non-blocking and registered with one
+// epoll instance; each wakeup drains a device with batched read()s of whole
+// input_event arrays. Events carry the kernel's own timestamp, switched to
+// CLOCK_MONOTONIC per device so it is already a steady_clock time.
+//
+// Key codes map back to physical Key values through the evdev keymap; auto-
+// repeat reports are dropped, since replaying the held key regenerates them.
+// The kernel has no pointer position, only motion: relative motion is summed
+// into a position that starts at the centre of the desktop and is clamped to
+// it, and absolute pointers (tablets, virtual machine pointers) are scaled
+// onto it. The position is therefore a model, exact only when the desktop
+// matches the compositor's layout and the pointer has no acceleration.
+// Touchpads, which report finger positions rather than pointer motion, are not
+// tracked. The library's own uinput devices are skipped, so replaying while
+// recording does not feed back.
+//
+// With grab set, each device is taken exclusively (EVIOCGRAB) while the tap
+// runs: captured input then reaches nothing else, which suits a dedicated
+// recording rig but locks out the local user until stop(). Devices plugged in
+// after start() are not picked up.
+class EvdevEventTapBackend final : public backend::IEventTapBackend {
+ public:
+  EvdevEventTapBackend(LogicalRect desktop, bool grab);
+  ~EvdevEventTapBackend() override;
+
+  EvdevEventTapBackend(const EvdevEventTapBackend&) = delete;
+  EvdevEventTapBackend& operator=(const EvdevEventTapBackend&) = delete;
+
+  std::expected<void, Error> start(
+      EventBatchSink sink, const TapOptions& options
+  ) override;
+  std::expected<int, Error> startPollable(
+      EventBatchSink sink, const TapOptions& options
+  ) override;
+  std::expected<std::size_t, Error> dispatch() override;
+  void stop() override;
+  [[nodiscard]] bool isRunning() const override { return running_.load(); }
+
+ private:
+  // Open and register the devices the filter can use.
+  std::expected<void, Error> open(
+      EventBatchSink sink, const TapOptions& options
+  );
+  // Wait up to timeoutMs for input and translate everything readable.
+  void process(int timeoutMs);
+  // Release whatever open() acquired.
+  void close();
+
+  LogicalRect desktop_;
+  bool grab_;
+  std::atomic<bool> running_{false};
+  bool pollable_ = false;
+
+  int epoll_ = -1;
+  int wake_ = -1;  // eventfd written by stop() to end the blocking wait.
+  std::unique_ptr<TapState> state_;
+};
+
+}  // namespace robot::linux_evdev
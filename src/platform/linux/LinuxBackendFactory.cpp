@@ -1,9 +1,11 @@
 #include <cstdlib>
+#include <string>
 #include <string_view>
 
 #include "LinuxPlatformBackend.h"
 #include "UinputBackend.h"
 #include "X11Display.h"
+#include "XcbBackendFactory.h"
 #include "robot/backend/BackendFactory.h"
 
 namespace robot::backend {
@@ -14,7 +16,8 @@ bool waylandSessionActive() {
   return wayland != nullptr && wayland[0] != '\0';
 }
 
-bool x11DisplayAvailable() {
+bool x11DisplayAvailable(const std::string& name) {
+  if (!name.empty()) return true;
   const char* display = std::getenv("DISPLAY");
   return display != nullptr && display[0] != '\0';
 }
@@ -28,7 +31,9 @@ Capabilities x11Capabilities() {
   c.canWarpCursor = true;
   c.canReadCursorPosition = true;
   c.supportsExtraMouseButtons = true;
-  c.supportsHighResolutionScroll = false;  // Core wheel is discrete buttons.
+  // Probed per server by X11PlatformBackend (XI2 scroll valuators); the core
+  // wheel alone is discrete buttons.
+  c.supportsHighResolutionScroll = false;
   c.canCaptureScreen = true;
   c.canEnumerateMonitors = true;
   c.canRecordEvents = true;  // Via XRecord, if the extension is present.
@@ -37,37 +42,56 @@ Capabilities x11Capabilities() {
   return c;
 }
 
-Capabilities uinputCapabilities() {
+Capabilities xcbCapabilities() {
+  Capabilities c = x11Capabilities();
+  c.backendName = "Linux XCB/XTest";
+  // Wheel notches only; the XI2 scroll valuators are driven through Xlib.
+  c.supportsHighResolutionScroll = false;
+  return c;
+}
+
+Capabilities uinputCapabilities(const bool absolutePointer) {
   Capabilities c;
   c.backendName = "Linux uinput";
   c.canInjectKeyboard = true;
   c.canInjectMouse = true;
   c.canTypeUnicode = false;       // No layout knowledge at the kernel level.
-  c.canWarpCursor = false;        // Relative motion only.
-  c.canReadCursorPosition = false;
+  // Both hinge on the absolute pointer device; the position read is the last
+  // warp target, not a compositor query.
+  c.canWarpCursor = absolutePointer;
+  c.canReadCursorPosition = absolutePointer;
   c.supportsExtraMouseButtons = true;
-  c.supportsHighResolutionScroll = false;
+  c.supportsHighResolutionScroll = true;  // REL_WHEEL_HI_RES.
   c.canCaptureScreen = false;
   c.canEnumerateMonitors = false;
-  c.canRecordEvents = false;
+  // From /dev/input/event*; start() reports PermissionDenied without read
+  // access to the devices.
+  c.canRecordEvents = true;
   c.requiresAccessibilityPermission = false;
   c.requiresScreenRecordingPermission = false;
   return c;
 }
 
-std::expected<std::unique_ptr<IPlatformBackend>, Error> makeX11() {
-  auto connection = x11::X11Connection::open();
-  if (!connection) return std::unexpected(connection.error());
+std::expected<std::unique_ptr<IPlatformBackend>, Error> makeX11(
+    const std::string& display, const X11TapSource tapSource
+) {
+  auto input = x11::X11Connection::open(display);
+  if (!input) return std::unexpected(input.error());
+  auto capture = x11::X11Connection::open(display);
+  if (!capture) return std::unexpected(capture.error());
   return std::make_unique<linux_backend::X11PlatformBackend>(
-      std::move(*connection), x11Capabilities()
+      std::move(*input), std::move(*capture), x11Capabilities(), tapSource
   );
 }
 
-std::expected<std::unique_ptr<IPlatformBackend>, Error> makeUinput() {
-  auto device = linux_uinput::UinputBackend::create();
+std::expected<std::unique_ptr<IPlatformBackend>, Error> makeUinput(
+    const LogicalRect desktop, const bool grabDevices
+) {
+  auto device = linux_uinput::UinputBackend::create(desktop);
   if (!device) return std::unexpected(device.error());
+  const bool absolute = (*device)->hasAbsolutePointer();
   return std::make_unique<linux_backend::UinputPlatformBackend>(
-      std::move(*device), uinputCapabilities()
+      std::move(*device), uinputCapabilities(absolute), grabDevices
   );
 }
 
@@ -79,9 +103,13 @@ std::expected<std::unique_ptr<IPlatformBackend>, Error> createPlatformBackend(
   // Explicit backend selection always wins and is never second-guessed.
   switch (options.linuxBackend) {
     case LinuxBackend::X11:
-      return makeX11();
+      return makeX11(options.x11Display, options.x11TapSource);
     case LinuxBackend::Uinput:
-      return makeUinput();
+      return makeUinput(options.uinputDesktop, options.evdevGrab);
+    case LinuxBackend::Xcb:
+      return linux_backend::makeXcbBackend(
+          options.x11Display, xcbCapabilities(), options.x11TapSource
+      );
     case LinuxBackend::Auto:
       break;
   }
@@ -89,8 +117,9 @@ std::expected<std::unique_ptr<IPlatformBackend>, Error> createPlatformBackend(
   // Auto: prefer X11 when an X server is reachable. This includes Xwayland, so a
   // Wayland desktop that runs Xwayland still gets full XTest behaviour for X11
   // and Xwayland clients.
-  if (x11DisplayAvailable()) {
-    if (auto x11 = makeX11(); x11) return x11;
+  if (x11DisplayAvailable(options.x11Display)) {
+    auto x11 = makeX11(options.x11Display, options.x11TapSource);
+    if (x11) return x11;
     // DISPLAY was set but the connection failed; fall through to the diagnostics
     // below rather than masking the real environment problem.
   }
@@ -105,7 +134,7 @@ std::expected<std::unique_ptr<IPlatformBackend>, Error> createPlatformBackend(
         "warp the cursor, or capture the screen. Options: run under Xwayland "
         "(set DISPLAY), or construct the Session with "
         "LinuxBackend::Uinput for kernel-level input injection (needs "
-        "/dev/uinput access; no cursor warp, pointer read, or capture)."
+        "/dev/uinput access; no screen capture or Unicode text)."
     ));
   }
 
@@ -70,4 +70,14 @@ std::optional<std::uint16_t> keyToEvdev(const Key key) {
   return it->second;
 }
 
+std::optional<Key> evdevToKey(const std::uint16_t code) {
+  static const std::array<std::optional<Key>, KEY_CNT> keys = [] {
+    std::array<std::optional<Key>, KEY_CNT> a{};
+    for (const auto& [k, c] : kTable) a[c] = k;
+    return a;
+  }();
+  if (code >= keys.size()) return std::nullopt;
+  return keys[code];
+}
+
 }  // namespace robot::linux_evdev
@@ -5,12 +5,16 @@
 
 #include "robot/Key.h"
 
-// Linux/uinput internal: physical Key -> evdev KEY_* code. evdev keycodes are the
-// kernel's own numbering (Linux input event codes), distinct from both HID usages
-// and X keysyms, so a dedicated table is required. nullopt for keys with no
-// evdev equivalent.
+// Linux/uinput internal: physical Key <-> evdev KEY_* code. evdev keycodes are
+// the kernel's own numbering (Linux input event codes), distinct from both HID
+// usages and X keysyms, so a dedicated table is required. nullopt for keys with
+// no equivalent on the other side.
 namespace robot::linux_evdev {
 
 std::optional<std::uint16_t> keyToEvdev(Key key);
 
+// The inverse, for the evdev event tap. A flat lookup indexed by code, since it
+// runs once per key event read from the kernel.
+std::optional<Key> evdevToKey(std::uint16_t code);
+
 }  // namespace robot::linux_evdev
\ No newline at end of file
@@ -0,0 +1,51 @@
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#include <cerrno>
+#include <chrono>
+
+#include "common/Pacing.h"
+
+// Linux pacing primitives. steady_clock is CLOCK_MONOTONIC here, so a deadline
+// converts to an absolute clock_nanosleep target directly: no relative-sleep
+// arithmetic for the kernel's timer slack to compound.
+namespace robot::pacing {
+
+void sleepUntil(const Clock::time_point deadline) {
+  using std::chrono::duration_cast;
+  using std::chrono::nanoseconds;
+  using std::chrono::seconds;
+  const auto sinceEpoch = deadline.time_since_epoch();
+  const auto whole = duration_cast<seconds>(sinceEpoch);
+  timespec target{};
+  target.tv_sec = static_cast<time_t>(whole.count());
+  target.tv_nsec = static_cast<long>(
+      duration_cast<nanoseconds>(sinceEpoch - whole).count()
+  );
+  while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &target, nullptr) ==
+         EINTR) {
+  }
+}
+
+ScopedPriorityBoost::ScopedPriorityBoost(const bool enable) {
+  if (!enable) return;
+  sched_param saved{};
+  if (pthread_getschedparam(pthread_self(), &savedPolicy_, &saved) != 0) return;
+  savedPriority_ = saved.sched_priority;
+
+  // The lowest real-time priority already pre-empts every normal thread; going
+  // higher would only compete with the kernel's own real-time threads.
+  sched_param boosted{};
+  boosted.sched_priority = sched_get_priority_min(SCHED_FIFO);
+  raised_ = pthread_setschedparam(pthread_self(), SCHED_FIFO, &boosted) == 0;
+}
+
+ScopedPriorityBoost::~ScopedPriorityBoost() {
+  if (!raised_) return;
+  sched_param saved{};
+  saved.sched_priority = savedPriority_;
+  pthread_setschedparam(pthread_self(), savedPolicy_, &saved);
+}
+
+}  // namespace robot::pacing
@@ -1,5 +1,6 @@
 #include "LinuxPlatformBackend.h"
 
+#include <string>
 #include <utility>
 
 #include "NullScreenBackend.h"
@@ -7,20 +8,37 @@
 namespace robot::linux_backend {
 
 X11PlatformBackend::X11PlatformBackend(
-    x11::X11Connection connection, Capabilities capabilities
+    x11::X11Connection input, x11::X11Connection capture,
+    Capabilities capabilities, const X11TapSource tapSource
 )
-    : connection_(std::move(connection)),
+    : input_(std::move(input)),
+      capture_(std::move(capture)),
       capabilities_(std::move(capabilities)),
-      keyboard_(std::make_unique<x11::X11KeyboardBackend>(connection_)),
-      mouse_(std::make_unique<x11::X11MouseBackend>(connection_)),
-      screen_(std::make_unique<x11::X11ScreenBackend>(connection_)),
-      eventTap_(std::make_unique<x11::X11EventTapBackend>()) {}
+      keyboard_(std::make_unique<x11::X11KeyboardBackend>(input_)),
+      mouse_(std::make_unique<x11::X11MouseBackend>(input_)),
+      screen_(std::make_unique<x11::X11ScreenBackend>(capture_)) {
+  // The tap opens its own connections, to the same display.
+  std::string display = DisplayString(input_.display());
+  if (tapSource == X11TapSource::RawInput) {
+    eventTap_ =
+        std::make_unique<x11::X11RawEventTapBackend>(std::move(display));
+  } else {
+    eventTap_ = std::make_unique<x11::X11EventTapBackend>(std::move(display));
+  }
+  // Only known once the mouse backend has probed the server's XI2 devices.
+  capabilities_.supportsHighResolutionScroll =
+      mouse_->supportsHighResolutionScroll();
+}
 
 UinputPlatformBackend::UinputPlatformBackend(
-    std::unique_ptr<linux_uinput::UinputBackend> device, Capabilities capabilities
+    std::unique_ptr<linux_uinput::UinputBackend> device,
+    Capabilities capabilities, const bool grabDevices
 )
     : device_(std::move(device)),
       screen_(std::make_unique<NullScreenBackend>()),
+      eventTap_(std::make_unique<linux_evdev::EvdevEventTapBackend>(
+          device_->desktop(), grabDevices
+      )),
       capabilities_(std::move(capabilities)) {}
 
 }  // namespace robot::linux_backend
\ No newline at end of file
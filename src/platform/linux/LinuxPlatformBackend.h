@@ -2,22 +2,32 @@
 
 #include <memory>
 
+#include "EvdevEventTapBackend.h"
 #include "UinputBackend.h"
 #include "X11Display.h"
 #include "X11EventTapBackend.h"
 #include "X11KeyboardBackend.h"
 #include "X11MouseBackend.h"
+#include "X11RawEventTapBackend.h"
 #include "X11ScreenBackend.h"
+#include "robot/Session.h"
 #include "robot/backend/IPlatformBackend.h"
 
 namespace robot::linux_backend {
 
-// The X11 platform assembly: owns the shared connection and the four X11 sub-
+// The X11 platform assembly: owns the connections and the four X11 sub-
 // backends. Constructed only after the factory has verified an X server is
-// reachable, so its sub-backends can assume a valid connection.
+// reachable, so its sub-backends can assume a valid connection. Keyboard and
+// mouse share the injection connection; the screen has its own, so capture
+// and injection from different threads run in parallel (see X11Connection).
+// The tap is XRecord or XInput2 raw events, as SessionOptions::x11TapSource
+// selects, and opens connections of its own.
 class X11PlatformBackend final : public backend::IPlatformBackend {
  public:
-  X11PlatformBackend(x11::X11Connection connection, Capabilities capabilities);
+  X11PlatformBackend(
+      x11::X11Connection input, x11::X11Connection capture,
+      Capabilities capabilities, X11TapSource tapSource
+  );
 
   backend::IKeyboardBackend& keyboard() override { return *keyboard_; }
   backend::IMouseBackend& mouse() override { return *mouse_; }
@@ -26,34 +36,38 @@ class X11PlatformBackend final : public backend::IPlatformBackend {
   const Capabilities& capabilities() const override { return capabilities_; }
 
  private:
-  x11::X11Connection connection_;
+  x11::X11Connection input_;
+  x11::X11Connection capture_;
   Capabilities capabilities_;
   std::unique_ptr<x11::X11KeyboardBackend> keyboard_;
   std::unique_ptr<x11::X11MouseBackend> mouse_;
   std::unique_ptr<x11::X11ScreenBackend> screen_;
-  std::unique_ptr<x11::X11EventTapBackend> eventTap_;
+  std::unique_ptr<backend::IEventTapBackend> eventTap_;
 };
 
 // The uinput platform assembly: kernel-level injection that works under Wayland
-// but has no capture, no absolute cursor, and no monitor enumeration. Those
+// but has no capture and no monitor enumeration. Those
 // missing abilities are reported in Capabilities and return Unsupported when
-// called; screen()/eventTap() are backed by a null-capability screen and no tap.
+// called; screen() is backed by a null-capability screen. Recording reads the
+// kernel's input devices directly (EvdevEventTapBackend), over the same
+// desktop the absolute pointer spans.
 class UinputPlatformBackend final : public backend::IPlatformBackend {
  public:
   UinputPlatformBackend(
       std::unique_ptr<linux_uinput::UinputBackend> device,
-      Capabilities capabilities
+      Capabilities capabilities, bool grabDevices
   );
 
   backend::IKeyboardBackend& keyboard() override { return *device_; }
   backend::IMouseBackend& mouse() override { return *device_; }
   backend::IScreenBackend& screen() override { return *screen_; }
-  backend::IEventTapBackend* eventTap() override { return nullptr; }
+  backend::IEventTapBackend* eventTap() override { return eventTap_.get(); }
   const Capabilities& capabilities() const override { return capabilities_; }
 
  private:
   std::unique_ptr<linux_uinput::UinputBackend> device_;
   std::unique_ptr<backend::IScreenBackend> screen_;
+  std::unique_ptr<linux_evdev::EvdevEventTapBackend> eventTap_;
   Capabilities capabilities_;
 };
 
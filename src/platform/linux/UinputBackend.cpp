@@ -4,28 +4,28 @@
 #include <linux/uinput.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <array>
+#include <charconv>
 #include <cmath>
 #include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <memory>
+#include <string>
 
+#include "EvdevBatch.h"
 #include "LinuxEvdevKeymap.h"  // Key -> evdev KEY_* codes (declared below).
 
 namespace robot::linux_uinput {
 namespace {
 
-std::expected<void, Error> writeEvent(
-    const int fd, const std::uint16_t type, const std::uint16_t code,
-    const std::int32_t value
-) {
-  input_event ev{};
-  ev.type = type;
-  ev.code = code;
-  ev.value = value;
-  if (write(fd, &ev, sizeof(ev)) != static_cast<ssize_t>(sizeof(ev))) {
-    return std::unexpected(Error::platformError("write to /dev/uinput"));
-  }
-  return {};
-}
+// High-resolution wheel axes count 120 units per notch (the Windows WHEEL_DELTA
+// convention the kernel adopted). Pixel deltas are converted at libinput's
+// 15 units of axis motion per notch, which Wayland clients scroll as surface
+// pixels; the compositor's own scroll-speed setting applies on top.
+constexpr double kHiResPerNotch = 120.0;
+constexpr double kPixelsPerNotch = 15.0;
 
 std::uint16_t evdevButton(const MouseButton b) {
   switch (b) {
@@ -38,9 +38,104 @@ std::uint16_t evdevButton(const MouseButton b) {
   return BTN_LEFT;
 }
 
+// Name and identify the device before UI_DEV_CREATE. False if the kernel
+// rejects the setup.
+bool setupDevice(
+    const int fd, const char* name, const std::uint16_t product
+) {
+  uinput_setup setup{};
+  setup.id.bustype = BUS_USB;
+  setup.id.vendor = 0x1;
+  setup.id.product = product;
+  std::strncpy(setup.name, name, UINPUT_MAX_NAME_SIZE - 1);
+  return ioctl(fd, UI_DEV_SETUP, &setup) >= 0;
+}
+
+// Width and height of a connected connector's preferred mode: the first line
+// of the sysfs `modes` file, e.g. "2560x1440". sysfs does not expose the
+// active mode, so an output running below its preferred one is overstated;
+// pass the desktop explicitly in that case.
+std::optional<LogicalSize> connectorMode(const std::filesystem::path& dir) {
+  std::ifstream status(dir / "status");
+  std::string state;
+  if (!(status >> state) || state != "connected") return std::nullopt;
+
+  std::ifstream modes(dir / "modes");
+  std::string line;
+  if (!std::getline(modes, line)) return std::nullopt;
+  const auto x = line.find('x');
+  if (x == std::string::npos) return std::nullopt;
+  int w = 0;
+  int h = 0;
+  const char* end = line.data() + line.size();
+  if (std::from_chars(line.data(), line.data() + x, w).ec != std::errc{} ||
+      std::from_chars(line.data() + x + 1, end, h).ec != std::errc{} || w <= 0 ||
+      h <= 0) {
+    return std::nullopt;
+  }
+  return LogicalSize{static_cast<double>(w), static_cast<double>(h)};
+}
+
+// Connected outputs placed side by side: widths add up, the tallest sets the
+// height. That is the default layout of every mainstream compositor; anything
+// else must be passed explicitly.
+LogicalRect probeDesktop() {
+  LogicalRect desktop;
+  std::error_code ec;
+  for (const auto& entry :
+       std::filesystem::directory_iterator("/sys/class/drm", ec)) {
+    if (const auto mode = connectorMode(entry.path())) {
+      desktop.size.width += mode->width;
+      desktop.size.height = std::max(desktop.size.height, mode->height);
+    }
+  }
+  return desktop;
+}
+
+// The absolute pointer: ABS_X/ABS_Y spanning the desktop in logical units,
+// plus BTN_LEFT so the compositor classifies it as a pointer rather than a
+// joystick. Buttons are still sent on the main device. -1 on any failure.
+int createAbsolutePointer(const LogicalRect desktop) {
+  const int fd = open("/dev/uinput", O_WRONLY | O_NONBLOCK);
+  if (fd < 0) return -1;
+
+  ioctl(fd, UI_SET_EVBIT, EV_ABS);
+  ioctl(fd, UI_SET_EVBIT, EV_KEY);
+  ioctl(fd, UI_SET_EVBIT, EV_SYN);
+  ioctl(fd, UI_SET_ABSBIT, ABS_X);
+  ioctl(fd, UI_SET_ABSBIT, ABS_Y);
+  ioctl(fd, UI_SET_KEYBIT, BTN_LEFT);
+  if (!setupDevice(fd, "robot-cpp virtual pointer", 0x2)) {
+    close(fd);
+    return -1;
+  }
+
+  const std::array<std::pair<std::uint16_t, double>, 2> axes{{
+      {ABS_X, desktop.size.width},
+      {ABS_Y, desktop.size.height},
+  }};
+  for (const auto& [code, extent] : axes) {
+    uinput_abs_setup abs{};
+    abs.code = code;
+    abs.absinfo.minimum = 0;
+    abs.absinfo.maximum = static_cast<std::int32_t>(std::lround(extent)) - 1;
+    if (ioctl(fd, UI_ABS_SETUP, &abs) < 0) {
+      close(fd);
+      return -1;
+    }
+  }
+  if (ioctl(fd, UI_DEV_CREATE) < 0) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
 }  // namespace
 
-std::expected<std::unique_ptr<UinputBackend>, Error> UinputBackend::create() {
+std::expected<std::unique_ptr<UinputBackend>, Error> UinputBackend::create(
+    LogicalRect desktop
+) {
   const int fd = open("/dev/uinput", O_WRONLY | O_NONBLOCK);
   if (fd < 0) {
     return std::unexpected(Error::permissionDenied(
@@ -59,6 +154,8 @@ std::expected<std::unique_ptr<UinputBackend>, Error> UinputBackend::create() {
   ioctl(fd, UI_SET_RELBIT, REL_Y);
   ioctl(fd, UI_SET_RELBIT, REL_WHEEL);
   ioctl(fd, UI_SET_RELBIT, REL_HWHEEL);
+  ioctl(fd, UI_SET_RELBIT, REL_WHEEL_HI_RES);
+  ioctl(fd, UI_SET_RELBIT, REL_HWHEEL_HI_RES);
   for (int code = 0; code < KEY_MAX; ++code) {
     ioctl(fd, UI_SET_KEYBIT, code);
   }
@@ -68,32 +165,42 @@ std::expected<std::unique_ptr<UinputBackend>, Error> UinputBackend::create() {
   ioctl(fd, UI_SET_KEYBIT, BTN_SIDE);
   ioctl(fd, UI_SET_KEYBIT, BTN_EXTRA);
 
-  uinput_setup setup{};
-  setup.id.bustype = BUS_USB;
-  setup.id.vendor = 0x1;
-  setup.id.product = 0x1;
-  std::strncpy(setup.name, "robot-cpp virtual input", UINPUT_MAX_NAME_SIZE - 1);
-
-  if (ioctl(fd, UI_DEV_SETUP, &setup) < 0 || ioctl(fd, UI_DEV_CREATE) < 0) {
+  if (!setupDevice(fd, "robot-cpp virtual input", 0x1) ||
+      ioctl(fd, UI_DEV_CREATE) < 0) {
     close(fd);
     return std::unexpected(Error::platformError("UI_DEV_SETUP / UI_DEV_CREATE"));
   }
 
-  return std::unique_ptr<UinputBackend>(new UinputBackend(fd));
+  // The absolute pointer is best effort: without an extent, or if the kernel
+  // rejects it, the backend stays relative-only and reports that through
+  // hasAbsolutePointer() and the capabilities built from it.
+  if (desktop.size.width <= 0.0 || desktop.size.height <= 0.0) {
+    desktop = probeDesktop();
+  }
+  int absFd = -1;
+  if (desktop.size.width >= 1.0 && desktop.size.height >= 1.0) {
+    absFd = createAbsolutePointer(desktop);
+  }
+
+  return std::unique_ptr<UinputBackend>(new UinputBackend(fd, absFd, desktop));
 }
 
 UinputBackend::~UinputBackend() {
-  if (fd_ >= 0) {
-    ioctl(fd_, UI_DEV_DESTROY);
-    close(fd_);
+  for (const int fd : {absFd_, fd_}) {
+    if (fd >= 0) {
+      ioctl(fd, UI_DEV_DESTROY);
+      close(fd);
+    }
   }
 }
 
 std::expected<void, Error> UinputBackend::emit(
     const std::uint16_t type, const std::uint16_t code, const std::int32_t value
 ) {
-  if (auto r = writeEvent(fd_, type, code, value); !r) return r;
-  return writeEvent(fd_, EV_SYN, SYN_REPORT, 0);
+  EvdevBatch batch(fd_);
+  if (auto r = batch.add(type, code, value); !r) return r;
+  if (auto r = batch.sync(); !r) return r;
+  return batch.flush();
 }
 
 std::expected<void, Error> UinputBackend::keyDown(const Key key) {
@@ -108,6 +215,44 @@ std::expected<void, Error> UinputBackend::keyUp(const Key key) {
   return emit(EV_KEY, *code, 0);
 }
 
+std::expected<void, Error> UinputBackend::keySequence(
+    const std::span<const KeyTransition> transitions
+) {
+  // Map everything first, so an unmappable key fails the sequence before any
+  // event reaches the kernel.
+  for (const KeyTransition& t : transitions) {
+    if (!linux_evdev::keyToEvdev(t.key)) {
+      return std::unexpected(Error::unmappableInput(toString(t.key)));
+    }
+  }
+
+  // Each transition is its own report so the order survives as separate
+  // frames; all of them share as few writes as the buffer allows.
+  EvdevBatch batch(fd_);
+  std::expected<void, Error> result;
+  for (const KeyTransition& t : transitions) {
+    const std::uint16_t code = *linux_evdev::keyToEvdev(t.key);
+    result = batch.add(EV_KEY, code, t.down ? 1 : 0);
+    if (result) result = batch.sync();
+    if (!result) break;
+  }
+  if (result) result = batch.flush();
+  if (result) return result;
+
+  // A failed write may have landed part of the sequence. Releasing a key that
+  // is not down is filtered by the input core, so release every pressed key.
+  EvdevBatch release(fd_);
+  for (const KeyTransition& t : transitions) {
+    if (!t.down) continue;
+    if (!release.add(EV_KEY, *linux_evdev::keyToEvdev(t.key), 0) ||
+        !release.sync()) {
+      break;
+    }
+  }
+  (void)release.flush();
+  return result;
+}
+
 std::expected<void, Error> UinputBackend::typeUnicode(char32_t /*codepoint*/) {
   // uinput carries no layout, so mapping a Unicode scalar to a keycode sequence
   // is not possible here. Reported rather than approximated.
@@ -116,17 +261,49 @@ std::expected<void, Error> UinputBackend::typeUnicode(char32_t /*codepoint*/) {
   ));
 }
 
-std::expected<void, Error> UinputBackend::warpCursor(LogicalPoint /*point*/) {
-  return std::unexpected(Error::unsupported(
-      "absolute cursor positioning is unavailable through uinput (relative "
-      "motion only)"
-  ));
+std::expected<void, Error> UinputBackend::warpCursor(const LogicalPoint point) {
+  if (absFd_ < 0) {
+    return std::unexpected(Error::unsupported(
+        "absolute cursor positioning through uinput needs the desktop extent; "
+        "set SessionOptions::uinputDesktop"
+    ));
+  }
+
+  // Points outside the desktop pin to its edge, as a real cursor would.
+  const auto axis = [](const double v, const double origin, const double extent) {
+    const double max = std::max(std::round(extent) - 1.0, 0.0);
+    return static_cast<std::int32_t>(std::clamp(std::round(v - origin), 0.0, max));
+  };
+  const std::int32_t x = axis(point.x, desktop_.origin.x, desktop_.size.width);
+  const std::int32_t y = axis(point.y, desktop_.origin.y, desktop_.size.height);
+
+  // Both axes and the SYN go out as one report in a single write, so the
+  // compositor never sees a half-applied move. The lock spans the write and
+  // the update, so concurrent warps leave position_ at the one written last.
+  const std::lock_guard lock(mutex_);
+  EvdevBatch batch(absFd_);
+  if (auto r = batch.add(EV_ABS, ABS_X, x); !r) return r;
+  if (auto r = batch.add(EV_ABS, ABS_Y, y); !r) return r;
+  if (auto r = batch.sync(); !r) return r;
+  if (auto r = batch.flush(); !r) return r;
+  position_ = LogicalPoint{
+      desktop_.origin.x + static_cast<double>(x),
+      desktop_.origin.y + static_cast<double>(y),
+  };
+  return {};
 }
 
 std::expected<LogicalPoint, Error> UinputBackend::cursorPosition() {
-  return std::unexpected(Error::unsupported(
-      "reading the global pointer position is unavailable through uinput"
-  ));
+  const std::lock_guard lock(mutex_);
+  if (!position_) {
+    return std::unexpected(Error::unsupported(
+        absFd_ < 0 ? "reading the global pointer position is unavailable "
+                     "through uinput"
+                   : "uinput cannot query the pointer; its position is known "
+                     "only after the first warp"
+    ));
+  }
+  return *position_;
 }
 
 std::expected<void, Error> UinputBackend::button(
@@ -136,27 +313,53 @@ std::expected<void, Error> UinputBackend::button(
 }
 
 std::expected<void, Error> UinputBackend::scroll(const ScrollDelta delta) {
-  if (delta.unit == ScrollUnit::Pixel) {
-    return std::unexpected(Error::unsupported(
-        "pixel-precise scrolling is unavailable through uinput; use line units"
-    ));
-  }
+  const double unitsPerDelta =
+      delta.unit == ScrollUnit::Pixel ? kHiResPerNotch / kPixelsPerNotch
+                                      : kHiResPerNotch;
+
+  // Both axes share one report: a diagonal scroll is one frame, one write.
+  const std::lock_guard lock(mutex_);
+  EvdevBatch batch(fd_);
+  const std::array<std::pair<double, WheelAxis*>, 2> axes{{
+      {delta.vertical, &wheel_[0]},
+      {delta.horizontal, &wheel_[1]},
+  }};
+  const std::array<std::pair<std::uint16_t, std::uint16_t>, 2> codes{{
+      {REL_WHEEL_HI_RES, REL_WHEEL},
+      {REL_HWHEEL_HI_RES, REL_HWHEEL},
+  }};
+  bool any = false;
+  for (std::size_t i = 0; i < axes.size(); ++i) {
+    const auto [value, axis] = axes[i];
+    if (value == 0.0) continue;
 
-  if (delta.vertical != 0.0) {
-    if (auto r = emit(EV_REL, REL_WHEEL,
-                      static_cast<std::int32_t>(std::lround(delta.vertical)));
-        !r) {
-      return r;
+    // Sub-unit fractions carry into the next call instead of being dropped, so
+    // many small deltas add up to exactly their sum.
+    const double exact = value * unitsPerDelta + axis->fraction;
+    const auto units = static_cast<std::int32_t>(std::lround(exact));
+    axis->fraction = exact - units;
+    if (units == 0) continue;
+
+    // Legacy clients only see whole notches: accumulate hi-res units and emit
+    // a notch per 120, restarting on a direction change as HID mice do.
+    if ((axis->notchUnits > 0 && units < 0) ||
+        (axis->notchUnits < 0 && units > 0)) {
+      axis->notchUnits = 0;
     }
-  }
-  if (delta.horizontal != 0.0) {
-    if (auto r = emit(EV_REL, REL_HWHEEL,
-                      static_cast<std::int32_t>(std::lround(delta.horizontal)));
-        !r) {
-      return r;
+    axis->notchUnits += units;
+    const std::int32_t notches =
+        axis->notchUnits / static_cast<std::int32_t>(kHiResPerNotch);
+    axis->notchUnits -= notches * static_cast<std::int32_t>(kHiResPerNotch);
+
+    if (auto r = batch.add(EV_REL, codes[i].first, units); !r) return r;
+    if (notches != 0) {
+      if (auto r = batch.add(EV_REL, codes[i].second, notches); !r) return r;
     }
+    any = true;
   }
-  return {};
+  if (!any) return {};
+  if (auto r = batch.sync(); !r) return r;
+  return batch.flush();
 }
 
 }  // namespace robot::linux_uinput
@@ -1,6 +1,10 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <memory>
+#include <mutex>
+#include <optional>
 
 #include "robot/backend/IKeyboardBackend.h"
 #include "robot/backend/IMouseBackend.h"
@@ -15,23 +19,42 @@ namespace robot::linux_uinput {
 //
 //   * It requires write access to /dev/uinput (root, or an appropriate udev rule
 //     / input group). Open failure is a hard PermissionDenied.
-//   * It injects RELATIVE pointer motion. There is no absolute-cursor-warp and no
-//     way to read the global pointer position through uinput, so warpCursor and
-//     cursorPosition return Unsupported. Absolute positioning would require the
-//     compositor's cooperation, which uinput does not have.
+//   * Pointer warps go through a second virtual device advertising EV_ABS
+//     ABS_X/ABS_Y, whose axis range is the desktop extent in logical units.
+//     The compositor scales that range onto its output layout, so the extent
+//     must match the layout (see SessionOptions::uinputDesktop). With no
+//     usable extent the absolute device is not created and warpCursor returns
+//     Unsupported.
+//   * There is no way to read the global pointer position through uinput.
+//     cursorPosition answers with the last position this backend warped to, so
+//     it does not see motion from physical devices, and it fails until the
+//     first warp.
+//   * Scrolling uses the high-resolution wheel axes (120 units per notch), so
+//     fractional line and pixel deltas are exact; whole notches are also sent
+//     on the legacy axes for clients that ignore the high-resolution ones.
 //   * Keys are emitted as evdev keycodes; text is produced by mapping Unicode to
 //     a key sequence is NOT attempted here (that needs layout knowledge uinput
 //     does not carry), so typeUnicode reports Unsupported and callers use
 //     physical keys.
 //
-// One class implements both keyboard and mouse because they share the single
-// virtual device fd.
+// One class implements both keyboard and mouse because they share the virtual
+// devices: keys, buttons, relative motion and wheel on one, absolute motion on
+// the other (kept separate so the compositor classifies neither as a tablet).
 class UinputBackend final : public backend::IKeyboardBackend,
                             public backend::IMouseBackend {
  public:
-  static std::expected<std::unique_ptr<UinputBackend>, Error> create();
+  // desktop is the absolute pointer's extent; an empty size probes it from
+  // /sys/class/drm, and if that finds nothing the backend is relative-only.
+  static std::expected<std::unique_ptr<UinputBackend>, Error> create(
+      LogicalRect desktop = {}
+  );
   ~UinputBackend() override;
 
+  // Whether the absolute pointer device exists, i.e. warps are supported.
+  [[nodiscard]] bool hasAbsolutePointer() const { return absFd_ >= 0; }
+  // The absolute pointer's extent, as given or probed; empty if unknown.
+  [[nodiscard]] LogicalRect desktop() const { return desktop_; }
+
   UinputBackend(const UinputBackend&) = delete;
   UinputBackend& operator=(const UinputBackend&) = delete;
 
@@ -39,6 +62,11 @@ class UinputBackend final : public backend::IKeyboardBackend,
   std::expected<void, Error> keyDown(Key key) override;
   std::expected<void, Error> keyUp(Key key) override;
   std::expected<void, Error> typeUnicode(char32_t codepoint) override;
+  // The whole sequence goes out in one write (per EvdevBatch::kCapacity
+  // events) instead of two writes per transition.
+  std::expected<void, Error> keySequence(
+      std::span<const KeyTransition> transitions
+  ) override;
 
   // Mouse.
   std::expected<void, Error> warpCursor(LogicalPoint point) override;
@@ -49,12 +77,28 @@ class UinputBackend final : public backend::IKeyboardBackend,
   std::expected<void, Error> scroll(ScrollDelta delta) override;
 
  private:
-  explicit UinputBackend(int fd) : fd_(fd) {}
+  UinputBackend(int fd, int absFd, LogicalRect desktop)
+      : fd_(fd), absFd_(absFd), desktop_(desktop) {}
   std::expected<void, Error> emit(
       std::uint16_t type, std::uint16_t code, std::int32_t value
   );
 
+  // Per-axis wheel state: the sub-unit fraction not yet emitted, and the
+  // high-resolution units not yet worth a legacy notch.
+  struct WheelAxis {
+    double fraction = 0.0;
+    std::int32_t notchUnits = 0;
+  };
+
   int fd_ = -1;
+  int absFd_ = -1;
+  LogicalRect desktop_;
+  // Every report is written whole in one write(), which the kernel applies
+  // atomically. The lock guards the state below; writes that update it are
+  // made under it, so the state follows the order the reports went out in.
+  std::mutex mutex_;
+  std::array<WheelAxis, 2> wheel_{};  // Vertical, horizontal.
+  std::optional<LogicalPoint> position_;
 };
 
 }  // namespace robot::linux_uinput
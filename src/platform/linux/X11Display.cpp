@@ -4,8 +4,15 @@
 
 namespace robot::x11 {
 
-std::expected<X11Connection, Error> X11Connection::open() {
-  Display* display = XOpenDisplay(nullptr);
+std::expected<X11Connection, Error> X11Connection::open(
+    const std::string& name
+) {
+  Display* display = XOpenDisplay(name.empty() ? nullptr : name.c_str());
+  if (display == nullptr && !name.empty()) {
+    return std::unexpected(
+        Error::backendUnavailable("cannot open X display " + name)
+    );
+  }
   if (display == nullptr) {
     return std::unexpected(Error::backendUnavailable(
         "cannot open an X display (no X server, or a Wayland session without "
@@ -16,7 +23,9 @@ std::expected<X11Connection, Error> X11Connection::open() {
 }
 
 X11Connection::X11Connection(Display* display)
-    : display_(display), root_(DefaultRootWindow(display)) {}
+    : display_(display),
+      root_(DefaultRootWindow(display)),
+      mutex_(std::make_unique<std::mutex>()) {}
 
 X11Connection::~X11Connection() {
   if (display_ != nullptr) XCloseDisplay(display_);
@@ -24,13 +33,15 @@ X11Connection::~X11Connection() {
 
 X11Connection::X11Connection(X11Connection&& other) noexcept
     : display_(std::exchange(other.display_, nullptr)),
-      root_(std::exchange(other.root_, 0)) {}
+      root_(std::exchange(other.root_, 0)),
+      mutex_(std::move(other.mutex_)) {}
 
 X11Connection& X11Connection::operator=(X11Connection&& other) noexcept {
   if (this != &other) {
     if (display_ != nullptr) XCloseDisplay(display_);
     display_ = std::exchange(other.display_, nullptr);
     root_ = std::exchange(other.root_, 0);
+    mutex_ = std::move(other.mutex_);
   }
   return *this;
 }
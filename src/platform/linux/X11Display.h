@@ -3,20 +3,31 @@
 #include <X11/Xlib.h>
 
 #include <expected>
+#include <memory>
+#include <mutex>
+#include <string>
 
 #include "robot/Error.h"
 
 namespace robot::x11 {
 
-// A shared, reference-counted-by-ownership connection to the X server. One
-// Display* is opened per session and handed to each X11 sub-backend by reference;
-// none of them owns it. Opening fails cleanly with a specific Error when no X
-// server is reachable (for example a pure Wayland session with no Xwayland, or a
+// A connection to the X server, owned by the platform backend and handed to
+// the X11 sub-backends by reference; none of them owns it. A session opens two:
+// one for injection, shared by keyboard and mouse so their events stay in
+// order, and one for screen capture, so a capture never waits behind injection
+// or the reverse. Opening fails cleanly with a specific Error when no X server
+// is reachable (for example a pure Wayland session with no Xwayland, or a
 // headless environment), which the factory turns into an honest capability
 // result rather than a crash.
+//
+// Xlib is not thread-safe per Display unless XInitThreads() ran before any
+// other call, which a library cannot arrange for its host process. Each use of
+// display() from a sub-backend therefore holds lock() for the whole request
+// sequence, so any thread may call into a Session.
 class X11Connection {
  public:
-  static std::expected<X11Connection, Error> open();
+  // An empty name opens $DISPLAY.
+  static std::expected<X11Connection, Error> open(const std::string& name);
 
   ~X11Connection();
   X11Connection(X11Connection&&) noexcept;
@@ -27,11 +38,18 @@ class X11Connection {
   [[nodiscard]] Display* display() const { return display_; }
   [[nodiscard]] Window root() const { return root_; }
 
+  // Exclusive use of display() until the lock is released.
+  [[nodiscard]] std::unique_lock<std::mutex> lock() const {
+    return std::unique_lock(*mutex_);
+  }
+
  private:
   explicit X11Connection(Display* display);
 
   Display* display_ = nullptr;
   Window root_ = 0;
+  // Boxed so the connection stays movable.
+  std::unique_ptr<std::mutex> mutex_;
 };
 
 }  // namespace robot::x11
\ No newline at end of file
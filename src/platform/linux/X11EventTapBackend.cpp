@@ -5,21 +5,78 @@
 #include <X11/extensions/record.h>
 #include <X11/keysym.h>
 
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
 #include "X11Display.h"
 #include "X11KeyMap.h"
+#include "X11ServerClock.h"
+#include "common/TapBatcher.h"
 #include "robot/Event.h"
 
 namespace robot::x11 {
-namespace {
 
 // XRecord hands back raw protocol data; the callback reconstructs high-level
-// events. State lives on the backend, reached through the intercept closure.
+// events. One per open tap, owned by the backend and reached through the
+// intercept closure, so taps on different backends are independent.
 struct TapState {
-  X11EventTapBackend* self = nullptr;
-  Display* lookupDisplay = nullptr;  // For keycode -> keysym translation.
-  EventSink* sink = nullptr;
+  TapState(Display* lookup, EventBatchSink sink, const TapOptions& options)
+      : lookupDisplay(lookup), batcher(std::move(sink), options) {}
+
+  Display* lookupDisplay;  // For keycode -> keysym translation.
+  tap::Batcher batcher;
+  X11ServerClock clock;
 };
 
+namespace {
+
+// The device-event ranges to record for a filter. The core types run
+// KeyPress, KeyRelease, ButtonPress, ButtonRelease, MotionNotify, so adjacent
+// wanted categories merge into one range. Wheel clicks are button events.
+std::vector<std::pair<int, int>> recordRanges(const EventFilter& filter) {
+  const auto wanted = [&](const int type) {
+    switch (type) {
+      case KeyPress:
+      case KeyRelease:
+        return filter.keys;
+      case ButtonPress:
+      case ButtonRelease:
+        return filter.buttons || filter.scroll;
+      default:
+        return filter.motion;
+    }
+  };
+  std::vector<std::pair<int, int>> ranges;
+  for (int type = KeyPress; type <= MotionNotify; ++type) {
+    if (!wanted(type)) continue;
+    if (!ranges.empty() && ranges.back().second == type - 1) {
+      ranges.back().second = type;
+    } else {
+      ranges.emplace_back(type, type);
+    }
+  }
+  return ranges;
+}
+
+// Milliseconds until a batch falls due, rounded up so poll() never wakes
+// early; -1 (wait for record data or stop()) when nothing is buffered.
+int pollTimeout(const tap::Batcher::Clock::time_point due) {
+  if (due == tap::Batcher::Clock::time_point::max()) return -1;
+  const auto wait = due - tap::Batcher::Clock::now();
+  if (wait <= wait.zero()) return 0;
+  const auto ms = std::chrono::ceil<std::chrono::milliseconds>(wait).count();
+  return static_cast<int>(std::min<long long>(ms, INT_MAX));
+}
+
 void interceptCallback(XPointer closure, XRecordInterceptData* data) {
   auto* state = reinterpret_cast<TapState*>(closure);
 
@@ -31,6 +88,12 @@ void interceptCallback(XPointer closure, XRecordInterceptData* data) {
     const std::int16_t rootY = event->u.keyButtonPointer.rootY;
     const LogicalPoint pos{static_cast<double>(rootX),
                            static_cast<double>(rootY)};
+    const auto at = state->clock.map(
+        event->u.keyButtonPointer.time, std::chrono::steady_clock::now()
+    );
+    const auto emit = [&](const InputEvent& e) {
+      state->batcher.push({at, e});
+    };
 
     switch (type) {
       case KeyPress:
@@ -40,7 +103,7 @@ void interceptCallback(XPointer closure, XRecordInterceptData* data) {
         );
         const Key key = keysymToKey(ks);
         if (key != Key::Unknown) {
-          (*state->sink)(KeyEvent{key, type == KeyPress});
+          emit(KeyEvent{key, type == KeyPress});
         }
         break;
       }
@@ -49,32 +112,32 @@ void interceptCallback(XPointer closure, XRecordInterceptData* data) {
         const bool down = type == ButtonPress;
         switch (detail) {
           case 1:
-            (*state->sink)(MouseButtonEvent{MouseButton::Left, down, pos});
+            emit(MouseButtonEvent{MouseButton::Left, down, pos});
             break;
           case 2:
-            (*state->sink)(MouseButtonEvent{MouseButton::Middle, down, pos});
+            emit(MouseButtonEvent{MouseButton::Middle, down, pos});
             break;
           case 3:
-            (*state->sink)(MouseButtonEvent{MouseButton::Right, down, pos});
+            emit(MouseButtonEvent{MouseButton::Right, down, pos});
             break;
           // Wheel arrives as button clicks; emit a scroll on press only.
           case 4:
-            if (down) (*state->sink)(ScrollEvent{ScrollDelta::lines(1, 0), pos});
+            if (down) emit(ScrollEvent{ScrollDelta::lines(1, 0), pos});
             break;
           case 5:
-            if (down) (*state->sink)(ScrollEvent{ScrollDelta::lines(-1, 0), pos});
+            if (down) emit(ScrollEvent{ScrollDelta::lines(-1, 0), pos});
             break;
           case 6:
-            if (down) (*state->sink)(ScrollEvent{ScrollDelta::lines(0, -1), pos});
+            if (down) emit(ScrollEvent{ScrollDelta::lines(0, -1), pos});
             break;
           case 7:
-            if (down) (*state->sink)(ScrollEvent{ScrollDelta::lines(0, 1), pos});
+            if (down) emit(ScrollEvent{ScrollDelta::lines(0, 1), pos});
             break;
           case 8:
-            (*state->sink)(MouseButtonEvent{MouseButton::X1, down, pos});
+            emit(MouseButtonEvent{MouseButton::X1, down, pos});
             break;
           case 9:
-            (*state->sink)(MouseButtonEvent{MouseButton::X2, down, pos});
+            emit(MouseButtonEvent{MouseButton::X2, down, pos});
             break;
           default:
             break;
@@ -82,7 +145,7 @@ void interceptCallback(XPointer closure, XRecordInterceptData* data) {
         break;
       }
       case MotionNotify:
-        (*state->sink)(MouseMoveEvent{pos});
+        emit(MouseMoveEvent{pos});
         break;
       default:
         break;
@@ -92,20 +155,34 @@ void interceptCallback(XPointer closure, XRecordInterceptData* data) {
   if (data != nullptr) XRecordFreeData(data);
 }
 
-TapState g_state;  // One active tap per process, mirroring the hook model.
-
 }  // namespace
 
-std::expected<void, Error> X11EventTapBackend::start(EventSink sink) {
-  sink_ = std::move(sink);
+X11EventTapBackend::X11EventTapBackend(std::string displayName)
+    : displayName_(std::move(displayName)),
+      wake_(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) {}
+
+X11EventTapBackend::~X11EventTapBackend() {
+  if (pollable_) stop();
+  if (wake_ >= 0) ::close(wake_);
+}
+
+std::expected<void, Error> X11EventTapBackend::open(
+    EventBatchSink sink, const TapOptions& options
+) {
+  if (running_.load()) {
+    return std::unexpected(
+        Error::unsupported("the event tap is already running")
+    );
+  }
+  if (wake_ < 0) return std::unexpected(Error::platformError("eventfd"));
+  // Clear a wakeup left by a stop() that raced the previous run's exit.
+  std::uint64_t stale = 0;
+  (void)::read(wake_, &stale, sizeof(stale));
 
-  control_ = XOpenDisplay(nullptr);
-  data_ = XOpenDisplay(nullptr);
+  control_ = XOpenDisplay(displayName_.c_str());
+  data_ = XOpenDisplay(displayName_.c_str());
   if (control_ == nullptr || data_ == nullptr) {
-    if (control_ != nullptr) XCloseDisplay(control_);
-    if (data_ != nullptr) XCloseDisplay(data_);
-    control_ = nullptr;
-    data_ = nullptr;
+    close();
     return std::unexpected(
         Error::backendUnavailable("cannot open X connections for XRecord")
     );
@@ -114,70 +191,121 @@ std::expected<void, Error> X11EventTapBackend::start(EventSink sink) {
   int major = 0;
   int minor = 0;
   if (XRecordQueryVersion(control_, &major, &minor) == 0) {
-    XCloseDisplay(control_);
-    XCloseDisplay(data_);
-    control_ = nullptr;
-    data_ = nullptr;
+    close();
     return std::unexpected(
         Error::unsupported("the X server lacks the RECORD extension")
     );
   }
 
-  XRecordRange* range = XRecordAllocRange();
-  range->device_events.first = KeyPress;
-  range->device_events.last = MotionNotify;
+  // Only the wanted event types cross the wire; the rest of the filter is
+  // applied by the batcher.
+  std::vector<XRecordRange*> ranges;
+  for (const auto& [first, last] : recordRanges(options.filter)) {
+    XRecordRange* range = XRecordAllocRange();
+    range->device_events.first = static_cast<unsigned char>(first);
+    range->device_events.last = static_cast<unsigned char>(last);
+    ranges.push_back(range);
+  }
 
   XRecordClientSpec clients = XRecordAllClients;
-  auto ctx = XRecordCreateContext(control_, 0, &clients, 1, &range, 1);
-  XFree(range);
+  auto ctx = XRecordCreateContext(
+      control_, 0, &clients, 1, ranges.data(), static_cast<int>(ranges.size())
+  );
+  for (XRecordRange* range : ranges) XFree(range);
   if (ctx == 0) {
-    XCloseDisplay(control_);
-    XCloseDisplay(data_);
-    control_ = nullptr;
-    data_ = nullptr;
+    close();
     return std::unexpected(Error::platformError("XRecordCreateContext"));
   }
   context_ = reinterpret_cast<void*>(ctx);
+  state_ = std::make_unique<TapState>(control_, std::move(sink), options);
 
-  g_state = TapState{this, control_, &sink_};
-  running_.store(true);
-
-  // Blocks, delivering events through interceptCallback, until stop() disables
-  // the context from the control connection on another thread.
-  if (XRecordEnableContext(
+  // Enabled asynchronously so the reading thread owns the wait: each
+  // process() hands every buffered reply to interceptCallback.
+  if (XRecordEnableContextAsync(
           data_, ctx, interceptCallback,
-          reinterpret_cast<XPointer>(&g_state)
+          reinterpret_cast<XPointer>(state_.get())
       ) == 0) {
-    running_.store(false);
-    XRecordFreeContext(control_, ctx);
-    XCloseDisplay(control_);
-    XCloseDisplay(data_);
-    control_ = nullptr;
-    data_ = nullptr;
-    context_ = nullptr;
-    return std::unexpected(Error::platformError("XRecordEnableContext"));
+    close();
+    return std::unexpected(Error::platformError("XRecordEnableContextAsync"));
   }
+  running_.store(true);
+  return {};
+}
 
-  running_.store(false);
-  XRecordFreeContext(control_, ctx);
-  XCloseDisplay(control_);
-  XCloseDisplay(data_);
+void X11EventTapBackend::process() { XRecordProcessReplies(data_); }
+
+// Runs on the thread that reads the tap, like every other X call here.
+void X11EventTapBackend::close() {
+  if (context_ != nullptr) {
+    const auto ctx = reinterpret_cast<XRecordContext>(context_);
+    XRecordDisableContext(control_, ctx);
+    XRecordFreeContext(control_, ctx);
+  }
+  if (control_ != nullptr) XCloseDisplay(control_);
+  if (data_ != nullptr) XCloseDisplay(data_);
   control_ = nullptr;
   data_ = nullptr;
   context_ = nullptr;
+  state_.reset();
+}
+
+std::expected<void, Error> X11EventTapBackend::start(
+    EventBatchSink sink, const TapOptions& options
+) {
+  if (auto r = open(std::move(sink), options); !r) return r;
+
+  tap::Batcher& batcher = state_->batcher;
+  std::array<pollfd, 2> fds{{
+      {.fd = ConnectionNumber(data_), .events = POLLIN, .revents = 0},
+      {.fd = wake_, .events = POLLIN, .revents = 0},
+  }};
+  while (running_.load()) {
+    process();
+    batcher.idle(tap::Batcher::Clock::now());
+    (void)poll(fds.data(), fds.size(), pollTimeout(batcher.due()));
+  }
+  process();
+  batcher.flush();
+  close();
   return {};
 }
 
+std::expected<int, Error> X11EventTapBackend::startPollable(
+    EventBatchSink sink, const TapOptions& options
+) {
+  if (auto r = open(std::move(sink), options); !r) {
+    return std::unexpected(r.error());
+  }
+  pollable_ = true;
+  return ConnectionNumber(data_);
+}
+
+std::expected<std::size_t, Error> X11EventTapBackend::dispatch() {
+  if (!pollable_) {
+    return std::unexpected(
+        Error::invalidArgument("dispatch() needs a tap from startPollable()")
+    );
+  }
+  const std::size_t before = state_->batcher.delivered();
+  process();
+  state_->batcher.flush();
+  return state_->batcher.delivered() - before;
+}
+
 void X11EventTapBackend::stop() {
   running_.store(false);
-  // Disabling the context from the control connection causes the blocking
-  // XRecordEnableContext on the data connection to return. XRecordDisableContext
-  // is safe to call from another thread against the control display.
-  if (context_ != nullptr && control_ != nullptr) {
-    XRecordDisableContext(
-        control_, reinterpret_cast<XRecordContext>(context_)
-    );
-    XFlush(control_);
+  // Wakes the poll in start() without touching either connection: start()
+  // may already be closing them, so disabling and freeing the context is
+  // left to its close(). The eventfd outlives every run.
+  const std::uint64_t one = 1;
+  if (wake_ >= 0) (void)::write(wake_, &one, sizeof(one));
+  // No loop to return to in pollable mode: this is the dispatching thread,
+  // so deliver what was read and tear down here.
+  if (pollable_) {
+    pollable_ = false;
+    process();
+    state_->batcher.flush();
+    close();
   }
 }
 
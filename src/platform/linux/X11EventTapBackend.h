@@ -3,40 +3,68 @@
 #include <X11/Xlib.h>
 
 #include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
 
 #include "robot/backend/IEventTapBackend.h"
 
 namespace robot::x11 {
 
+struct TapState;
+
 // Global input tap via the XRecord extension. XRecord delivers raw device events
 // on a second connection while the normal one keeps running, which is the
 // standard way to observe global input under X without grabbing it. Key events
 // are translated by keysym into physical Key values, and pointer positions are
-// reported as desktop pixels. Requires the XTEST/RECORD extension; start()
-// reports Unsupported when the server lacks it. XRecord observes only the X input
-// stream, so it captures nothing from native Wayland clients - a limitation the
-// factory surfaces up front.
+// reported as desktop pixels. Events are timed by the server's own millisecond
+// timestamp (see X11ServerClock). The record connection is read
+// asynchronously, so a batch can be delivered per reply buffer or held for the
+// configured latency without blocking inside Xlib, and so the same connection
+// can be handed to the caller's own poll loop (startPollable()). Requires the
+// XTEST/RECORD extension; start() reports Unsupported when the server lacks it.
+// XRecord observes only the X input stream, so it captures nothing from native
+// Wayland clients - a limitation the factory surfaces up front.
 class X11EventTapBackend final : public backend::IEventTapBackend {
  public:
-  X11EventTapBackend() = default;
-  ~X11EventTapBackend() override = default;
+  explicit X11EventTapBackend(std::string displayName);
+  ~X11EventTapBackend() override;
 
   X11EventTapBackend(const X11EventTapBackend&) = delete;
   X11EventTapBackend& operator=(const X11EventTapBackend&) = delete;
 
-  std::expected<void, Error> start(EventSink sink) override;
+  std::expected<void, Error> start(
+      EventBatchSink sink, const TapOptions& options
+  ) override;
+  std::expected<int, Error> startPollable(
+      EventBatchSink sink, const TapOptions& options
+  ) override;
+  std::expected<std::size_t, Error> dispatch() override;
   void stop() override;
   [[nodiscard]] bool isRunning() const override { return running_.load(); }
 
  private:
-  EventSink sink_;
+  // Connect, create the record context and enable it asynchronously.
+  std::expected<void, Error> open(
+      EventBatchSink sink, const TapOptions& options
+  );
+  // Hand every reply already received to the intercept callback.
+  void process();
+  // Release whatever open() acquired.
+  void close();
+
+  std::string displayName_;
   std::atomic<bool> running_{false};
+  bool pollable_ = false;
 
   // Two dedicated connections: XRecord requires a data connection distinct from
-  // the control one. Opened in start(), closed on teardown.
+  // the control one. Opened in open(), closed by close().
   Display* control_ = nullptr;
   Display* data_ = nullptr;
   void* context_ = nullptr;  // XRecordContext, kept opaque in the header.
+  int wake_ = -1;  // eventfd written by stop() to end the blocking wait.
+  std::unique_ptr<TapState> state_;
 };
 
-}  // namespace robot::x11
\ No newline at end of file
+}  // namespace robot::x11
@@ -31,6 +31,7 @@ std::expected<KeyCode, Error> X11KeyboardBackend::resolveKeycode(const Key key)
 }
 
 std::expected<void, Error> X11KeyboardBackend::keyDown(const Key key) {
+  const auto lock = connection_->lock();
   auto code = resolveKeycode(key);
   if (!code) return std::unexpected(code.error());
   XTestFakeKeyEvent(connection_->display(), *code, True, CurrentTime);
@@ -39,6 +40,7 @@ std::expected<void, Error> X11KeyboardBackend::keyDown(const Key key) {
 }
 
 std::expected<void, Error> X11KeyboardBackend::keyUp(const Key key) {
+  const auto lock = connection_->lock();
   auto code = resolveKeycode(key);
   if (!code) return std::unexpected(code.error());
   XTestFakeKeyEvent(connection_->display(), *code, False, CurrentTime);
@@ -49,6 +51,9 @@ std::expected<void, Error> X11KeyboardBackend::keyUp(const Key key) {
 std::expected<void, Error> X11KeyboardBackend::typeUnicode(
     const char32_t codepoint
 ) {
+  // Held across the whole remap, so no other key on this connection can land
+  // while the scratch keycode is rebound.
+  const auto lock = connection_->lock();
   Display* dpy = connection_->display();
 
   // Borrow a spare keycode, bind the target keysym to it, tap it, then restore.
@@ -1,8 +1,13 @@
 #include "X11MouseBackend.h"
 
+#include <X11/extensions/XInput2.h>
 #include <X11/extensions/XTest.h>
 
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstring>
+#include <limits>
 
 namespace robot::x11 {
 namespace {
@@ -20,9 +25,85 @@ unsigned int coreButton(const MouseButton b) {
   return 1;
 }
 
+// Pixel deltas are converted at 15 pixels per notch, the scroll distance the
+// X libinput driver reports for one wheel click (and the uinput backend's rate).
+constexpr double kPixelsPerNotch = 15.0;
+
+// The XTEST slave pointer is where XTest injects; its scroll valuators are the
+// only ones an XTest client can drive.
+bool isXTestPointer(const XIDeviceInfo& info) {
+  return info.use == XISlavePointer && info.name != nullptr &&
+         std::strstr(info.name, "XTEST pointer") != nullptr;
+}
+
 }  // namespace
 
+X11MouseBackend::X11MouseBackend(const X11Connection& connection)
+    : connection_(&connection) {
+  Display* dpy = connection_->display();
+
+  // Smooth scrolling arrived in XI 2.1. Any failure here simply leaves the
+  // button path in place; it is never an error.
+  int opcode = 0;
+  int event = 0;
+  int error = 0;
+  if (XQueryExtension(dpy, "XInputExtension", &opcode, &event, &error) == False) {
+    return;
+  }
+  int major = 2;
+  int minor = 1;
+  if (XIQueryVersion(dpy, &major, &minor) != Success ||
+      (major == 2 && minor < 1)) {
+    return;
+  }
+
+  int count = 0;
+  XIDeviceInfo* devices = XIQueryDevice(dpy, XIAllDevices, &count);
+  if (devices == nullptr) return;
+  int deviceId = -1;
+  for (int i = 0; i < count && deviceId < 0; ++i) {
+    if (!isXTestPointer(devices[i])) continue;
+    for (int c = 0; c < devices[i].num_classes; ++c) {
+      if (devices[i].classes[c]->type != XIScrollClass) continue;
+      const auto* scroll =
+          reinterpret_cast<const XIScrollClassInfo*>(devices[i].classes[c]);
+      ScrollAxis& axis = scroll->scroll_type == XIScrollTypeVertical
+                             ? vertical_
+                             : horizontal_;
+      axis.number = scroll->number;
+      axis.increment = scroll->increment;
+    }
+    if (vertical_.number >= 0 || horizontal_.number >= 0) {
+      deviceId = devices[i].deviceid;
+    }
+  }
+  XIFreeDeviceInfo(devices);
+
+  if (deviceId >= 0) {
+    scrollDevice_ = XOpenDevice(dpy, static_cast<XID>(deviceId));
+  }
+  if (scrollDevice_ == nullptr) {
+    vertical_ = {};
+    horizontal_ = {};
+  }
+}
+
+X11MouseBackend::~X11MouseBackend() {
+  if (scrollDevice_ != nullptr) {
+    XCloseDevice(connection_->display(), scrollDevice_);
+  }
+}
+
+bool X11MouseBackend::supportsHighResolutionScroll() const {
+  // An integer valuator with one unit per notch cannot express fractions.
+  const auto fine = [](const ScrollAxis& a) {
+    return a.number >= 0 && std::abs(a.increment) > 1.0;
+  };
+  return scrollDevice_ != nullptr && fine(vertical_) && fine(horizontal_);
+}
+
 std::expected<void, Error> X11MouseBackend::warpCursor(const LogicalPoint point) {
+  const auto lock = connection_->lock();
   // XTest positions in server pixels; LogicalPoint here carries desktop pixels
   // (X has no separate logical space at the core-protocol level), so it maps 1:1.
   XTestFakeMotionEvent(
@@ -34,6 +115,7 @@ std::expected<void, Error> X11MouseBackend::warpCursor(const LogicalPoint point)
 }
 
 std::expected<LogicalPoint, Error> X11MouseBackend::cursorPosition() {
+  const auto lock = connection_->lock();
   Window rootReturn = 0;
   Window childReturn = 0;
   int rootX = 0;
@@ -56,6 +138,7 @@ std::expected<LogicalPoint, Error> X11MouseBackend::cursorPosition() {
 std::expected<void, Error> X11MouseBackend::button(
     const MouseButton button, const ButtonAction action, int /*clickCount*/
 ) {
+  const auto lock = connection_->lock();
   // X derives double-click from timing/position between clicks, so the count is
   // not forwarded; the facade's paired clicks fall within the toolkit interval.
   XTestFakeButtonEvent(
@@ -67,13 +150,75 @@ std::expected<void, Error> X11MouseBackend::button(
 }
 
 std::expected<void, Error> X11MouseBackend::scroll(const ScrollDelta delta) {
+  // Also guards the valuators' carried fractions.
+  const auto lock = connection_->lock();
+  const bool valuators = scrollDevice_ != nullptr &&
+                         (delta.vertical == 0.0 || vertical_.number >= 0) &&
+                         (delta.horizontal == 0.0 || horizontal_.number >= 0);
+  if (delta.unit == ScrollUnit::Pixel && supportsHighResolutionScroll()) {
+    return scrollValuators(
+        delta.vertical / kPixelsPerNotch, delta.horizontal / kPixelsPerNotch
+    );
+  }
+  if (delta.unit == ScrollUnit::Line && valuators) {
+    return scrollValuators(delta.vertical, delta.horizontal);
+  }
+  return scrollButtons(delta);
+}
+
+std::expected<void, Error> X11MouseBackend::scrollValuators(
+    const double vertical, const double horizontal
+) {
+  // Library "up" is the negative scroll direction; "right" is positive.
+  const auto units = [](ScrollAxis& axis, const double notches) {
+    if (axis.number < 0 || notches == 0.0) return 0;
+    const double exact = notches * axis.increment + axis.fraction;
+    const auto whole = static_cast<int>(std::lround(exact));
+    axis.fraction = exact - whole;
+    return whole;
+  };
+  const int v = units(vertical_, -vertical);
+  const int h = units(horizontal_, horizontal);
+  if (v == 0 && h == 0) return {};
+
+  // One relative event over the contiguous valuator range spanning both axes;
+  // a zero relative delta leaves any valuator in between untouched.
+  int first = std::numeric_limits<int>::max();
+  int last = -1;
+  for (const ScrollAxis* axis : {&vertical_, &horizontal_}) {
+    if (axis->number < 0) continue;
+    first = std::min(first, axis->number);
+    last = std::max(last, axis->number);
+  }
+  std::array<int, 6> axes{};  // XTest carries at most six valuators per event.
+  const int count = last - first + 1;
+  if (count > static_cast<int>(axes.size())) {
+    return scrollButtons(ScrollDelta::lines(vertical, horizontal));
+  }
+  const auto slot = [&](const ScrollAxis& axis) -> int& {
+    return axes[static_cast<std::size_t>(axis.number - first)];
+  };
+  if (vertical_.number >= 0) slot(vertical_) = v;
+  if (horizontal_.number >= 0) slot(horizontal_) = h;
+
+  Display* dpy = connection_->display();
+  XTestFakeDeviceMotionEvent(
+      dpy, scrollDevice_, True, first, axes.data(), count, CurrentTime
+  );
+  XFlush(dpy);
+  return {};
+}
+
+std::expected<void, Error> X11MouseBackend::scrollButtons(
+    const ScrollDelta delta
+) {
   if (delta.unit == ScrollUnit::Pixel) {
     // Core X11 wheel is discrete button clicks; there is no pixel-precise wheel
     // in the core protocol. Rather than silently rounding pixels to notches, this
     // is reported as unsupported so callers know the granularity is unavailable.
     return std::unexpected(Error::unsupported(
-        "pixel-precise scrolling is not available through X11 core wheel "
-        "buttons; use line units"
+        "pixel-precise scrolling needs XInput 2.1 scroll valuators on the XTEST "
+        "pointer, which this X server does not provide; use line units"
     ));
   }
 
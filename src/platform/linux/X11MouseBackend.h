@@ -1,5 +1,7 @@
 #pragma once
 
+#include <X11/extensions/XInput.h>
+
 #include "X11Display.h"
 #include "robot/backend/IMouseBackend.h"
 
@@ -10,10 +12,23 @@ namespace robot::x11 {
 // scaling, but XTest positioning itself is in server pixels. Buttons 1/2/3 are
 // left/middle/right; 4-7 are wheel up/down/left/right; 8/9 are X1/X2. XTest keeps
 // the pointer button state, so a move while a button is held is already a drag.
+//
+// Scrolling prefers XInput2 smooth scrolling: when the server's XTEST pointer
+// carries scroll valuators (XI 2.1), a delta of any size is one relative
+// valuator event, from which the server derives both smooth-scroll events and
+// legacy wheel clicks for older clients. Without them, scrolling falls back to
+// one button 4-7 click per notch, in whole notches only.
 class X11MouseBackend final : public backend::IMouseBackend {
  public:
-  explicit X11MouseBackend(const X11Connection& connection)
-      : connection_(&connection) {}
+  explicit X11MouseBackend(const X11Connection& connection);
+  ~X11MouseBackend() override;
+
+  X11MouseBackend(const X11MouseBackend&) = delete;
+  X11MouseBackend& operator=(const X11MouseBackend&) = delete;
+
+  // Whether fractional-notch and pixel deltas are available, i.e. the XI2
+  // scroll valuators were found and are finer than one unit per notch.
+  [[nodiscard]] bool supportsHighResolutionScroll() const;
 
   std::expected<void, Error> warpCursor(LogicalPoint point) override;
   std::expected<LogicalPoint, Error> cursorPosition() override;
@@ -23,7 +38,22 @@ class X11MouseBackend final : public backend::IMouseBackend {
   std::expected<void, Error> scroll(ScrollDelta delta) override;
 
  private:
+  // One XI2 scroll valuator on the XTEST pointer. increment is the valuator
+  // delta of one notch in the axis's positive (down / right) direction;
+  // fraction carries the sub-unit remainder the integer axis cannot express.
+  struct ScrollAxis {
+    int number = -1;
+    double increment = 0.0;
+    double fraction = 0.0;
+  };
+
+  std::expected<void, Error> scrollValuators(double vertical, double horizontal);
+  std::expected<void, Error> scrollButtons(ScrollDelta delta);
+
   const X11Connection* connection_;
+  XDevice* scrollDevice_ = nullptr;  // XTEST pointer opened for XI events.
+  ScrollAxis vertical_;
+  ScrollAxis horizontal_;
 };
 
 }  // namespace robot::x11
\ No newline at end of file
@@ -0,0 +1,422 @@
+#include "X11RawEventTapBackend.h"
+
+#include <X11/XKBlib.h>
+#include <X11/extensions/XInput2.h>
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "X11KeyMap.h"
+#include "X11ServerClock.h"
+#include "common/TapBatcher.h"
+#include "robot/Event.h"
+
+namespace robot::x11 {
+namespace {
+
+using Clock = tap::Batcher::Clock;
+
+// What one valuator of a source device reports. By convention valuators 0
+// and 1 are the pointer axes; scroll classes name their own.
+enum class AxisRole : std::uint8_t {
+  Other,
+  X,
+  Y,
+  ScrollVertical,
+  ScrollHorizontal,
+};
+
+struct Valuator {
+  AxisRole role = AxisRole::Other;
+  bool absolute = false;
+  double min = 0.0;
+  double max = 0.0;
+  double increment = 0.0;      // Scroll units per notch.
+  std::optional<double> last;  // Absolute scroll axes report a running total.
+};
+
+// The valuators of a source (slave) device, indexed by number, as the server
+// describes them. Raw events name their source but not its axes.
+std::vector<Valuator> describe(Display* display, const int sourceId) {
+  std::vector<Valuator> axes;
+  int count = 0;
+  XIDeviceInfo* info = XIQueryDevice(display, sourceId, &count);
+  if (info == nullptr) return axes;
+  const auto at = [&](const int number) -> Valuator& {
+    const auto index = static_cast<std::size_t>(number);
+    if (axes.size() <= index) axes.resize(index + 1);
+    return axes[index];
+  };
+  for (int c = 0; c < info->num_classes; ++c) {
+    const XIAnyClassInfo* any = info->classes[c];
+    if (any->type == XIValuatorClass) {
+      const auto* v = reinterpret_cast<const XIValuatorClassInfo*>(any);
+      Valuator& axis = at(v->number);
+      axis.absolute = v->mode == XIModeAbsolute;
+      axis.min = v->min;
+      axis.max = v->max;
+      if (axis.role == AxisRole::Other && v->number < 2) {
+        axis.role = v->number == 0 ? AxisRole::X : AxisRole::Y;
+      }
+    } else if (any->type == XIScrollClass) {
+      const auto* s = reinterpret_cast<const XIScrollClassInfo*>(any);
+      Valuator& axis = at(s->number);
+      axis.role = s->scroll_type == XIScrollTypeVertical
+                      ? AxisRole::ScrollVertical
+                      : AxisRole::ScrollHorizontal;
+      axis.increment = s->increment;
+    }
+  }
+  XIFreeDeviceInfo(info);
+  return axes;
+}
+
+// Milliseconds until a batch falls due, rounded up so poll() never wakes
+// early; -1 (wait for input or stop()) when nothing is buffered.
+int pollTimeout(const Clock::time_point due) {
+  if (due == Clock::time_point::max()) return -1;
+  const auto wait = due - Clock::now();
+  if (wait <= wait.zero()) return 0;
+  const auto ms = std::chrono::ceil<std::chrono::milliseconds>(wait).count();
+  return static_cast<int>(std::min<long long>(ms, INT_MAX));
+}
+
+}  // namespace
+
+// Everything an open tap translates with: the followed pointer position, the
+// source devices' axes, the server clock and the batcher.
+struct RawTapState {
+  RawTapState(
+      Display* dpy, const int opcode, EventBatchSink sink,
+      const TapOptions& options
+  )
+      : display(dpy), xiOpcode(opcode), batcher(std::move(sink), options) {
+    const int screen = DefaultScreen(display);
+    width = DisplayWidth(display, screen);
+    height = DisplayHeight(display, screen);
+    Window root = 0;
+    Window child = 0;
+    int rootX = 0;
+    int rootY = 0;
+    int winX = 0;
+    int winY = 0;
+    unsigned int mask = 0;
+    if (XQueryPointer(
+            display, RootWindow(display, screen), &root, &child, &rootX,
+            &rootY, &winX, &winY, &mask
+        ) != False) {
+      position = {static_cast<double>(rootX), static_cast<double>(rootY)};
+    }
+  }
+
+  void handle(const XIRawEvent& ev) {
+    const auto at = clock.map(ev.time, Clock::now());
+    const auto emit = [&](const InputEvent& e) { batcher.push({at, e}); };
+
+    switch (ev.evtype) {
+      case XI_RawKeyPress:
+      case XI_RawKeyRelease: {
+        const KeySym ks = XkbKeycodeToKeysym(
+            display, static_cast<KeyCode>(ev.detail), 0, 0
+        );
+        const Key key = keysymToKey(ks);
+        if (key != Key::Unknown) {
+          emit(KeyEvent{key, ev.evtype == XI_RawKeyPress});
+        }
+        break;
+      }
+      case XI_RawButtonPress:
+      case XI_RawButtonRelease: {
+        // Buttons the server synthesizes from scroll valuators or touches;
+        // the valuators themselves are reported instead.
+        if ((ev.flags & XIPointerEmulated) != 0) break;
+        const bool down = ev.evtype == XI_RawButtonPress;
+        switch (ev.detail) {
+          case 1:
+            emit(MouseButtonEvent{MouseButton::Left, down, position});
+            break;
+          case 2:
+            emit(MouseButtonEvent{MouseButton::Middle, down, position});
+            break;
+          case 3:
+            emit(MouseButtonEvent{MouseButton::Right, down, position});
+            break;
+          case 4:
+            if (down) emit(ScrollEvent{ScrollDelta::lines(1, 0), position});
+            break;
+          case 5:
+            if (down) emit(ScrollEvent{ScrollDelta::lines(-1, 0), position});
+            break;
+          case 6:
+            if (down) emit(ScrollEvent{ScrollDelta::lines(0, -1), position});
+            break;
+          case 7:
+            if (down) emit(ScrollEvent{ScrollDelta::lines(0, 1), position});
+            break;
+          case 8:
+            emit(MouseButtonEvent{MouseButton::X1, down, position});
+            break;
+          case 9:
+            emit(MouseButtonEvent{MouseButton::X2, down, position});
+            break;
+          default:
+            break;
+        }
+        break;
+      }
+      case XI_RawMotion:
+        motion(ev, at);
+        break;
+      default:
+        break;
+    }
+  }
+
+  void motion(const XIRawEvent& ev, const Clock::time_point at) {
+    auto found = sources.find(ev.sourceid);
+    if (found == sources.end()) {
+      found = sources.emplace(ev.sourceid, describe(display, ev.sourceid))
+                  .first;
+    }
+    std::vector<Valuator>& axes = found->second;
+
+    LogicalPoint p = position;
+    double vertical = 0.0;
+    double horizontal = 0.0;
+    // values holds one entry per bit set in the mask, in valuator order.
+    const double* value = ev.valuators.values;
+    for (int n = 0; n < ev.valuators.mask_len * CHAR_BIT; ++n) {
+      if (!XIMaskIsSet(ev.valuators.mask, n)) continue;
+      const double v = *value++;
+      if (static_cast<std::size_t>(n) >= axes.size()) continue;
+      Valuator& axis = axes[static_cast<std::size_t>(n)];
+      switch (axis.role) {
+        case AxisRole::X:
+          p.x = axis.absolute ? toScreen(v, axis, width) : p.x + v;
+          break;
+        case AxisRole::Y:
+          p.y = axis.absolute ? toScreen(v, axis, height) : p.y + v;
+          break;
+        case AxisRole::ScrollVertical:
+          // X scrolls down for positive values; the library's up is positive.
+          vertical -= notches(axis, v);
+          break;
+        case AxisRole::ScrollHorizontal:
+          horizontal += notches(axis, v);
+          break;
+        case AxisRole::Other:
+          break;
+      }
+    }
+
+    p.x = std::clamp(p.x, 0.0, std::max(0.0, width - 1.0));
+    p.y = std::clamp(p.y, 0.0, std::max(0.0, height - 1.0));
+    if (p.x != position.x || p.y != position.y) {
+      position = p;
+      batcher.push({at, MouseMoveEvent{position}});
+    }
+    if (vertical != 0.0 || horizontal != 0.0) {
+      batcher.push(
+          {at, ScrollEvent{ScrollDelta::lines(vertical, horizontal), position}}
+      );
+    }
+  }
+
+  // An absolute axis's value in screen pixels. The XTEST pointer declares no
+  // range (max below min) and reports screen pixels directly.
+  static double toScreen(
+      const double v, const Valuator& axis, const int extent
+  ) {
+    if (axis.max <= axis.min) return v;
+    return (v - axis.min) / (axis.max - axis.min) * (extent - 1);
+  }
+
+  // A scroll valuator's change in notches.
+  static double notches(Valuator& axis, const double v) {
+    double delta = v;
+    if (axis.absolute) {
+      delta = axis.last ? v - *axis.last : 0.0;
+      axis.last = v;
+    }
+    return axis.increment != 0.0 ? delta / axis.increment : 0.0;
+  }
+
+  Display* display;
+  int xiOpcode;
+  int width = 0;
+  int height = 0;
+  LogicalPoint position;
+  std::unordered_map<int, std::vector<Valuator>> sources;
+  tap::Batcher batcher;
+  X11ServerClock clock;
+};
+
+X11RawEventTapBackend::X11RawEventTapBackend(std::string displayName)
+    : displayName_(std::move(displayName)),
+      wake_(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) {}
+
+X11RawEventTapBackend::~X11RawEventTapBackend() {
+  if (pollable_) stop();
+  if (wake_ >= 0) ::close(wake_);
+}
+
+std::expected<void, Error> X11RawEventTapBackend::open(
+    EventBatchSink sink, const TapOptions& options
+) {
+  if (running_.load()) {
+    return std::unexpected(
+        Error::unsupported("the event tap is already running")
+    );
+  }
+  if (wake_ < 0) return std::unexpected(Error::platformError("eventfd"));
+  // Clear a wakeup left by a stop() that raced the previous run's exit.
+  std::uint64_t stale = 0;
+  (void)::read(wake_, &stale, sizeof(stale));
+
+  display_ = XOpenDisplay(displayName_.c_str());
+  if (display_ == nullptr) {
+    return std::unexpected(
+        Error::backendUnavailable("cannot open an X connection for XInput2")
+    );
+  }
+  int opcode = 0;
+  int event = 0;
+  int error = 0;
+  int major = 2;
+  int minor = 2;
+  if (XQueryExtension(display_, "XInputExtension", &opcode, &event, &error) ==
+          False ||
+      XIQueryVersion(display_, &major, &minor) != Success) {
+    close();
+    return std::unexpected(
+        Error::unsupported("the X server lacks XInput 2 raw events")
+    );
+  }
+
+  // Only the wanted raw types are selected; scroll valuators ride on motion.
+  // The rest of the filter is applied by the batcher.
+  const EventFilter& filter = options.filter;
+  std::array<unsigned char, XIMaskLen(XI_LASTEVENT)> raw{};
+  if (filter.keys) {
+    XISetMask(raw.data(), XI_RawKeyPress);
+    XISetMask(raw.data(), XI_RawKeyRelease);
+  }
+  if (filter.buttons || filter.scroll) {
+    XISetMask(raw.data(), XI_RawButtonPress);
+    XISetMask(raw.data(), XI_RawButtonRelease);
+  }
+  if (filter.motion || filter.scroll) XISetMask(raw.data(), XI_RawMotion);
+  // Device changes invalidate the cached axis descriptions.
+  std::array<unsigned char, XIMaskLen(XI_LASTEVENT)> hierarchy{};
+  XISetMask(hierarchy.data(), XI_HierarchyChanged);
+  std::array<XIEventMask, 2> masks{{
+      {XIAllMasterDevices, static_cast<int>(raw.size()), raw.data()},
+      {XIAllDevices, static_cast<int>(hierarchy.size()), hierarchy.data()},
+  }};
+  XISelectEvents(
+      display_, DefaultRootWindow(display_), masks.data(),
+      static_cast<int>(masks.size())
+  );
+  XFlush(display_);
+
+  state_ = std::make_unique<RawTapState>(
+      display_, opcode, std::move(sink), options
+  );
+  running_.store(true);
+  return {};
+}
+
+void X11RawEventTapBackend::process() {
+  while (XPending(display_) > 0) {
+    XEvent ev;
+    XNextEvent(display_, &ev);
+    XGenericEventCookie& cookie = ev.xcookie;
+    if (cookie.type != GenericEvent ||
+        cookie.extension != state_->xiOpcode ||
+        XGetEventData(display_, &cookie) == False) {
+      continue;
+    }
+    if (cookie.evtype == XI_HierarchyChanged) {
+      state_->sources.clear();
+    } else {
+      state_->handle(*static_cast<const XIRawEvent*>(cookie.data));
+    }
+    XFreeEventData(display_, &cookie);
+  }
+}
+
+void X11RawEventTapBackend::close() {
+  if (display_ != nullptr) XCloseDisplay(display_);
+  display_ = nullptr;
+  state_.reset();
+}
+
+std::expected<void, Error> X11RawEventTapBackend::start(
+    EventBatchSink sink, const TapOptions& options
+) {
+  if (auto r = open(std::move(sink), options); !r) return r;
+
+  tap::Batcher& batcher = state_->batcher;
+  std::array<pollfd, 2> fds{{
+      {.fd = ConnectionNumber(display_), .events = POLLIN, .revents = 0},
+      {.fd = wake_, .events = POLLIN, .revents = 0},
+  }};
+  while (running_.load()) {
+    process();
+    batcher.idle(Clock::now());
+    (void)poll(fds.data(), fds.size(), pollTimeout(batcher.due()));
+  }
+  process();
+  batcher.flush();
+  close();
+  return {};
+}
+
+std::expected<int, Error> X11RawEventTapBackend::startPollable(
+    EventBatchSink sink, const TapOptions& options
+) {
+  if (auto r = open(std::move(sink), options); !r) {
+    return std::unexpected(r.error());
+  }
+  pollable_ = true;
+  return ConnectionNumber(display_);
+}
+
+std::expected<std::size_t, Error> X11RawEventTapBackend::dispatch() {
+  if (!pollable_) {
+    return std::unexpected(
+        Error::invalidArgument("dispatch() needs a tap from startPollable()")
+    );
+  }
+  const std::size_t before = state_->batcher.delivered();
+  process();
+  state_->batcher.flush();
+  return state_->batcher.delivered() - before;
+}
+
+void X11RawEventTapBackend::stop() {
+  running_.store(false);
+  // Wakes the poll in start() without touching the connection, which belongs
+  // to the reading thread; the eventfd outlives every run.
+  const std::uint64_t one = 1;
+  if (wake_ >= 0) (void)::write(wake_, &one, sizeof(one));
+  if (pollable_) {
+    pollable_ = false;
+    process();
+    state_->batcher.flush();
+    close();
+  }
+}
+
+}  // namespace robot::x11
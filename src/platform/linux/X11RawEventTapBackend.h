@@ -0,0 +1,70 @@
+#pragma once
+
+#include <X11/Xlib.h>
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "robot/backend/IEventTapBackend.h"
+
+namespace robot::x11 {
+
+struct RawTapState;
+
+// Global input tap via XInput2 raw events (XI_RawKeyPress/Release,
+// XI_RawButtonPress/Release, XI_RawMotion), selected on the root window for
+// the master devices. Raw events come straight from the device layer, before
+// any window delivery or grab, as ordinary events on one connection: there is
+// no second record connection and no protocol bytes to decode, so an event
+// reaches the sink with less work on the way than through XRecord.
+//
+// Raw events carry valuator values rather than a pointer position, so the
+// position is followed from them: absolute valuators (the XTEST pointer,
+// tablets) are mapped onto the screen, relative ones add their accelerated
+// deltas, starting from the pointer's position at open() and clamped to the
+// screen. Positions are therefore fractional where the device is. Smooth
+// scrolling arrives as scroll-class valuators and is reported in fractional
+// lines; legacy wheel buttons still arrive as buttons 4-7. The server
+// generates no raw events for its own auto-repeat. Timestamps are the server's
+// (see X11ServerClock). Needs XInput 2.0; start() reports Unsupported without
+// it. Like XRecord, it sees only the X input stream.
+class X11RawEventTapBackend final : public backend::IEventTapBackend {
+ public:
+  explicit X11RawEventTapBackend(std::string displayName);
+  ~X11RawEventTapBackend() override;
+
+  X11RawEventTapBackend(const X11RawEventTapBackend&) = delete;
+  X11RawEventTapBackend& operator=(const X11RawEventTapBackend&) = delete;
+
+  std::expected<void, Error> start(
+      EventBatchSink sink, const TapOptions& options
+  ) override;
+  std::expected<int, Error> startPollable(
+      EventBatchSink sink, const TapOptions& options
+  ) override;
+  std::expected<std::size_t, Error> dispatch() override;
+  void stop() override;
+  [[nodiscard]] bool isRunning() const override { return running_.load(); }
+
+ private:
+  // Connect and select the raw events the filter can use.
+  std::expected<void, Error> open(
+      EventBatchSink sink, const TapOptions& options
+  );
+  // Translate every event already received.
+  void process();
+  // Release whatever open() acquired.
+  void close();
+
+  std::string displayName_;
+  std::atomic<bool> running_{false};
+  bool pollable_ = false;
+
+  Display* display_ = nullptr;
+  int wake_ = -1;  // eventfd written by stop() to end the blocking wait.
+  std::unique_ptr<RawTapState> state_;
+};
+
+}  // namespace robot::x11
@@ -34,16 +34,40 @@ std::uint8_t channel(const unsigned long pixel, const unsigned long mask) {
   return static_cast<std::uint8_t>(shifted << (8 - bits));
 }
 
+// Vertical refresh of a RandR mode: pixel clock over total pixels per frame.
+// Doublescan draws every line twice and interlace draws half the lines per
+// field, so both adjust the effective frame count. 0 when the mode is unknown.
+double modeRefreshRate(const XRRScreenResources* res, const RRMode id) {
+  for (int i = 0; i < res->nmode; ++i) {
+    const XRRModeInfo& mode = res->modes[i];
+    if (mode.id != id) continue;
+    if (mode.hTotal == 0 || mode.vTotal == 0) return 0.0;
+    double vTotal = static_cast<double>(mode.vTotal);
+    if ((mode.modeFlags & RR_DoubleScan) != 0) vTotal *= 2.0;
+    if ((mode.modeFlags & RR_Interlace) != 0) vTotal /= 2.0;
+    return static_cast<double>(mode.dotClock) /
+           (static_cast<double>(mode.hTotal) * vTotal);
+  }
+  return 0.0;
+}
+
 }  // namespace
 
 std::expected<std::vector<Monitor>, Error>
 X11ScreenBackend::enumerateMonitors() {
+  const auto lock = connection_->lock();
   Display* dpy = connection_->display();
   const Window root = connection_->root();
 
-  XRRScreenResources* res = XRRGetScreenResources(dpy, root);
+  // The configuration the server already knows. XRRGetScreenResources would
+  // make it reprobe every output first, which can take tens of milliseconds
+  // and is done for each DisplayRefresh move. libXrandr falls back to the
+  // probing request on servers older than RandR 1.3.
+  XRRScreenResources* res = XRRGetScreenResourcesCurrent(dpy, root);
   if (res == nullptr) {
-    return std::unexpected(Error::platformError("XRRGetScreenResources"));
+    return std::unexpected(
+        Error::platformError("XRRGetScreenResourcesCurrent")
+    );
   }
 
   RROutput primary = XRRGetOutputPrimary(dpy, root);
@@ -64,6 +88,7 @@ X11ScreenBackend::enumerateMonitors() {
       m.name = std::format("CRTC {}", i);
       m.isPrimary = isPrimary;
       m.scaleFactor = 1.0;  // X core exposes no per-monitor logical scale.
+      m.refreshRate = modeRefreshRate(res, crtc->mode);
       m.physicalBounds = PhysicalRect{
           {crtc->x, crtc->y},
           {static_cast<std::int32_t>(crtc->width),
@@ -88,17 +113,21 @@ X11ScreenBackend::enumerateMonitors() {
 std::expected<Image, Error> X11ScreenBackend::captureRegion(
     const PhysicalRect region
 ) {
-  Display* dpy = connection_->display();
   const int w = region.size.width;
   const int h = region.size.height;
 
   // AllPlanes over the root at absolute coordinates: negative origins are passed
   // through directly to capture a monitor placed left of or above the primary.
-  XImage* img = XGetImage(
-      dpy, connection_->root(), region.origin.x, region.origin.y,
-      static_cast<unsigned int>(w), static_cast<unsigned int>(h), AllPlanes,
-      ZPixmap
-  );
+  // The connection is needed only for the transfer; the pixel conversion below
+  // runs unlocked.
+  XImage* img = [&] {
+    const auto lock = connection_->lock();
+    return XGetImage(
+        connection_->display(), connection_->root(), region.origin.x,
+        region.origin.y, static_cast<unsigned int>(w),
+        static_cast<unsigned int>(h), AllPlanes, ZPixmap
+    );
+  }();
   if (img == nullptr) {
     return std::unexpected(Error::captureFailed("XGetImage returned null"));
   }
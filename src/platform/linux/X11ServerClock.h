@@ -0,0 +1,63 @@
+#pragma once
+
+#include <X11/Xlib.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+namespace robot::x11 {
+
+// Maps X server timestamps (the Time field of every device event: a 32-bit
+// millisecond counter that wraps every ~49.7 days) onto std::chrono::
+// steady_clock, so recorded gaps are the gaps the server saw rather than when
+// the tap callback happened to run.
+//
+// The offset between the two clocks is estimated as the smallest (arrival -
+// server time) seen so far: every sample over-estimates it by that event's
+// delivery delay, so the minimum is the closest. The estimate may creep up by
+// kMaxDrift per elapsed second to follow genuine clock drift, and a sample
+// that would map into the future is clamped to its arrival time.
+class X11ServerClock {
+ public:
+  // 200 ppm: well above real oscillator drift, far below delivery jitter.
+  static constexpr double kMaxDrift = 200e-6;
+
+  std::chrono::steady_clock::time_point map(
+      const Time serverTime, const std::chrono::steady_clock::time_point arrival
+  ) {
+    // Unwrap the 32-bit counter against the previous sample.
+    const auto server32 = static_cast<std::uint32_t>(serverTime);
+    if (last32_) {
+      serverMs_ += static_cast<std::int32_t>(server32 - *last32_);
+    } else {
+      serverMs_ = server32;
+    }
+    last32_ = server32;
+
+    const std::chrono::steady_clock::time_point server{
+        std::chrono::milliseconds(serverMs_)};
+    const auto sample = arrival - server;
+    if (!offset_ || sample < *offset_) {
+      offset_ = sample;
+    } else {
+      const std::chrono::duration<double> sinceLast = arrival - lastArrival_;
+      const auto creep =
+          std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+              sinceLast * kMaxDrift
+          );
+      offset_ = std::min(sample, *offset_ + creep);
+    }
+    lastArrival_ = arrival;
+    return std::min(arrival, server + *offset_);
+  }
+
+ private:
+  std::optional<std::uint32_t> last32_;
+  std::int64_t serverMs_ = 0;
+  std::optional<std::chrono::steady_clock::duration> offset_;
+  std::chrono::steady_clock::time_point lastArrival_;
+};
+
+}  // namespace robot::x11
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <expected>
+#include <memory>
+#include <string>
+
+#include "robot/Error.h"
+#include "robot/Session.h"
+#include "robot/backend/IPlatformBackend.h"
+
+// Linux internal: the one entry point to the XCB backend that the factory
+// sees. It stays free of XCB headers so the factory compiles either way: a
+// build configured with ROBOT_LINUX_ENABLE_XCB links XcbPlatformBackend.cpp,
+// one without it links XcbUnavailable.cpp, which reports Unsupported.
+namespace robot::linux_backend {
+
+// Open the XCB backend on display (empty for $DISPLAY). Capabilities the
+// server turns out to lack (XTEST, RandR 1.3) are cleared.
+std::expected<std::unique_ptr<backend::IPlatformBackend>, Error>
+makeXcbBackend(
+    const std::string& display, Capabilities capabilities,
+    X11TapSource tapSource
+);
+
+}  // namespace robot::linux_backend
@@ -0,0 +1,102 @@
+#include "XcbConnection.h"
+
+#include <xcb/randr.h>
+#include <xcb/shm.h>
+#include <xcb/xtest.h>
+
+#include <utility>
+
+namespace robot::xcb {
+
+std::expected<XcbConnection, Error> XcbConnection::open(
+    const std::string& name
+) {
+  int screenNumber = 0;
+  xcb_connection_t* c =
+      xcb_connect(name.empty() ? nullptr : name.c_str(), &screenNumber);
+  // xcb_connect never returns null; a failed connection is an error object.
+  if (xcb_connection_has_error(c) != 0) {
+    xcb_disconnect(c);
+    if (!name.empty()) {
+      return std::unexpected(
+          Error::backendUnavailable("cannot open X display " + name)
+      );
+    }
+    return std::unexpected(Error::backendUnavailable(
+        "cannot open an X display (no X server, or a Wayland session without "
+        "Xwayland); set DISPLAY or use the uinput backend"
+    ));
+  }
+
+  const xcb_screen_t* screen = nullptr;
+  xcb_screen_iterator_t it = xcb_setup_roots_iterator(xcb_get_setup(c));
+  for (int i = 0; it.rem > 0; ++i, xcb_screen_next(&it)) {
+    if (i == screenNumber) {
+      screen = it.data;
+      break;
+    }
+  }
+  if (screen == nullptr) {
+    xcb_disconnect(c);
+    return std::unexpected(
+        Error::backendUnavailable("X display has no screen " +
+                                  std::to_string(screenNumber))
+    );
+  }
+  return XcbConnection{c, screen, name};
+}
+
+XcbConnection::XcbConnection(
+    xcb_connection_t* connection, const xcb_screen_t* screen, std::string name
+)
+    : connection_(connection), screen_(screen), name_(std::move(name)) {
+  // All three QueryExtension requests go out before the first reply is read.
+  xcb_prefetch_extension_data(connection_, &xcb_test_id);
+  xcb_prefetch_extension_data(connection_, &xcb_randr_id);
+  xcb_prefetch_extension_data(connection_, &xcb_shm_id);
+  const auto present = [&](xcb_extension_t* ext) {
+    const xcb_query_extension_reply_t* r =
+        xcb_get_extension_data(connection_, ext);
+    return r != nullptr && r->present != 0;
+  };
+  hasXTest_ = present(&xcb_test_id);
+  hasShm_ = present(&xcb_shm_id);
+  // GetScreenResourcesCurrent and GetOutputPrimary arrived in RandR 1.3.
+  if (present(&xcb_randr_id)) {
+    const Reply<xcb_randr_query_version_reply_t> version(
+        xcb_randr_query_version_reply(
+            connection_, xcb_randr_query_version(connection_, 1, 3), nullptr
+        )
+    );
+    hasRandr_ = version != nullptr &&
+                (version->major_version > 1 ||
+                 (version->major_version == 1 && version->minor_version >= 3));
+  }
+}
+
+XcbConnection::~XcbConnection() {
+  if (connection_ != nullptr) xcb_disconnect(connection_);
+}
+
+XcbConnection::XcbConnection(XcbConnection&& other) noexcept
+    : connection_(std::exchange(other.connection_, nullptr)),
+      screen_(std::exchange(other.screen_, nullptr)),
+      name_(std::move(other.name_)),
+      hasXTest_(other.hasXTest_),
+      hasRandr_(other.hasRandr_),
+      hasShm_(other.hasShm_) {}
+
+XcbConnection& XcbConnection::operator=(XcbConnection&& other) noexcept {
+  if (this != &other) {
+    if (connection_ != nullptr) xcb_disconnect(connection_);
+    connection_ = std::exchange(other.connection_, nullptr);
+    screen_ = std::exchange(other.screen_, nullptr);
+    name_ = std::move(other.name_);
+    hasXTest_ = other.hasXTest_;
+    hasRandr_ = other.hasRandr_;
+    hasShm_ = other.hasShm_;
+  }
+  return *this;
+}
+
+}  // namespace robot::xcb
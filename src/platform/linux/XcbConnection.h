@@ -0,0 +1,66 @@
+#pragma once
+
+#include <xcb/xcb.h>
+
+#include <cstdlib>
+#include <expected>
+#include <memory>
+#include <string>
+
+#include "robot/Error.h"
+
+namespace robot::xcb {
+
+// Replies and errors are malloc()ed by XCB and owned by the caller.
+struct FreeDeleter {
+  void operator()(void* p) const { std::free(p); }
+};
+template <typename T>
+using Reply = std::unique_ptr<T, FreeDeleter>;
+
+// A connection to the X server through XCB, owned by the platform backend and
+// handed to the XCB sub-backends by reference. Unlike an Xlib Display, an XCB
+// connection is thread-safe: each request returns a cookie, and the reply is
+// matched to it by sequence number whichever thread reads the socket. One
+// connection therefore serves keyboard, mouse and screen with no lock, and
+// requests from different threads (a pointer query during a capture) are
+// pipelined on the one socket instead of queueing behind each other.
+//
+// Opening prefetches the XTEST, RandR and MIT-SHM extension data in one round
+// trip and records which are present; the sub-backends report Unsupported for
+// what the server lacks.
+class XcbConnection {
+ public:
+  // An empty name opens $DISPLAY.
+  static std::expected<XcbConnection, Error> open(const std::string& name);
+
+  ~XcbConnection();
+  XcbConnection(XcbConnection&&) noexcept;
+  XcbConnection& operator=(XcbConnection&&) noexcept;
+  XcbConnection(const XcbConnection&) = delete;
+  XcbConnection& operator=(const XcbConnection&) = delete;
+
+  [[nodiscard]] xcb_connection_t* connection() const { return connection_; }
+  [[nodiscard]] const xcb_screen_t& screen() const { return *screen_; }
+  [[nodiscard]] xcb_window_t root() const { return screen_->root; }
+  // The name the connection was opened with, for the event tap's own
+  // connections; empty for $DISPLAY.
+  [[nodiscard]] const std::string& name() const { return name_; }
+
+  [[nodiscard]] bool hasXTest() const { return hasXTest_; }
+  [[nodiscard]] bool hasRandr() const { return hasRandr_; }
+  [[nodiscard]] bool hasShm() const { return hasShm_; }
+
+ private:
+  XcbConnection(xcb_connection_t* connection, const xcb_screen_t* screen,
+                std::string name);
+
+  xcb_connection_t* connection_ = nullptr;
+  const xcb_screen_t* screen_ = nullptr;  // Points into the setup data.
+  std::string name_;
+  bool hasXTest_ = false;
+  bool hasRandr_ = false;
+  bool hasShm_ = false;
+};
+
+}  // namespace robot::xcb
@@ -0,0 +1,135 @@
+#include "XcbKeyboardBackend.h"
+
+#include <xcb/xtest.h>
+
+#include <algorithm>
+#include <cstddef>
+
+#include "X11KeyMap.h"
+
+namespace robot::xcb {
+namespace {
+
+// Map a Unicode scalar to the X keysym convention: Latin-1 is its own
+// codepoint, everything else is 0x01000000 | codepoint.
+xcb_keysym_t unicodeToKeysym(const char32_t cp) {
+  if (cp < 0x100) return static_cast<xcb_keysym_t>(cp);
+  return static_cast<xcb_keysym_t>(0x01000000u | cp);
+}
+
+Error noXTest() {
+  return Error::unsupported("the X server has no XTEST extension");
+}
+
+}  // namespace
+
+XcbKeyboardBackend::XcbKeyboardBackend(const XcbConnection& connection)
+    : connection_(&connection) {
+  xcb_connection_t* c = connection_->connection();
+  const xcb_setup_t* setup = xcb_get_setup(c);
+  minKeycode_ = setup->min_keycode;
+  const auto count =
+      static_cast<std::uint8_t>(setup->max_keycode - setup->min_keycode + 1);
+  const Reply<xcb_get_keyboard_mapping_reply_t> mapping(
+      xcb_get_keyboard_mapping_reply(
+          c, xcb_get_keyboard_mapping(c, minKeycode_, count), nullptr
+      )
+  );
+  // Without a mapping every key is unmappable; that surfaces per call.
+  if (mapping == nullptr || mapping->keysyms_per_keycode == 0) return;
+  perCode_ = mapping->keysyms_per_keycode;
+  const xcb_keysym_t* syms = xcb_get_keyboard_mapping_keysyms(mapping.get());
+  keysyms_.assign(
+      syms, syms + xcb_get_keyboard_mapping_keysyms_length(mapping.get())
+  );
+
+  const std::size_t codes = keysyms_.size() / perCode_;
+  for (std::size_t i = codes; i-- > 0;) {
+    const auto first =
+        keysyms_.begin() + static_cast<std::ptrdiff_t>(i * perCode_);
+    if (std::all_of(first, first + perCode_,
+                    [](const xcb_keysym_t s) { return s == 0; })) {
+      scratch_ = static_cast<xcb_keycode_t>(minKeycode_ + i);
+      break;
+    }
+  }
+}
+
+std::expected<xcb_keycode_t, Error> XcbKeyboardBackend::resolveKeycode(
+    const Key key
+) const {
+  const auto ks = static_cast<xcb_keysym_t>(x11::keyToKeysym(key));
+  // Column by column, lowest keycode first, as XKeysymToKeycode searches.
+  if (ks != 0 && perCode_ > 0) {
+    const std::size_t codes = keysyms_.size() / perCode_;
+    for (std::size_t col = 0; col < perCode_; ++col) {
+      for (std::size_t i = 0; i < codes; ++i) {
+        if (keysyms_[i * perCode_ + col] == ks) {
+          return static_cast<xcb_keycode_t>(minKeycode_ + i);
+        }
+      }
+    }
+  }
+  return std::unexpected(Error::unmappableInput(toString(key)));
+}
+
+std::expected<void, Error> XcbKeyboardBackend::fakeKey(
+    const Key key, const bool down
+) {
+  if (!connection_->hasXTest()) return std::unexpected(noXTest());
+  auto code = resolveKeycode(key);
+  if (!code) return std::unexpected(code.error());
+  xcb_connection_t* c = connection_->connection();
+  xcb_test_fake_input(
+      c, down ? XCB_KEY_PRESS : XCB_KEY_RELEASE, *code, XCB_CURRENT_TIME,
+      XCB_NONE, 0, 0, XCB_NONE
+  );
+  xcb_flush(c);
+  return {};
+}
+
+std::expected<void, Error> XcbKeyboardBackend::keyDown(const Key key) {
+  return fakeKey(key, true);
+}
+
+std::expected<void, Error> XcbKeyboardBackend::keyUp(const Key key) {
+  return fakeKey(key, false);
+}
+
+std::expected<void, Error> XcbKeyboardBackend::typeUnicode(
+    const char32_t codepoint
+) {
+  if (!connection_->hasXTest()) return std::unexpected(noXTest());
+  if (scratch_ == 0) {
+    return std::unexpected(Error::unsupported(
+        "the keyboard mapping has no free keycode to bind characters to"
+    ));
+  }
+  const std::lock_guard lock(unicodeMutex_);
+  xcb_connection_t* c = connection_->connection();
+
+  // The server applies one connection's requests in order, so the key events
+  // see the new binding and precede the restore without a sync in between.
+  const xcb_keysym_t target = unicodeToKeysym(codepoint);
+  const xcb_keysym_t empty = 0;
+  const xcb_void_cookie_t remap =
+      xcb_change_keyboard_mapping_checked(c, 1, scratch_, 1, &target);
+  xcb_test_fake_input(
+      c, XCB_KEY_PRESS, scratch_, XCB_CURRENT_TIME, XCB_NONE, 0, 0, XCB_NONE
+  );
+  xcb_test_fake_input(
+      c, XCB_KEY_RELEASE, scratch_, XCB_CURRENT_TIME, XCB_NONE, 0, 0, XCB_NONE
+  );
+  xcb_change_keyboard_mapping(c, 1, scratch_, 1, &empty);
+
+  // The one round trip: by its reply the server has processed all four.
+  const Reply<xcb_generic_error_t> error(xcb_request_check(c, remap));
+  if (error != nullptr) {
+    return std::unexpected(
+        Error::platformError("ChangeKeyboardMapping", error->error_code)
+    );
+  }
+  return {};
+}
+
+}  // namespace robot::xcb
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <xcb/xcb.h>
+
+#include <cstdint>
+#include <expected>
+#include <mutex>
+#include <vector>
+
+#include "XcbConnection.h"
+#include "robot/backend/IKeyboardBackend.h"
+
+namespace robot::xcb {
+
+// XTest keyboard injection over XCB. The server's keyboard mapping is read
+// once, at construction, and keysyms resolve to keycodes against that copy
+// (the search XKeysymToKeycode makes), so a key press is one request and no
+// round trip. A layout switched while the session runs is not seen, as with
+// the Xlib backend, which also caches the mapping.
+//
+// typeUnicode binds the character to a keycode the mapping leaves empty, taps
+// it, and empties it again: the same technique as the Xlib backend, but the
+// scratch keycode's original state is already known from the cached mapping,
+// and the remap, the two key events and the restore are sent together with a
+// single round trip at the end to surface any error, instead of a mapping
+// read and three XSyncs.
+class XcbKeyboardBackend final : public backend::IKeyboardBackend {
+ public:
+  explicit XcbKeyboardBackend(const XcbConnection& connection);
+
+  std::expected<void, Error> keyDown(Key key) override;
+  std::expected<void, Error> keyUp(Key key) override;
+  std::expected<void, Error> typeUnicode(char32_t codepoint) override;
+
+ private:
+  std::expected<xcb_keycode_t, Error> resolveKeycode(Key key) const;
+  std::expected<void, Error> fakeKey(Key key, bool down);
+
+  const XcbConnection* connection_;
+  // The mapping read at construction: perCode_ keysyms for each keycode from
+  // minKeycode_ up. Never written afterwards, so read without a lock.
+  xcb_keycode_t minKeycode_ = 0;
+  std::uint8_t perCode_ = 0;
+  std::vector<xcb_keysym_t> keysyms_;
+  // Highest keycode with no keysyms bound, 0 when there is none.
+  xcb_keycode_t scratch_ = 0;
+  // Serializes typeUnicode, whose scratch binding is shared.
+  std::mutex unicodeMutex_;
+};
+
+}  // namespace robot::xcb
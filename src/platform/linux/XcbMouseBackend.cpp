@@ -0,0 +1,115 @@
+#include "XcbMouseBackend.h"
+
+#include <xcb/xtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace robot::xcb {
+namespace {
+
+std::uint8_t coreButton(const MouseButton b) {
+  switch (b) {
+    case MouseButton::Left: return 1;
+    case MouseButton::Middle: return 2;
+    case MouseButton::Right: return 3;
+    case MouseButton::X1: return 8;
+    case MouseButton::X2: return 9;
+  }
+  return 1;
+}
+
+Error noXTest() {
+  return Error::unsupported("the X server has no XTEST extension");
+}
+
+// Coordinates on the wire are 16-bit.
+std::int16_t wireCoordinate(const double v) {
+  return static_cast<std::int16_t>(std::clamp(std::lround(v), -32768L, 32767L));
+}
+
+}  // namespace
+
+std::expected<void, Error> XcbMouseBackend::warpCursor(
+    const LogicalPoint point
+) {
+  if (!connection_->hasXTest()) return std::unexpected(noXTest());
+  xcb_connection_t* c = connection_->connection();
+  // Detail 0 makes the motion absolute, on the given root.
+  xcb_test_fake_input(
+      c, XCB_MOTION_NOTIFY, 0, XCB_CURRENT_TIME, connection_->root(),
+      wireCoordinate(point.x), wireCoordinate(point.y), XCB_NONE
+  );
+  xcb_flush(c);
+  return {};
+}
+
+std::expected<LogicalPoint, Error> XcbMouseBackend::cursorPosition() {
+  xcb_connection_t* c = connection_->connection();
+  const Reply<xcb_query_pointer_reply_t> reply(xcb_query_pointer_reply(
+      c, xcb_query_pointer(c, connection_->root()), nullptr
+  ));
+  if (reply == nullptr) {
+    return std::unexpected(Error::platformError("QueryPointer"));
+  }
+  if (reply->same_screen == 0) {
+    return std::unexpected(
+        Error::platformError("QueryPointer (pointer on another screen)")
+    );
+  }
+  return LogicalPoint{static_cast<double>(reply->root_x),
+                      static_cast<double>(reply->root_y)};
+}
+
+std::expected<void, Error> XcbMouseBackend::button(
+    const MouseButton button, const ButtonAction action, int /*clickCount*/
+) {
+  if (!connection_->hasXTest()) return std::unexpected(noXTest());
+  xcb_connection_t* c = connection_->connection();
+  // X derives double-click from timing between clicks; see the Xlib backend.
+  xcb_test_fake_input(
+      c,
+      action == ButtonAction::Down ? XCB_BUTTON_PRESS : XCB_BUTTON_RELEASE,
+      coreButton(button), XCB_CURRENT_TIME, XCB_NONE, 0, 0, XCB_NONE
+  );
+  xcb_flush(c);
+  return {};
+}
+
+std::expected<void, Error> XcbMouseBackend::scroll(const ScrollDelta delta) {
+  if (delta.unit == ScrollUnit::Pixel) {
+    return std::unexpected(Error::unsupported(
+        "pixel-precise scrolling needs XInput 2.1 scroll valuators, which the "
+        "XCB backend does not drive; use line units or the X11 backend"
+    ));
+  }
+  if (!connection_->hasXTest()) return std::unexpected(noXTest());
+
+  xcb_connection_t* c = connection_->connection();
+  const auto emit = [&](const std::uint8_t btn, const long times) {
+    for (long i = 0; i < times; ++i) {
+      xcb_test_fake_input(
+          c, XCB_BUTTON_PRESS, btn, XCB_CURRENT_TIME, XCB_NONE, 0, 0, XCB_NONE
+      );
+      xcb_test_fake_input(
+          c, XCB_BUTTON_RELEASE, btn, XCB_CURRENT_TIME, XCB_NONE, 0, 0,
+          XCB_NONE
+      );
+    }
+  };
+
+  // Vertical > 0 is up (button 4), < 0 is down (button 5). Horizontal > 0 is
+  // right (button 7), < 0 is left (button 6).
+  const long v = std::lround(std::abs(delta.vertical));
+  const long h = std::lround(std::abs(delta.horizontal));
+  if (delta.vertical > 0) emit(4, v);
+  if (delta.vertical < 0) emit(5, v);
+  if (delta.horizontal > 0) emit(7, h);
+  if (delta.horizontal < 0) emit(6, h);
+
+  xcb_flush(c);
+  return {};
+}
+
+}  // namespace robot::xcb
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "XcbConnection.h"
+#include "robot/backend/IMouseBackend.h"
+
+namespace robot::xcb {
+
+// XTest mouse injection over XCB, in server pixels like the Xlib backend, with
+// the same button numbering (1-3, wheel 4-7, X1/X2 8-9). Injection requests
+// have no reply, so each call costs one write; cursorPosition is the only
+// call here that waits, and it waits on its own cookie, never behind a capture
+// running on another thread.
+//
+// Scrolling is whole wheel notches (buttons 4-7). XInput2 smooth-scroll
+// valuators would need xcb-xinput, so pixel deltas are Unsupported here; the
+// Xlib backend drives them.
+class XcbMouseBackend final : public backend::IMouseBackend {
+ public:
+  explicit XcbMouseBackend(const XcbConnection& connection)
+      : connection_(&connection) {}
+
+  std::expected<void, Error> warpCursor(LogicalPoint point) override;
+  std::expected<LogicalPoint, Error> cursorPosition() override;
+  std::expected<void, Error> button(
+      MouseButton button, ButtonAction action, int clickCount
+  ) override;
+  std::expected<void, Error> scroll(ScrollDelta delta) override;
+
+ private:
+  const XcbConnection* connection_;
+};
+
+}  // namespace robot::xcb
@@ -0,0 +1,49 @@
+#include "XcbPlatformBackend.h"
+
+#include <utility>
+
+#include "X11EventTapBackend.h"
+#include "X11RawEventTapBackend.h"
+#include "XcbBackendFactory.h"
+
+namespace robot::linux_backend {
+
+XcbPlatformBackend::XcbPlatformBackend(
+    xcb::XcbConnection connection, Capabilities capabilities,
+    const X11TapSource tapSource
+)
+    : connection_(std::move(connection)),
+      capabilities_(std::move(capabilities)),
+      keyboard_(std::make_unique<xcb::XcbKeyboardBackend>(connection_)),
+      mouse_(std::make_unique<xcb::XcbMouseBackend>(connection_)),
+      screen_(std::make_unique<xcb::XcbScreenBackend>(connection_)) {
+  const std::string& display = connection_.name();
+  if (tapSource == X11TapSource::RawInput) {
+    eventTap_ = std::make_unique<x11::X11RawEventTapBackend>(display);
+  } else {
+    eventTap_ = std::make_unique<x11::X11EventTapBackend>(display);
+  }
+  // Without XTEST there is no injection at all; without RandR 1.3, no
+  // enumeration. Capture needs only the core protocol.
+  const bool xtest = connection_.hasXTest();
+  capabilities_.canInjectKeyboard = xtest;
+  capabilities_.canInjectMouse = xtest;
+  capabilities_.canTypeUnicode = xtest;
+  capabilities_.canWarpCursor = xtest;
+  capabilities_.supportsExtraMouseButtons = xtest;
+  capabilities_.canEnumerateMonitors = connection_.hasRandr();
+}
+
+std::expected<std::unique_ptr<backend::IPlatformBackend>, Error>
+makeXcbBackend(
+    const std::string& display, Capabilities capabilities,
+    const X11TapSource tapSource
+) {
+  auto connection = xcb::XcbConnection::open(display);
+  if (!connection) return std::unexpected(connection.error());
+  return std::make_unique<XcbPlatformBackend>(
+      std::move(*connection), std::move(capabilities), tapSource
+  );
+}
+
+}  // namespace robot::linux_backend
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <expected>
+#include <memory>
+#include <string>
+
+#include "XcbConnection.h"
+#include "XcbKeyboardBackend.h"
+#include "XcbMouseBackend.h"
+#include "XcbScreenBackend.h"
+#include "robot/Session.h"
+#include "robot/backend/IPlatformBackend.h"
+
+namespace robot::linux_backend {
+
+// The XCB platform assembly: one thread-safe connection shared by keyboard,
+// mouse and screen (see XcbConnection), so unlike the Xlib assembly it needs
+// neither locks nor a second connection for capture. Recording reuses the
+// Xlib taps, XRecord or XInput2 raw events as SessionOptions::x11TapSource
+// selects, on connections of their own to the same display.
+class XcbPlatformBackend final : public backend::IPlatformBackend {
+ public:
+  XcbPlatformBackend(
+      xcb::XcbConnection connection, Capabilities capabilities,
+      X11TapSource tapSource
+  );
+
+  backend::IKeyboardBackend& keyboard() override { return *keyboard_; }
+  backend::IMouseBackend& mouse() override { return *mouse_; }
+  backend::IScreenBackend& screen() override { return *screen_; }
+  backend::IEventTapBackend* eventTap() override { return eventTap_.get(); }
+  const Capabilities& capabilities() const override { return capabilities_; }
+
+ private:
+  xcb::XcbConnection connection_;
+  Capabilities capabilities_;
+  std::unique_ptr<xcb::XcbKeyboardBackend> keyboard_;
+  std::unique_ptr<xcb::XcbMouseBackend> mouse_;
+  std::unique_ptr<xcb::XcbScreenBackend> screen_;
+  std::unique_ptr<backend::IEventTapBackend> eventTap_;
+};
+
+}  // namespace robot::linux_backend
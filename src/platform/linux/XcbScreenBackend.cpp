@@ -0,0 +1,339 @@
+#include "XcbScreenBackend.h"
+
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <xcb/randr.h>
+
+#include <format>
+#include <string>
+#include <utility>
+
+namespace robot::xcb {
+namespace {
+
+// One colour field of a packed pixel, located once per capture rather than
+// rediscovered from the mask for every pixel as the Xlib backend does.
+struct Channel {
+  std::uint32_t mask = 0;
+  int shift = 0;
+  int bits = 0;
+
+  explicit Channel(const std::uint32_t m) : mask(m) {
+    if (m == 0) return;
+    std::uint32_t v = m;
+    while ((v & 1u) == 0) {
+      v >>= 1;
+      ++shift;
+    }
+    while ((v & 1u) != 0) {
+      v >>= 1;
+      ++bits;
+    }
+  }
+
+  [[nodiscard]] std::uint8_t operator()(const std::uint32_t pixel) const {
+    const std::uint32_t v = (pixel & mask) >> shift;
+    if (bits >= 8) return static_cast<std::uint8_t>(v >> (bits - 8));
+    return static_cast<std::uint8_t>(v << (8 - bits));
+  }
+};
+
+// Vertical refresh of a RandR mode: pixel clock over total pixels per frame,
+// with doublescan and interlace adjusting the frame count as in the Xlib
+// backend. 0 when the mode is unknown.
+double modeRefreshRate(
+    const xcb_randr_get_screen_resources_current_reply_t& res,
+    const xcb_randr_mode_t id
+) {
+  const xcb_randr_mode_info_t* modes =
+      xcb_randr_get_screen_resources_current_modes(&res);
+  const int count = xcb_randr_get_screen_resources_current_modes_length(&res);
+  for (int i = 0; i < count; ++i) {
+    const xcb_randr_mode_info_t& mode = modes[i];
+    if (mode.id != id) continue;
+    if (mode.htotal == 0 || mode.vtotal == 0) return 0.0;
+    double vTotal = static_cast<double>(mode.vtotal);
+    if ((mode.mode_flags & XCB_RANDR_MODE_FLAG_DOUBLE_SCAN) != 0) vTotal *= 2.0;
+    if ((mode.mode_flags & XCB_RANDR_MODE_FLAG_INTERLACE) != 0) vTotal /= 2.0;
+    return static_cast<double>(mode.dot_clock) /
+           (static_cast<double>(mode.htotal) * vTotal);
+  }
+  return 0.0;
+}
+
+std::string xError(const char* request, const xcb_generic_error_t* e) {
+  if (e == nullptr) return request;
+  return std::format("{} failed with X error {}", request, e->error_code);
+}
+
+}  // namespace
+
+XcbScreenBackend::XcbScreenBackend(const XcbConnection& connection)
+    : connection_(&connection) {
+  const xcb_setup_t* setup = xcb_get_setup(connection_->connection());
+  const xcb_screen_t& screen = connection_->screen();
+  layout_.msbFirst = setup->image_byte_order == XCB_IMAGE_ORDER_MSB_FIRST;
+
+  const xcb_format_t* formats = xcb_setup_pixmap_formats(setup);
+  const int formatCount = xcb_setup_pixmap_formats_length(setup);
+  for (int i = 0; i < formatCount; ++i) {
+    if (formats[i].depth != screen.root_depth) continue;
+    layout_.bitsPerPixel = formats[i].bits_per_pixel;
+    layout_.scanlinePad = formats[i].scanline_pad;
+  }
+  for (auto d = xcb_screen_allowed_depths_iterator(&screen); d.rem > 0;
+       xcb_depth_next(&d)) {
+    for (auto v = xcb_depth_visuals_iterator(d.data); v.rem > 0;
+         xcb_visualtype_next(&v)) {
+      if (v.data->visual_id != screen.root_visual) continue;
+      layout_.redMask = v.data->red_mask;
+      layout_.greenMask = v.data->green_mask;
+      layout_.blueMask = v.data->blue_mask;
+    }
+  }
+  shmUsable_ = connection_->hasShm() && layout_.scanlinePad != 0;
+}
+
+XcbScreenBackend::~XcbScreenBackend() { releaseSegment(); }
+
+std::expected<std::vector<Monitor>, Error>
+XcbScreenBackend::enumerateMonitors() {
+  if (!connection_->hasRandr()) {
+    return std::unexpected(
+        Error::unsupported("the X server has no RandR 1.3 extension")
+    );
+  }
+  xcb_connection_t* c = connection_->connection();
+  const xcb_window_t root = connection_->root();
+
+  // Round trip one: resources and primary output, requested together.
+  const auto resCookie = xcb_randr_get_screen_resources_current(c, root);
+  const auto primaryCookie = xcb_randr_get_output_primary(c, root);
+  xcb_generic_error_t* rawError = nullptr;
+  const Reply<xcb_randr_get_screen_resources_current_reply_t> res(
+      xcb_randr_get_screen_resources_current_reply(c, resCookie, &rawError)
+  );
+  const Reply<xcb_generic_error_t> resError(rawError);
+  const Reply<xcb_randr_get_output_primary_reply_t> primary(
+      xcb_randr_get_output_primary_reply(c, primaryCookie, nullptr)
+  );
+  if (res == nullptr) {
+    return std::unexpected(Error::platformError(
+        xError("RRGetScreenResourcesCurrent", resError.get())
+    ));
+  }
+  const xcb_randr_output_t primaryOutput =
+      primary != nullptr ? primary->output : XCB_NONE;
+
+  // Round trip two: every CRTC's info is in flight before the first reply is
+  // read.
+  const xcb_randr_crtc_t* crtcs =
+      xcb_randr_get_screen_resources_current_crtcs(res.get());
+  const int crtcCount =
+      xcb_randr_get_screen_resources_current_crtcs_length(res.get());
+  std::vector<xcb_randr_get_crtc_info_cookie_t> cookies;
+  cookies.reserve(static_cast<std::size_t>(crtcCount));
+  for (int i = 0; i < crtcCount; ++i) {
+    cookies.push_back(
+        xcb_randr_get_crtc_info(c, crtcs[i], res->config_timestamp)
+    );
+  }
+
+  std::vector<Monitor> monitors;
+  for (int i = 0; i < crtcCount; ++i) {
+    const Reply<xcb_randr_get_crtc_info_reply_t> crtc(
+        xcb_randr_get_crtc_info_reply(
+            c, cookies[static_cast<std::size_t>(i)], nullptr
+        )
+    );
+    // A CRTC with zero mode or no outputs is disconnected; skip it.
+    if (crtc == nullptr || crtc->mode == XCB_NONE || crtc->num_outputs == 0 ||
+        crtc->width == 0 || crtc->height == 0) {
+      continue;
+    }
+    Monitor m;
+    m.id = static_cast<std::uint32_t>(monitors.size() + 1);
+    m.name = std::format("CRTC {}", i);
+    m.isPrimary =
+        xcb_randr_get_crtc_info_outputs(crtc.get())[0] == primaryOutput;
+    m.scaleFactor = 1.0;  // X core exposes no per-monitor logical scale.
+    m.refreshRate = modeRefreshRate(*res, crtc->mode);
+    m.physicalBounds = PhysicalRect{
+        {crtc->x, crtc->y},
+        {static_cast<std::int32_t>(crtc->width),
+         static_cast<std::int32_t>(crtc->height)}};
+    m.logicalBounds = LogicalRect{
+        {static_cast<double>(crtc->x), static_cast<double>(crtc->y)},
+        {static_cast<double>(crtc->width), static_cast<double>(crtc->height)}};
+    monitors.push_back(m);
+  }
+
+  if (monitors.empty()) {
+    return std::unexpected(Error::platformError("no active CRTCs via RandR"));
+  }
+  return monitors;
+}
+
+std::expected<Image, Error> XcbScreenBackend::captureRegion(
+    const PhysicalRect region
+) {
+  if (region.size.width <= 0 || region.size.height <= 0 ||
+      region.size.width > 0xffff || region.size.height > 0xffff) {
+    return std::unexpected(Error::invalidArgument(std::format(
+        "capture region {}x{} is outside what the X protocol can express",
+        region.size.width, region.size.height
+    )));
+  }
+  if (shmUsable_.load()) {
+    auto image = captureShared(region);
+    // A failure that disabled MIT-SHM falls through to plain GetImage.
+    if (image || shmUsable_.load()) return image;
+  }
+  return captureCore(region);
+}
+
+std::expected<Image, Error> XcbScreenBackend::captureShared(
+    const PhysicalRect region
+) {
+  const std::size_t stride =
+      (static_cast<std::size_t>(region.size.width) * layout_.bitsPerPixel +
+       layout_.scanlinePad - 1) /
+      layout_.scanlinePad * layout_.scanlinePad / 8;
+  const std::size_t bytes =
+      stride * static_cast<std::size_t>(region.size.height);
+
+  const std::lock_guard lock(segmentMutex_);
+  if (!reserveSegment(bytes)) {
+    shmUsable_ = false;
+    return std::unexpected(Error::captureFailed("MIT-SHM segment unavailable"));
+  }
+  xcb_connection_t* c = connection_->connection();
+  xcb_generic_error_t* rawError = nullptr;
+  const Reply<xcb_shm_get_image_reply_t> reply(xcb_shm_get_image_reply(
+      c,
+      xcb_shm_get_image(
+          c, connection_->root(), static_cast<std::int16_t>(region.origin.x),
+          static_cast<std::int16_t>(region.origin.y),
+          static_cast<std::uint16_t>(region.size.width),
+          static_cast<std::uint16_t>(region.size.height), ~0u,
+          XCB_IMAGE_FORMAT_Z_PIXMAP, segment_, 0
+      ),
+      &rawError
+  ));
+  const Reply<xcb_generic_error_t> error(rawError);
+  if (reply == nullptr) {
+    return std::unexpected(
+        Error::captureFailed(xError("ShmGetImage", error.get()))
+    );
+  }
+  return decode(static_cast<const std::uint8_t*>(shmAddr_), bytes, region.size);
+}
+
+std::expected<Image, Error> XcbScreenBackend::captureCore(
+    const PhysicalRect region
+) {
+  xcb_connection_t* c = connection_->connection();
+  xcb_generic_error_t* rawError = nullptr;
+  const Reply<xcb_get_image_reply_t> reply(xcb_get_image_reply(
+      c,
+      xcb_get_image(
+          c, XCB_IMAGE_FORMAT_Z_PIXMAP, connection_->root(),
+          static_cast<std::int16_t>(region.origin.x),
+          static_cast<std::int16_t>(region.origin.y),
+          static_cast<std::uint16_t>(region.size.width),
+          static_cast<std::uint16_t>(region.size.height), ~0u
+      ),
+      &rawError
+  ));
+  const Reply<xcb_generic_error_t> error(rawError);
+  if (reply == nullptr) {
+    return std::unexpected(
+        Error::captureFailed(xError("GetImage", error.get()))
+    );
+  }
+  return decode(
+      xcb_get_image_data(reply.get()),
+      static_cast<std::size_t>(xcb_get_image_data_length(reply.get())),
+      region.size
+  );
+}
+
+std::expected<Image, Error> XcbScreenBackend::decode(
+    const std::uint8_t* data, const std::size_t bytes, const PhysicalSize size
+) const {
+  const unsigned bpp = layout_.bitsPerPixel;
+  if (bpp < 16 || bpp > 32 || bpp % 8 != 0) {
+    return std::unexpected(Error::captureFailed(std::format(
+        "unsupported root pixel format: {} bits per pixel", bpp
+    )));
+  }
+  const std::size_t w = static_cast<std::size_t>(size.width);
+  const std::size_t h = static_cast<std::size_t>(size.height);
+  const std::size_t stride =
+      (w * bpp + layout_.scanlinePad - 1) / layout_.scanlinePad *
+      layout_.scanlinePad / 8;
+  if (bytes < stride * h) {
+    return std::unexpected(Error::captureFailed("short image from X server"));
+  }
+
+  const std::size_t pixelBytes = bpp / 8;
+  const Channel red(layout_.redMask);
+  const Channel green(layout_.greenMask);
+  const Channel blue(layout_.blueMask);
+  std::vector<Rgba> pixels(w * h);
+  for (std::size_t y = 0; y < h; ++y) {
+    const std::uint8_t* row = data + y * stride;
+    for (std::size_t x = 0; x < w; ++x) {
+      const std::uint8_t* p = row + x * pixelBytes;
+      std::uint32_t value = 0;
+      for (std::size_t b = 0; b < pixelBytes; ++b) {
+        const std::size_t shift = layout_.msbFirst ? pixelBytes - 1 - b : b;
+        value |= static_cast<std::uint32_t>(p[b]) << (8 * shift);
+      }
+      pixels[y * w + x] = Rgba{red(value), green(value), blue(value), 255};
+    }
+  }
+  return Image{size, std::move(pixels)};
+}
+
+bool XcbScreenBackend::reserveSegment(const std::size_t bytes) {
+  if (shmAddr_ != nullptr && bytes <= shmSize_) return true;
+  releaseSegment();
+
+  const int id = shmget(IPC_PRIVATE, bytes, IPC_CREAT | 0600);
+  if (id < 0) return false;
+  void* addr = shmat(id, nullptr, 0);
+  if (addr == reinterpret_cast<void*>(-1)) {
+    shmctl(id, IPC_RMID, nullptr);
+    return false;
+  }
+  xcb_connection_t* c = connection_->connection();
+  const xcb_shm_seg_t segment = xcb_generate_id(c);
+  const Reply<xcb_generic_error_t> error(
+      xcb_request_check(c, xcb_shm_attach_checked(c, segment, id, 0))
+  );
+  // Marked for removal once both sides are attached (or the server failed
+  // to), so the segment cannot outlive the process.
+  shmctl(id, IPC_RMID, nullptr);
+  if (error != nullptr) {
+    shmdt(addr);
+    return false;
+  }
+  segment_ = segment;
+  shmAddr_ = addr;
+  shmSize_ = bytes;
+  return true;
+}
+
+void XcbScreenBackend::releaseSegment() {
+  if (shmAddr_ == nullptr) return;
+  xcb_connection_t* c = connection_->connection();
+  xcb_shm_detach(c, segment_);
+  xcb_flush(c);
+  shmdt(shmAddr_);
+  segment_ = 0;
+  shmAddr_ = nullptr;
+  shmSize_ = 0;
+}
+
+}  // namespace robot::xcb
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <xcb/shm.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+#include "XcbConnection.h"
+#include "robot/backend/IScreenBackend.h"
+
+namespace robot::xcb {
+
+// RandR enumeration and capture over XCB, reporting what the Xlib screen
+// backend reports (one pixel grid, scaleFactor 1.0, RandR CRTC bounds).
+//
+// Enumeration is pipelined: the screen resources and the primary output are
+// requested together, then every CRTC's GetCrtcInfo is issued before the
+// first reply is read, so it costs two round trips however many CRTCs there
+// are, where XRRGetCrtcInfo costs one each. It also reads the current
+// configuration (GetScreenResourcesCurrent) rather than making the server
+// re-probe its outputs.
+//
+// Capture goes through MIT-SHM when the server offers it: the server writes
+// the pixels into a shared segment instead of the reply stream, and the
+// segment is kept between captures and grown as needed. A server that cannot
+// attach it (a remote display) is remembered and served by plain GetImage.
+class XcbScreenBackend final : public backend::IScreenBackend {
+ public:
+  explicit XcbScreenBackend(const XcbConnection& connection);
+  ~XcbScreenBackend() override;
+
+  XcbScreenBackend(const XcbScreenBackend&) = delete;
+  XcbScreenBackend& operator=(const XcbScreenBackend&) = delete;
+
+  std::expected<std::vector<Monitor>, Error> enumerateMonitors() override;
+  std::expected<Image, Error> captureRegion(PhysicalRect region) override;
+
+ private:
+  // How the root window's ZPixmap images are laid out.
+  struct PixelLayout {
+    std::uint8_t bitsPerPixel = 0;
+    std::uint8_t scanlinePad = 0;
+    bool msbFirst = false;
+    std::uint32_t redMask = 0;
+    std::uint32_t greenMask = 0;
+    std::uint32_t blueMask = 0;
+  };
+
+  std::expected<Image, Error> captureShared(PhysicalRect region);
+  std::expected<Image, Error> captureCore(PhysicalRect region);
+  std::expected<Image, Error> decode(
+      const std::uint8_t* data, std::size_t bytes, PhysicalSize size
+  ) const;
+  // Make the segment hold at least bytes; false when MIT-SHM is unusable.
+  bool reserveSegment(std::size_t bytes);
+  void releaseSegment();
+
+  const XcbConnection* connection_;
+  PixelLayout layout_;
+  std::atomic<bool> shmUsable_{false};
+
+  // The shared segment, guarded by segmentMutex_ for the whole capture.
+  std::mutex segmentMutex_;
+  xcb_shm_seg_t segment_ = 0;
+  void* shmAddr_ = nullptr;
+  std::size_t shmSize_ = 0;
+};
+
+}  // namespace robot::xcb
@@ -0,0 +1,17 @@
+#include "XcbBackendFactory.h"
+
+namespace robot::linux_backend {
+
+std::expected<std::unique_ptr<backend::IPlatformBackend>, Error>
+makeXcbBackend(
+    const std::string& /*display*/, Capabilities /*capabilities*/,
+    X11TapSource /*tapSource*/
+) {
+  return std::unexpected(Error::unsupported(
+      "this build of robot-cpp has no XCB backend; configure with "
+      "-DROBOT_LINUX_ENABLE_XCB=ON (needs the xcb, xcb-xtest, xcb-shm and "
+      "xcb-randr development files)"
+  ));
+}
+
+}  // namespace robot::linux_backend
@@ -1,5 +1,6 @@
 #include "MacEventTapBackend.h"
 
+#include <chrono>
 #include <cmath>
 
 #include "MacKeyMap.h"
@@ -34,12 +35,28 @@ CGEventRef MacEventTapBackend::callback(
   }
 
   self->handle(type, event);
+  self->batcher_->idle(tap::Batcher::Clock::now());
   return event;  // Listen-only tap; the event passes through unchanged.
 }
 
+void MacEventTapBackend::timerCallback(
+    CFRunLoopTimerRef /*timer*/, void* info
+) {
+  static_cast<MacEventTapBackend*>(info)->batcher_->idle(
+      tap::Batcher::Clock::now()
+  );
+}
+
 void MacEventTapBackend::handle(const CGEventType type, CGEventRef event) {
   const CGPoint loc = CGEventGetLocation(event);
   const LogicalPoint position{loc.x, loc.y};
+  // CGEventTimestamp is nanoseconds of system uptime on the same mach clock
+  // steady_clock reads on macOS, so it converts without an offset.
+  const std::chrono::steady_clock::time_point at{
+      std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+          std::chrono::nanoseconds(CGEventGetTimestamp(event))
+      )};
+  const auto emit = [&](const InputEvent& e) { batcher_->push({at, e}); };
 
   switch (type) {
     case kCGEventKeyDown:
@@ -49,7 +66,7 @@ void MacEventTapBackend::handle(const CGEventType type, CGEventRef event) {
       );
       const Key key = macKeycodeToKey(code);
       if (key != Key::Unknown) {
-        sink_(KeyEvent{key, type == kCGEventKeyDown});
+        emit(KeyEvent{key, type == kCGEventKeyDown});
       }
       break;
     }
@@ -67,7 +84,7 @@ void MacEventTapBackend::handle(const CGEventType type, CGEventRef event) {
         } else {
           heldModifiers_.erase(key);
         }
-        sink_(KeyEvent{key, nowDown});
+        emit(KeyEvent{key, nowDown});
       }
       break;
     }
@@ -75,26 +92,26 @@ void MacEventTapBackend::handle(const CGEventType type, CGEventRef event) {
     case kCGEventLeftMouseDragged:
     case kCGEventRightMouseDragged:
     case kCGEventOtherMouseDragged:
-      sink_(MouseMoveEvent{position});
+      emit(MouseMoveEvent{position});
       break;
     case kCGEventLeftMouseDown:
-      sink_(MouseButtonEvent{MouseButton::Left, true, position});
+      emit(MouseButtonEvent{MouseButton::Left, true, position});
       break;
     case kCGEventLeftMouseUp:
-      sink_(MouseButtonEvent{MouseButton::Left, false, position});
+      emit(MouseButtonEvent{MouseButton::Left, false, position});
       break;
     case kCGEventRightMouseDown:
-      sink_(MouseButtonEvent{MouseButton::Right, true, position});
+      emit(MouseButtonEvent{MouseButton::Right, true, position});
       break;
     case kCGEventRightMouseUp:
-      sink_(MouseButtonEvent{MouseButton::Right, false, position});
+      emit(MouseButtonEvent{MouseButton::Right, false, position});
       break;
     case kCGEventOtherMouseDown:
     case kCGEventOtherMouseUp: {
       const std::int64_t num =
           CGEventGetIntegerValueField(event, kCGMouseEventButtonNumber);
-      sink_(MouseButtonEvent{otherButton(num),
-                             type == kCGEventOtherMouseDown, position});
+      emit(MouseButtonEvent{otherButton(num), type == kCGEventOtherMouseDown,
+                            position});
       break;
     }
     case kCGEventScrollWheel: {
@@ -104,7 +121,7 @@ void MacEventTapBackend::handle(const CGEventType type, CGEventRef event) {
       const auto h = static_cast<double>(
           CGEventGetIntegerValueField(event, kCGScrollWheelEventDeltaAxis2)
       );
-      sink_(ScrollEvent{ScrollDelta::lines(v, h), position});
+      emit(ScrollEvent{ScrollDelta::lines(v, h), position});
       break;
     }
     default:
@@ -112,24 +129,35 @@ void MacEventTapBackend::handle(const CGEventType type, CGEventRef event) {
   }
 }
 
-std::expected<void, Error> MacEventTapBackend::start(EventSink sink) {
-  sink_ = std::move(sink);
+std::expected<void, Error> MacEventTapBackend::start(
+    EventBatchSink sink, const TapOptions& options
+) {
+  batcher_.emplace(std::move(sink), options);
   heldModifiers_.clear();
 
-  const CGEventMask mask =
-      CGEventMaskBit(kCGEventKeyDown) | CGEventMaskBit(kCGEventKeyUp) |
-      CGEventMaskBit(kCGEventFlagsChanged) |
-      CGEventMaskBit(kCGEventMouseMoved) |
-      CGEventMaskBit(kCGEventLeftMouseDown) |
-      CGEventMaskBit(kCGEventLeftMouseUp) |
-      CGEventMaskBit(kCGEventRightMouseDown) |
-      CGEventMaskBit(kCGEventRightMouseUp) |
-      CGEventMaskBit(kCGEventOtherMouseDown) |
-      CGEventMaskBit(kCGEventOtherMouseUp) |
-      CGEventMaskBit(kCGEventLeftMouseDragged) |
-      CGEventMaskBit(kCGEventRightMouseDragged) |
-      CGEventMaskBit(kCGEventOtherMouseDragged) |
-      CGEventMaskBit(kCGEventScrollWheel);
+  // Subscribe only to the categories the filter wants; the window server then
+  // never wakes this process for the rest.
+  const EventFilter& filter = options.filter;
+  CGEventMask mask = 0;
+  if (filter.keys) {
+    mask |= CGEventMaskBit(kCGEventKeyDown) | CGEventMaskBit(kCGEventKeyUp) |
+            CGEventMaskBit(kCGEventFlagsChanged);
+  }
+  if (filter.motion) {
+    mask |= CGEventMaskBit(kCGEventMouseMoved) |
+            CGEventMaskBit(kCGEventLeftMouseDragged) |
+            CGEventMaskBit(kCGEventRightMouseDragged) |
+            CGEventMaskBit(kCGEventOtherMouseDragged);
+  }
+  if (filter.buttons) {
+    mask |= CGEventMaskBit(kCGEventLeftMouseDown) |
+            CGEventMaskBit(kCGEventLeftMouseUp) |
+            CGEventMaskBit(kCGEventRightMouseDown) |
+            CGEventMaskBit(kCGEventRightMouseUp) |
+            CGEventMaskBit(kCGEventOtherMouseDown) |
+            CGEventMaskBit(kCGEventOtherMouseUp);
+  }
+  if (filter.scroll) mask |= CGEventMaskBit(kCGEventScrollWheel);
 
   // Listen-only: observe without modifying the stream. Still requires
   // Accessibility, so a null tap means permission was withheld.
@@ -149,11 +177,28 @@ std::expected<void, Error> MacEventTapBackend::start(EventSink sink) {
   CFRunLoopAddSource(loop, source_, kCFRunLoopCommonModes);
   CGEventTapEnable(tap_, true);
 
+  CFRunLoopTimerRef timer = nullptr;
+  if (options.maxLatency.count() > 0) {
+    const double period =
+        std::chrono::duration<double>(options.maxLatency).count();
+    CFRunLoopTimerContext context{0, this, nullptr, nullptr, nullptr};
+    timer = CFRunLoopTimerCreate(
+        kCFAllocatorDefault, CFAbsoluteTimeGetCurrent() + period, period, 0, 0,
+        &MacEventTapBackend::timerCallback, &context
+    );
+    CFRunLoopAddTimer(loop, timer, kCFRunLoopCommonModes);
+  }
+
   running_.store(true);
   CFRunLoopRun();  // Blocks until stop() calls CFRunLoopStop from another thread.
 
   // Teardown after the loop exits.
   running_.store(false);
+  if (timer != nullptr) {
+    CFRunLoopTimerInvalidate(timer);
+    CFRelease(timer);
+  }
+  batcher_->flush();
   CGEventTapEnable(tap_, false);
   CFRunLoopRemoveSource(loop, source_, kCFRunLoopCommonModes);
   CFRelease(source_);
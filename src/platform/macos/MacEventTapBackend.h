@@ -3,8 +3,10 @@
 #include <ApplicationServices/ApplicationServices.h>
 
 #include <atomic>
+#include <optional>
 #include <set>
 
+#include "common/TapBatcher.h"
 #include "robot/Key.h"
 #include "robot/backend/IEventTapBackend.h"
 
@@ -24,7 +26,9 @@ class MacEventTapBackend final : public backend::IEventTapBackend {
   MacEventTapBackend(const MacEventTapBackend&) = delete;
   MacEventTapBackend& operator=(const MacEventTapBackend&) = delete;
 
-  std::expected<void, Error> start(EventSink sink) override;
+  std::expected<void, Error> start(
+      EventBatchSink sink, const TapOptions& options
+  ) override;
   void stop() override;
   [[nodiscard]] bool isRunning() const override { return running_.load(); }
 
@@ -32,9 +36,12 @@ class MacEventTapBackend final : public backend::IEventTapBackend {
   static CGEventRef callback(
       CGEventTapProxy proxy, CGEventType type, CGEventRef event, void* userInfo
   );
+  static void timerCallback(CFRunLoopTimerRef timer, void* info);
   void handle(CGEventType type, CGEventRef event);
 
-  EventSink sink_;
+  // Fed on the run loop thread: one tap callback is one read from the OS, and
+  // a repeating timer delivers batches held past the latency allowance.
+  std::optional<tap::Batcher> batcher_;
   // Modifier keys currently held, toggled on each flags-changed event so a
   // physical modifier's down/up is tracked per key without relying on flag bits
   // that cannot distinguish left from right.
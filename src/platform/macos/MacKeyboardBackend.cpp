@@ -52,6 +52,7 @@ std::expected<void, Error> MacKeyboardBackend::postKey(
 
   // Update held-modifier state before computing flags so a modifier's own event
   // carries (down) or clears (up) its flag consistently.
+  const std::lock_guard lock(mutex_);
   if (isModifierKey(key)) {
     if (down) {
       heldModifiers_.insert(key);
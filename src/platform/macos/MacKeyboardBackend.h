@@ -2,6 +2,7 @@
 
 #include <ApplicationServices/ApplicationServices.h>
 
+#include <mutex>
 #include <set>
 
 #include "robot/Key.h"
@@ -31,6 +32,7 @@ class MacKeyboardBackend final : public backend::IKeyboardBackend {
   [[nodiscard]] CGEventFlags currentFlags() const;
 
   CGEventSourceRef source_ = nullptr;
+  std::mutex mutex_;  // Any thread may post keys; held under postKey().
   std::set<Key> heldModifiers_;
 };
 
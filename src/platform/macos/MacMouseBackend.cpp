@@ -60,6 +60,7 @@ std::expected<void, Error> MacMouseBackend::warpCursor(const LogicalPoint point)
 
   // While a button is held, a move must be posted as that button's drag event or
   // the target application will not treat the gesture as a drag.
+  const std::lock_guard lock(mutex_);
   const CGEventType type =
       pressedButton_ ? dragType(*pressedButton_) : kCGEventMouseMoved;
   const CGMouseButton btn =
@@ -104,6 +105,7 @@ std::expected<void, Error> MacMouseBackend::button(
   CGEventPost(kCGHIDEventTap, event);
   CFRelease(event);
 
+  const std::lock_guard lock(mutex_);
   if (down) {
     pressedButton_ = button;
   } else {
@@ -2,6 +2,7 @@
 
 #include <ApplicationServices/ApplicationServices.h>
 
+#include <mutex>
 #include <optional>
 
 #include "robot/backend/IMouseBackend.h"
@@ -29,6 +30,7 @@ class MacMouseBackend final : public backend::IMouseBackend {
 
  private:
   CGEventSourceRef source_ = nullptr;
+  std::mutex mutex_;  // Guards pressedButton_ across concurrent callers.
   std::optional<MouseButton> pressedButton_;
 };
 
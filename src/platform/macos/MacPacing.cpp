@@ -0,0 +1,28 @@
+#include <pthread.h>
+#include <pthread/qos.h>
+
+#include <thread>
+
+#include "common/Pacing.h"
+
+// macOS pacing primitives. There is no absolute monotonic sleep in the POSIX
+// layer, so sleeping stays with sleep_until; priority uses QoS classes, which
+// need no privilege and are what the scheduler's timer coalescing honours.
+namespace robot::pacing {
+
+void sleepUntil(const Clock::time_point deadline) {
+  std::this_thread::sleep_until(deadline);
+}
+
+ScopedPriorityBoost::ScopedPriorityBoost(const bool enable) {
+  if (!enable) return;
+  savedPolicy_ = static_cast<int>(qos_class_self());
+  raised_ = pthread_set_qos_class_self_np(QOS_CLASS_USER_INTERACTIVE, 0) == 0;
+}
+
+ScopedPriorityBoost::~ScopedPriorityBoost() {
+  if (!raised_) return;
+  pthread_set_qos_class_self_np(static_cast<qos_class_t>(savedPolicy_), 0);
+}
+
+}  // namespace robot::pacing
@@ -21,6 +21,16 @@ double displayScale(const CGDirectDisplayID id) {
   return px / pt;
 }
 
+// The current mode's refresh in Hz. Built-in panels commonly report 0, which is
+// passed through as "unknown" rather than guessed.
+double displayRefreshRate(const CGDirectDisplayID id) {
+  CGDisplayModeRef mode = CGDisplayCopyDisplayMode(id);
+  if (mode == nullptr) return 0.0;
+  const double rate = CGDisplayModeGetRefreshRate(mode);
+  CGDisplayModeRelease(mode);
+  return rate;
+}
+
 // Draw a CGImage into a canonical straight-RGBA8 buffer and hand back an Image
 // sized to the image's actual pixel dimensions. Rgba is four contiguous bytes in
 // R,G,B,A order, which is exactly the layout a big-endian alpha-last bitmap
@@ -123,6 +133,7 @@ MacScreenBackend::enumerate() {
     m.name = std::format("Display {}", static_cast<std::uint32_t>(id));
     m.isPrimary = CGDisplayIsMain(id) != 0;
     m.scaleFactor = scale;
+    m.refreshRate = displayRefreshRate(id);
     m.logicalBounds = LogicalRect{
         {b.origin.x, b.origin.y}, {b.size.width, b.size.height}};
     m.physicalBounds = PhysicalRect{
@@ -0,0 +1,73 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <string>
+
+#include "common/MappedFile.h"
+
+// mmap-based MappedFile, shared by the Linux and macOS builds.
+namespace robot::mapping {
+namespace {
+
+std::size_t pageSize() {
+  static const auto size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+  return size;
+}
+
+}  // namespace
+
+std::expected<MappedFile, Error> MappedFile::open(const std::string_view path) {
+  const std::string p{path};
+  const int fd = ::open(p.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return std::unexpected(Error::ioError("cannot open " + p));
+  }
+  struct stat st {};
+  if (fstat(fd, &st) != 0) {
+    ::close(fd);
+    return std::unexpected(Error::ioError("cannot stat " + p));
+  }
+  const auto size = static_cast<std::size_t>(st.st_size);
+  if (size == 0) {
+    ::close(fd);
+    return MappedFile(nullptr, 0);
+  }
+
+  void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // The mapping holds its own reference to the file.
+  ::close(fd);
+  if (data == MAP_FAILED) {
+    return std::unexpected(Error::platformError("mmap", errno));
+  }
+  return MappedFile(static_cast<const std::uint8_t*>(data), size);
+}
+
+void MappedFile::adviseSequential() const {
+  if (data_ == nullptr) return;
+  madvise(const_cast<std::uint8_t*>(data_), size_, MADV_SEQUENTIAL);
+}
+
+void MappedFile::release(
+    const std::size_t offset, const std::size_t length
+) const {
+  if (data_ == nullptr || offset >= size_) return;
+  // madvise works on whole pages: round the range inwards so a page still
+  // partly ahead of the reader is kept.
+  const std::size_t page = pageSize();
+  const std::size_t begin = (offset + page - 1) / page * page;
+  const std::size_t end = std::min(offset + length, size_) / page * page;
+  if (begin >= end) return;
+  madvise(const_cast<std::uint8_t*>(data_ + begin), end - begin, MADV_DONTNEED);
+}
+
+void MappedFile::unmap() {
+  if (data_ != nullptr) munmap(const_cast<std::uint8_t*>(data_), size_);
+  data_ = nullptr;
+  size_ = 0;
+}
+
+}  // namespace robot::mapping
@@ -1,5 +1,6 @@
 #include "WinEventTapBackend.h"
 
+#include <chrono>
 #include <cmath>
 
 #include "WinKeyMap.h"
@@ -26,6 +27,14 @@ LogicalPoint toLogical(const POINT p) {
                       static_cast<double>(p.y) / scale};
 }
 
+// The hook structs' own time field is GetTickCount milliseconds, which only
+// advances every 10-16 ms. The system calls a low-level hook synchronously as
+// it dispatches the input, so the callback's steady-clock reading is the finer
+// stamp.
+std::chrono::steady_clock::time_point eventTime() {
+  return std::chrono::steady_clock::now();
+}
+
 }  // namespace
 
 LRESULT CALLBACK WinEventTapBackend::mouseProc(
@@ -33,6 +42,7 @@ LRESULT CALLBACK WinEventTapBackend::mouseProc(
 ) {
   if (code == HC_ACTION && g_active != nullptr) {
     g_active->onMouse(wParam, *reinterpret_cast<MSLLHOOKSTRUCT*>(lParam));
+    g_active->batcher_->idle(tap::Batcher::Clock::now());
   }
   return CallNextHookEx(nullptr, code, wParam, lParam);
 }
@@ -42,6 +52,7 @@ LRESULT CALLBACK WinEventTapBackend::keyboardProc(
 ) {
   if (code == HC_ACTION && g_active != nullptr) {
     g_active->onKeyboard(wParam, *reinterpret_cast<KBDLLHOOKSTRUCT*>(lParam));
+    g_active->batcher_->idle(tap::Batcher::Clock::now());
   }
   return CallNextHookEx(nullptr, code, wParam, lParam);
 }
@@ -50,46 +61,47 @@ void WinEventTapBackend::onMouse(
     const WPARAM wParam, const MSLLHOOKSTRUCT& data
 ) {
   const LogicalPoint pos = toLogical(data.pt);
+  const auto emit = [&](const InputEvent& e) { batcher_->push({eventTime(), e}); };
   switch (wParam) {
     case WM_MOUSEMOVE:
-      sink_(MouseMoveEvent{pos});
+      emit(MouseMoveEvent{pos});
       break;
     case WM_LBUTTONDOWN:
-      sink_(MouseButtonEvent{MouseButton::Left, true, pos});
+      emit(MouseButtonEvent{MouseButton::Left, true, pos});
       break;
     case WM_LBUTTONUP:
-      sink_(MouseButtonEvent{MouseButton::Left, false, pos});
+      emit(MouseButtonEvent{MouseButton::Left, false, pos});
       break;
     case WM_RBUTTONDOWN:
-      sink_(MouseButtonEvent{MouseButton::Right, true, pos});
+      emit(MouseButtonEvent{MouseButton::Right, true, pos});
       break;
     case WM_RBUTTONUP:
-      sink_(MouseButtonEvent{MouseButton::Right, false, pos});
+      emit(MouseButtonEvent{MouseButton::Right, false, pos});
       break;
     case WM_MBUTTONDOWN:
-      sink_(MouseButtonEvent{MouseButton::Middle, true, pos});
+      emit(MouseButtonEvent{MouseButton::Middle, true, pos});
       break;
     case WM_MBUTTONUP:
-      sink_(MouseButtonEvent{MouseButton::Middle, false, pos});
+      emit(MouseButtonEvent{MouseButton::Middle, false, pos});
       break;
     case WM_XBUTTONDOWN:
     case WM_XBUTTONUP: {
       const WORD which = GET_XBUTTON_WPARAM(data.mouseData);
       const MouseButton b =
           which == XBUTTON1 ? MouseButton::X1 : MouseButton::X2;
-      sink_(MouseButtonEvent{b, wParam == WM_XBUTTONDOWN, pos});
+      emit(MouseButtonEvent{b, wParam == WM_XBUTTONDOWN, pos});
       break;
     }
     case WM_MOUSEWHEEL: {
       const short raw = GET_WHEEL_DELTA_WPARAM(data.mouseData);
-      sink_(ScrollEvent{ScrollDelta::lines(
+      emit(ScrollEvent{ScrollDelta::lines(
                             static_cast<double>(raw) / WHEEL_DELTA, 0.0),
                         pos});
       break;
     }
     case WM_MOUSEHWHEEL: {
       const short raw = GET_WHEEL_DELTA_WPARAM(data.mouseData);
-      sink_(ScrollEvent{ScrollDelta::lines(
+      emit(ScrollEvent{ScrollDelta::lines(
                             0.0, static_cast<double>(raw) / WHEEL_DELTA),
                         pos});
       break;
@@ -109,24 +121,36 @@ void WinEventTapBackend::onKeyboard(
   const bool extended = (data.flags & LLKHF_EXTENDED) != 0;
   const Key key = scanCodeToKey(static_cast<WORD>(data.scanCode), extended);
   if (key != Key::Unknown) {
-    sink_(KeyEvent{key, down});
+    batcher_->push({eventTime(), KeyEvent{key, down}});
   }
 }
 
-std::expected<void, Error> WinEventTapBackend::start(EventSink sink) {
+std::expected<void, Error> WinEventTapBackend::start(
+    EventBatchSink sink, const TapOptions& options
+) {
   if (g_active != nullptr) {
     return std::unexpected(
         Error::unsupported("an event tap is already running in this process")
     );
   }
-  sink_ = std::move(sink);
+  batcher_.emplace(std::move(sink), options);
   g_active = this;
   threadId_ = GetCurrentThreadId();
 
+  // A hook whose categories the filter excludes is never installed: every
+  // low-level hook sits in the system's input path, so an unneeded one costs
+  // the whole desktop a context switch per event.
+  const EventFilter& filter = options.filter;
+  const bool wantMouse = filter.motion || filter.buttons || filter.scroll;
   const HINSTANCE mod = GetModuleHandleW(nullptr);
-  mouseHook_ = SetWindowsHookExW(WH_MOUSE_LL, &mouseProc, mod, 0);
-  keyboardHook_ = SetWindowsHookExW(WH_KEYBOARD_LL, &keyboardProc, mod, 0);
-  if (mouseHook_ == nullptr || keyboardHook_ == nullptr) {
+  if (wantMouse) {
+    mouseHook_ = SetWindowsHookExW(WH_MOUSE_LL, &mouseProc, mod, 0);
+  }
+  if (filter.keys) {
+    keyboardHook_ = SetWindowsHookExW(WH_KEYBOARD_LL, &keyboardProc, mod, 0);
+  }
+  if ((wantMouse && mouseHook_ == nullptr) ||
+      (filter.keys && keyboardHook_ == nullptr)) {
     if (mouseHook_ != nullptr) UnhookWindowsHookEx(mouseHook_);
     if (keyboardHook_ != nullptr) UnhookWindowsHookEx(keyboardHook_);
     mouseHook_ = nullptr;
@@ -137,19 +161,34 @@ std::expected<void, Error> WinEventTapBackend::start(EventSink sink) {
     ));
   }
 
+  // A thread timer (no window) for batches held by the latency allowance.
+  // USER_TIMER_MINIMUM clamps the period to about 10 ms.
+  UINT_PTR timer = 0;
+  if (options.maxLatency.count() > 0) {
+    const auto period =
+        std::chrono::ceil<std::chrono::milliseconds>(options.maxLatency);
+    timer = SetTimer(nullptr, 0, static_cast<UINT>(period.count()), nullptr);
+  }
+
   running_.store(true);
 
   // Low-level hooks require a message loop on the installing thread to be
   // dispatched. Block here until stop() posts WM_QUIT to this thread.
   MSG msg;
   while (GetMessageW(&msg, nullptr, 0, 0) > 0) {
+    if (msg.message == WM_TIMER && msg.hwnd == nullptr) {
+      batcher_->idle(tap::Batcher::Clock::now());
+      continue;
+    }
     TranslateMessage(&msg);
     DispatchMessageW(&msg);
   }
 
   running_.store(false);
-  UnhookWindowsHookEx(mouseHook_);
-  UnhookWindowsHookEx(keyboardHook_);
+  if (timer != 0) KillTimer(nullptr, timer);
+  batcher_->flush();
+  if (mouseHook_ != nullptr) UnhookWindowsHookEx(mouseHook_);
+  if (keyboardHook_ != nullptr) UnhookWindowsHookEx(keyboardHook_);
   mouseHook_ = nullptr;
   keyboardHook_ = nullptr;
   g_active = nullptr;
@@ -3,7 +3,9 @@
 #include <Windows.h>
 
 #include <atomic>
+#include <optional>
 
+#include "common/TapBatcher.h"
 #include "robot/backend/IEventTapBackend.h"
 
 namespace robot::win {
@@ -18,6 +20,10 @@ namespace robot::win {
 // header, an ODR violation that would multiply-define across translation units;
 // here the active instance is registered through a single .cpp-local pointer, and
 // the hooks are torn down and the pointer cleared on stop.
+//
+// Each hook callback is one read from the OS, so with no latency allowance a
+// batch is delivered at the end of every callback; otherwise a thread timer
+// delivers batches the allowance has expired on.
 class WinEventTapBackend final : public backend::IEventTapBackend {
  public:
   WinEventTapBackend() = default;
@@ -26,7 +32,9 @@ class WinEventTapBackend final : public backend::IEventTapBackend {
   WinEventTapBackend(const WinEventTapBackend&) = delete;
   WinEventTapBackend& operator=(const WinEventTapBackend&) = delete;
 
-  std::expected<void, Error> start(EventSink sink) override;
+  std::expected<void, Error> start(
+      EventBatchSink sink, const TapOptions& options
+  ) override;
   void stop() override;
   [[nodiscard]] bool isRunning() const override { return running_.load(); }
 
@@ -37,7 +45,8 @@ class WinEventTapBackend final : public backend::IEventTapBackend {
   void onMouse(WPARAM wParam, const MSLLHOOKSTRUCT& data);
   void onKeyboard(WPARAM wParam, const KBDLLHOOKSTRUCT& data);
 
-  EventSink sink_;
+  // Fed by the hook callbacks, which run on the start() thread.
+  std::optional<tap::Batcher> batcher_;
   HHOOK mouseHook_ = nullptr;
   HHOOK keyboardHook_ = nullptr;
   DWORD threadId_ = 0;
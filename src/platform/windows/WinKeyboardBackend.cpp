@@ -3,22 +3,27 @@
 #include <Windows.h>
 
 #include <array>
+#include <vector>
 
 #include "WinKeyMap.h"
 
 namespace robot::win {
 namespace {
 
-std::expected<void, Error> sendScanCode(
-    const ScanCode sc, const bool down
-) {
+INPUT scanCodeInput(const ScanCode sc, const bool down) {
   INPUT input{};
   input.type = INPUT_KEYBOARD;
   input.ki.wScan = sc.code;
   input.ki.dwFlags = KEYEVENTF_SCANCODE;
   if (!down) input.ki.dwFlags |= KEYEVENTF_KEYUP;
   if (sc.extended) input.ki.dwFlags |= KEYEVENTF_EXTENDEDKEY;
+  return input;
+}
 
+std::expected<void, Error> sendScanCode(
+    const ScanCode sc, const bool down
+) {
+  INPUT input = scanCodeInput(sc, down);
   if (SendInput(1, &input, sizeof(INPUT)) != 1) {
     return std::unexpected(
         Error::platformError("SendInput", static_cast<long>(GetLastError()))
@@ -57,6 +62,44 @@ std::expected<void, Error> WinKeyboardBackend::keyUp(const Key key) {
   return sendScanCode(sc, false);
 }
 
+std::expected<void, Error> WinKeyboardBackend::keySequence(
+    const std::span<const KeyTransition> transitions
+) {
+  // Map everything first, so an unmappable key fails the sequence before any
+  // event is injected.
+  std::vector<INPUT> inputs;
+  inputs.reserve(transitions.size());
+  for (const KeyTransition& t : transitions) {
+    const ScanCode sc = keyToScanCode(t.key);
+    if (!sc.valid) {
+      return std::unexpected(Error::unmappableInput(toString(t.key)));
+    }
+    inputs.push_back(scanCodeInput(sc, t.down));
+  }
+  if (inputs.empty()) return {};
+
+  const UINT count = static_cast<UINT>(inputs.size());
+  const UINT sent = SendInput(count, inputs.data(), sizeof(INPUT));
+  if (sent == count) return {};
+  const auto error = static_cast<long>(GetLastError());
+
+  // Only the first `sent` inputs reached the stream; release whatever of that
+  // prefix is still held so a failed chord never leaves a modifier stuck.
+  std::vector<Key> held;
+  for (UINT i = 0; i < sent; ++i) {
+    const KeyTransition& t = transitions[i];
+    if (t.down) {
+      held.push_back(t.key);
+    } else {
+      std::erase(held, t.key);
+    }
+  }
+  for (auto it = held.rbegin(); it != held.rend(); ++it) {
+    (void)keyUp(*it);
+  }
+  return std::unexpected(Error::platformError("SendInput", error));
+}
+
 std::expected<void, Error> WinKeyboardBackend::typeUnicode(
     const char32_t codepoint
 ) {
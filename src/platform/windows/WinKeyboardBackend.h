@@ -13,12 +13,16 @@ namespace robot::win {
 //
 // This backend is stateless: SendInput carries no cross-call modifier state that
 // needs tracking, and chords are built by the portable facade pressing physical
-// modifier scan codes around the main key.
+// modifier scan codes around the main key. keySequence hands a whole sequence
+// to one SendInput call, which Windows inserts into the input stream unbroken.
 class WinKeyboardBackend final : public backend::IKeyboardBackend {
  public:
   std::expected<void, Error> keyDown(Key key) override;
   std::expected<void, Error> keyUp(Key key) override;
   std::expected<void, Error> typeUnicode(char32_t codepoint) override;
+  std::expected<void, Error> keySequence(
+      std::span<const KeyTransition> transitions
+  ) override;
 };
 
 }  // namespace robot::win
\ No newline at end of file
@@ -0,0 +1,91 @@
+#include <windows.h>
+
+#include <algorithm>
+#include <string>
+
+#include "common/MappedFile.h"
+
+// File-mapping-based MappedFile for Windows. Paths are UTF-8, as everywhere in
+// the public API.
+namespace robot::mapping {
+namespace {
+
+std::wstring widen(const std::string_view utf8) {
+  const int length = MultiByteToWideChar(
+      CP_UTF8, 0, utf8.data(), static_cast<int>(utf8.size()), nullptr, 0
+  );
+  std::wstring wide(static_cast<std::size_t>(length), L'\0');
+  MultiByteToWideChar(
+      CP_UTF8, 0, utf8.data(), static_cast<int>(utf8.size()), wide.data(),
+      length
+  );
+  return wide;
+}
+
+}  // namespace
+
+std::expected<MappedFile, Error> MappedFile::open(const std::string_view path) {
+  const HANDLE file = CreateFileW(
+      widen(path).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+      OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr
+  );
+  if (file == INVALID_HANDLE_VALUE) {
+    return std::unexpected(Error::ioError("cannot open " + std::string{path}));
+  }
+  LARGE_INTEGER size{};
+  if (!GetFileSizeEx(file, &size)) {
+    CloseHandle(file);
+    return std::unexpected(Error::platformError(
+        "GetFileSizeEx", static_cast<long>(GetLastError())
+    ));
+  }
+  if (size.QuadPart == 0) {
+    CloseHandle(file);
+    return MappedFile(nullptr, 0);
+  }
+
+  const HANDLE mapping =
+      CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(file);
+  if (mapping == nullptr) {
+    return std::unexpected(
+        Error::platformError(
+            "CreateFileMappingW", static_cast<long>(GetLastError())
+        )
+    );
+  }
+  const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  // The view keeps the mapping object alive.
+  CloseHandle(mapping);
+  if (view == nullptr) {
+    return std::unexpected(Error::platformError(
+        "MapViewOfFile", static_cast<long>(GetLastError())
+    ));
+  }
+  return MappedFile(
+      static_cast<const std::uint8_t*>(view),
+      static_cast<std::size_t>(size.QuadPart)
+  );
+}
+
+// FILE_FLAG_SEQUENTIAL_SCAN at open time is the Windows read-ahead hint.
+void MappedFile::adviseSequential() const {}
+
+void MappedFile::release(
+    const std::size_t offset, const std::size_t length
+) const {
+  if (data_ == nullptr || offset >= size_) return;
+  // Unlocking pages that are not locked trims them from the working set.
+  VirtualUnlock(
+      const_cast<std::uint8_t*>(data_ + offset),
+      std::min(length, size_ - offset)
+  );
+}
+
+void MappedFile::unmap() {
+  if (data_ != nullptr) UnmapViewOfFile(data_);
+  data_ = nullptr;
+  size_ = 0;
+}
+
+}  // namespace robot::mapping
@@ -181,6 +181,7 @@ std::expected<void, Error> WinMouseBackend::button(
   }
 
   if (auto r = send(input); !r) return r;
+  const std::lock_guard lock(mutex_);
   if (down) {
     pressedButton_ = button;
   } else {
@@ -2,6 +2,7 @@
 
 #include <Windows.h>
 
+#include <mutex>
 #include <optional>
 
 #include "robot/backend/IMouseBackend.h"
@@ -30,6 +31,7 @@ class WinMouseBackend final : public backend::IMouseBackend {
   std::expected<void, Error> scroll(ScrollDelta delta) override;
 
  private:
+  std::mutex mutex_;
   std::optional<MouseButton> pressedButton_;
 };
 
@@ -0,0 +1,66 @@
+#include <windows.h>
+
+#include <chrono>
+#include <ratio>
+#include <thread>
+
+#include "common/Pacing.h"
+
+// Windows pacing primitives. A plain sleep rounds up to the system timer tick
+// (15.6 ms unless someone raised the timer resolution), far coarser than any
+// spin window; a high-resolution waitable timer (Windows 10 1803+) wakes
+// within a fraction of a millisecond without changing the global resolution.
+// Older SDKs lack the flag; the value is fixed by the ABI.
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+namespace robot::pacing {
+namespace {
+
+// One timer per thread, created on first use and closed at thread exit. Null
+// when the OS predates high-resolution timers.
+struct ThreadTimer {
+  HANDLE handle = CreateWaitableTimerExW(
+      nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS
+  );
+  ~ThreadTimer() {
+    if (handle != nullptr) CloseHandle(handle);
+  }
+};
+
+}  // namespace
+
+void sleepUntil(const Clock::time_point deadline) {
+  thread_local ThreadTimer timer;
+  const auto remaining = deadline - Clock::now();
+  if (remaining <= Clock::duration::zero()) return;
+  if (timer.handle == nullptr) {
+    std::this_thread::sleep_until(deadline);
+    return;
+  }
+  // Negative due times are relative, in 100 ns units.
+  using Ticks = std::chrono::duration<LONGLONG, std::ratio<1, 10000000>>;
+  LARGE_INTEGER due{};
+  due.QuadPart = -std::chrono::duration_cast<Ticks>(remaining).count();
+  if (!SetWaitableTimer(timer.handle, &due, 0, nullptr, nullptr, FALSE)) {
+    std::this_thread::sleep_until(deadline);
+    return;
+  }
+  WaitForSingleObject(timer.handle, INFINITE);
+}
+
+ScopedPriorityBoost::ScopedPriorityBoost(const bool enable) {
+  if (!enable) return;
+  savedPriority_ = GetThreadPriority(GetCurrentThread());
+  raised_ = SetThreadPriority(
+                GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL
+            ) != 0;
+}
+
+ScopedPriorityBoost::~ScopedPriorityBoost() {
+  if (!raised_) return;
+  SetThreadPriority(GetCurrentThread(), savedPriority_);
+}
+
+}  // namespace robot::pacing
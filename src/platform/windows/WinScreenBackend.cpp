@@ -61,6 +61,14 @@ BOOL CALLBACK WinScreenBackend::monitorEnumProc(
   m.isPrimary = (info.dwFlags & MONITORINFOF_PRIMARY) != 0;
   m.scaleFactor = scale;
 
+  // dmDisplayFrequency of 0 or 1 means "hardware default"; report unknown.
+  DEVMODEW mode{};
+  mode.dmSize = sizeof(mode);
+  if (EnumDisplaySettingsW(info.szDevice, ENUM_CURRENT_SETTINGS, &mode) != 0 &&
+      mode.dmDisplayFrequency > 1) {
+    m.refreshRate = static_cast<double>(mode.dmDisplayFrequency);
+  }
+
   // The rectangle is already physical; logical bounds are the physical bounds
   // divided by this monitor's scale.
   m.physicalBounds =
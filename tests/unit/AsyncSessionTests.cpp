@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <future>
+#include <thread>
+
+#include "robot/AsyncSession.h"
+#include "support/MockBackend.h"
+
+// AsyncSession issues the same backend calls as the synchronous facades, in
+// queue order, from its worker. The mock log is read only after the futures
+// involved are ready, which orders it after the worker's writes.
+namespace robot::test {
+namespace {
+
+using std::chrono::milliseconds;
+
+TEST(AsyncSession, CallsRunInTheOrderTheyWereMade) {
+  MockPlatformBackend backend;
+  AsyncSession session(backend);
+
+  auto typed = session.typeText("hi");
+  auto tapped = session.tap(Key::A);
+  auto clicked = session.click(MouseButton::Right);
+  ASSERT_TRUE(typed.get().has_value());
+  ASSERT_TRUE(tapped.get().has_value());
+  ASSERT_TRUE(clicked.get().has_value());
+
+  const auto& log = backend.log();
+  ASSERT_EQ(log.size(), 6u);
+  EXPECT_EQ(log[0].codepoint, U'h');
+  EXPECT_EQ(log[1].codepoint, U'i');
+  EXPECT_EQ(log[2].kind, RecordedCall::Kind::KeyDown);
+  EXPECT_EQ(log[3].kind, RecordedCall::Kind::KeyUp);
+  EXPECT_EQ(log[4].kind, RecordedCall::Kind::Button);
+  EXPECT_EQ(log[4].button, MouseButton::Right);
+  EXPECT_EQ(log[5].action, ButtonAction::Up);
+}
+
+TEST(AsyncSession, SmoothMoveMatchesTheSynchronousFacade) {
+  MockPlatformBackend backend;
+  backend.mockMouse().setPosition({0.0, 0.0});
+  AsyncSession session(backend);
+
+  MouseMoveOptions options;
+  options.duration = milliseconds(20);
+  options.steps = 10;
+  const auto stats = session.moveSmooth({100.0, 0.0}, options).get();
+  ASSERT_TRUE(stats.has_value());
+  EXPECT_EQ(stats->steps, 10);
+  EXPECT_GE(stats->achieved, stats->requested);
+
+  const auto& log = backend.log();
+  ASSERT_EQ(log.size(), 11u);  // The position read, then one warp per step.
+  EXPECT_EQ(log.front().kind, RecordedCall::Kind::CursorPos);
+  EXPECT_EQ(log.back().point, (LogicalPoint{100.0, 0.0}));
+}
+
+TEST(AsyncSession, DragPressesMovesThenReleases) {
+  MockPlatformBackend backend;
+  AsyncSession session(backend);
+
+  ASSERT_TRUE(session.drag({40.0, 30.0}).get().has_value());
+
+  const auto& log = backend.log();
+  ASSERT_EQ(log.size(), 3u);
+  EXPECT_EQ(log[0].action, ButtonAction::Down);
+  EXPECT_EQ(log[1].kind, RecordedCall::Kind::Warp);
+  EXPECT_EQ(log[1].point, (LogicalPoint{40.0, 30.0}));
+  EXPECT_EQ(log[2].action, ButtonAction::Up);
+}
+
+TEST(AsyncSession, RunHandsOverTheFacades) {
+  MockPlatformBackend backend;
+  backend.mockMouse().setPosition({7.0, 9.0});
+  AsyncSession session(backend);
+
+  auto x = session.run(
+      [](Keyboard&, Mouse& mouse, Screen&) -> std::expected<double, Error> {
+        auto p = mouse.position();
+        if (!p) return std::unexpected(p.error());
+        return p->x;
+      }
+  );
+  const auto result = x.get();
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(*result, 7.0);
+}
+
+TEST(AsyncSession, CancelFailsQueuedCalls) {
+  MockPlatformBackend backend;
+  AsyncSession session(backend);
+
+  // Hold the worker so the calls behind it are still queued at cancel().
+  std::promise<void> entered;
+  std::promise<void> gate;
+  auto running = entered.get_future();
+  auto held = session.run(
+      [entered = std::move(entered), opened = gate.get_future()](
+          Keyboard&, Mouse&, Screen&
+      ) mutable {
+        entered.set_value();
+        opened.wait();
+        return std::expected<void, Error>{};
+      }
+  );
+  running.wait();
+  auto scrolled = session.scrollSmooth(ScrollDelta::lines(3.0));
+  auto clicked = session.click();
+  session.cancel();
+  gate.set_value();
+
+  EXPECT_TRUE(held.get().has_value());
+  const auto scroll = scrolled.get();
+  ASSERT_FALSE(scroll.has_value());
+  EXPECT_EQ(scroll.error().code, ErrorCode::Cancelled);
+  const auto click = clicked.get();
+  ASSERT_FALSE(click.has_value());
+  EXPECT_EQ(click.error().code, ErrorCode::Cancelled);
+
+  // The queue keeps working after a cancel.
+  EXPECT_TRUE(session.click().get().has_value());
+  EXPECT_EQ(backend.log().size(), 2u);
+}
+
+TEST(AsyncSession, CancelReleasesTheButtonOfARunningDrag) {
+  MockPlatformBackend backend;
+  AsyncSession session(backend);
+
+  MouseMoveOptions options;
+  options.duration = std::chrono::seconds(10);
+  options.steps = 2;
+  auto dragged = session.dragSmooth({50.0, 50.0}, MouseButton::Left, options);
+  std::this_thread::sleep_for(milliseconds(200));  // Into the move.
+  const auto started = std::chrono::steady_clock::now();
+  session.cancel();
+  const auto result = dragged.get();
+
+  ASSERT_FALSE(result.has_value());
+  EXPECT_EQ(result.error().code, ErrorCode::Cancelled);
+  EXPECT_LT(std::chrono::steady_clock::now() - started, milliseconds(1000));
+  const auto& log = backend.log();
+  ASSERT_GE(log.size(), 2u);
+  EXPECT_EQ(log.front().action, ButtonAction::Down);
+  EXPECT_EQ(log.back().kind, RecordedCall::Kind::Button);
+  EXPECT_EQ(log.back().action, ButtonAction::Up);
+}
+
+TEST(AsyncSession, DestructionCancelsWhatIsLeft) {
+  MockPlatformBackend backend;
+  std::future<std::expected<MoveStats, Error>> moved;
+  {
+    AsyncSession session(backend);
+    ScrollSmoothOptions options;
+    options.duration = std::chrono::seconds(10);
+    moved = session.scrollSmooth(ScrollDelta::lines(1.0), options);
+  }
+  const auto result = moved.get();
+  ASSERT_FALSE(result.has_value());
+  EXPECT_EQ(result.error().code, ErrorCode::Cancelled);
+}
+
+}  // namespace
+}  // namespace robot::test
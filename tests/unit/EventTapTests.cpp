@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "MockBackend.h"
+#include "robot/EventTap.h"
+
+// The subscriber model on a mock tap: one platform tap, fanned out to many
+// sinks on their own threads.
+namespace robot {
+namespace {
+
+using std::chrono::steady_clock;
+
+// Collects what a subscriber's delivery thread hands it.
+class Collector {
+ public:
+  EventBatchSink sink() {
+    return [this](std::span<const TimedEvent> batch) {
+      const std::lock_guard lock(mutex_);
+      events_.insert(events_.end(), batch.begin(), batch.end());
+      cv_.notify_all();
+    };
+  }
+  bool waitFor(const std::size_t n) {
+    std::unique_lock lock(mutex_);
+    return cv_.wait_for(lock, std::chrono::seconds(5), [&] {
+      return events_.size() >= n;
+    });
+  }
+  std::vector<TimedEvent> events() {
+    const std::lock_guard lock(mutex_);
+    return events_;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::vector<TimedEvent> events_;
+};
+
+std::vector<TimedEvent> mixedBatch() {
+  const auto now = steady_clock::now();
+  return {
+      {now, KeyEvent{Key::A, true}},
+      {now, MouseMoveEvent{{10, 10}}},
+      {now, KeyEvent{Key::A, false}},
+  };
+}
+
+TEST(EventTap, FansOneTapOutToFilteredSubscribers) {
+  test::MockEventTap backend;
+  EventTap tap(&backend);
+  Collector all;
+  Collector keys;
+
+  auto a = tap.subscribe(all.sink());
+  ASSERT_TRUE(a.has_value());
+  auto k = tap.subscribe(
+      keys.sink(), {.filter = {.motion = false, .buttons = false}}
+  );
+  ASSERT_TRUE(k.has_value());
+  EXPECT_EQ(backend.starts(), 1);
+
+  backend.emit(mixedBatch());
+  ASSERT_TRUE(all.waitFor(3));
+  ASSERT_TRUE(keys.waitFor(2));
+  EXPECT_EQ(keys.events().size(), 2u);
+  EXPECT_TRUE(std::holds_alternative<KeyEvent>(keys.events()[1].event));
+}
+
+TEST(EventTap, SlowSubscriberDropsOnlyItsOwnEvents) {
+  test::MockEventTap backend;
+  EventTap tap(&backend);
+
+  std::mutex gate;
+  gate.lock();  // Held until the end: the slow sink blocks on its first call.
+  auto slow = tap.subscribe(
+      [&](std::span<const TimedEvent>) { const std::lock_guard g(gate); },
+      {.queueCapacity = 2}
+  );
+  ASSERT_TRUE(slow.has_value());
+  Collector fast;
+  auto f = tap.subscribe(fast.sink());
+  ASSERT_TRUE(f.has_value());
+
+  for (int i = 0; i < 20; ++i) backend.emit(mixedBatch());
+  ASSERT_TRUE(fast.waitFor(60));
+  EXPECT_GT(slow->dropped(), 0u);
+  EXPECT_EQ(f->dropped(), 0u);
+  gate.unlock();
+}
+
+TEST(EventTap, LastUnsubscribeStopsTheSharedTap) {
+  test::MockEventTap backend;
+  EventTap tap(&backend);
+  Collector c;
+
+  auto first = tap.subscribe(c.sink());
+  auto second = tap.subscribe(c.sink());
+  ASSERT_TRUE(first.has_value() && second.has_value());
+  EXPECT_FALSE(tap.start(c.sink()).has_value());  // Busy serving subscribers.
+
+  first->unsubscribe();
+  EXPECT_TRUE(backend.isRunning());
+  second->unsubscribe();
+  EXPECT_FALSE(backend.isRunning());
+
+  // A later subscription starts it again.
+  auto third = tap.subscribe(c.sink());
+  ASSERT_TRUE(third.has_value());
+  EXPECT_EQ(backend.starts(), 2);
+}
+
+TEST(EventTap, RejectsAFilterThatExcludesEverything) {
+  test::MockEventTap backend;
+  EventTap tap(&backend);
+  Collector c;
+  const TapOptions none{.filter = {
+                            .keys = false,
+                            .motion = false,
+                            .buttons = false,
+                            .scroll = false,
+                        }};
+
+  const auto started = tap.start(c.sink(), none);
+  ASSERT_FALSE(started.has_value());
+  EXPECT_EQ(started.error().code, ErrorCode::InvalidArgument);
+  const auto pollable = tap.startPollable(c.sink(), none);
+  ASSERT_FALSE(pollable.has_value());
+  EXPECT_EQ(pollable.error().code, ErrorCode::InvalidArgument);
+  EXPECT_EQ(backend.starts(), 0);
+}
+
+}  // namespace
+}  // namespace robot
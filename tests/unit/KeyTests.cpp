@@ -10,6 +10,13 @@ TEST(Key, UsesHidUsageValues) {
   EXPECT_EQ(keyToHidUsage(Key::LeftControl), 0xE0);
 }
 
+TEST(Key, MapsHidUsageBackOnlyForEnumerators) {
+  EXPECT_EQ(keyFromHidUsage(0x04), Key::A);
+  EXPECT_EQ(keyFromHidUsage(0xE7), Key::RightMeta);
+  EXPECT_EQ(keyFromHidUsage(0x74), std::nullopt);
+  EXPECT_EQ(keyFromHidUsage(0x1234), std::nullopt);
+}
+
 TEST(Key, FormatsKnownKeys) {
   EXPECT_EQ(toString(Key::A), "A");
   EXPECT_EQ(toString(Key::RightMeta), "RightMeta");
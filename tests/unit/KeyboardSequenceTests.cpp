@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "robot/Keyboard.h"
+#include "support/MockBackend.h"
+
+// Chords are built as one key sequence so batching backends can send them in a
+// single call. These tests pin the order of that sequence and the guarantee
+// that a failure part-way never leaves a modifier held.
+namespace robot::test {
+namespace {
+
+std::vector<KeyTransition> transitions(const std::vector<RecordedCall>& log) {
+  std::vector<KeyTransition> out;
+  for (const auto& c : log) {
+    if (c.kind == RecordedCall::Kind::KeyDown) out.push_back({c.key, true});
+    if (c.kind == RecordedCall::Kind::KeyUp) out.push_back({c.key, false});
+  }
+  return out;
+}
+
+TEST(KeyboardSequence, TapWrapsKeyInModifiersAndUnwindsInReverse) {
+  MockPlatformBackend backend;
+  Keyboard keyboard(backend.keyboard());
+
+  ASSERT_TRUE(keyboard.tap(Key::C, Modifier::Shift | Modifier::Control));
+  const std::vector<KeyTransition> expected{
+      {Key::LeftControl, true}, {Key::LeftShift, true}, {Key::C, true},
+      {Key::C, false},          {Key::LeftShift, false},
+      {Key::LeftControl, false},
+  };
+  EXPECT_EQ(transitions(backend.log()), expected);
+}
+
+TEST(KeyboardSequence, FailureReleasesKeysTheSequencePressed) {
+  MockPlatformBackend backend;
+  backend.mockKeyboard().failKeyDown(Key::C);
+  Keyboard keyboard(backend.keyboard());
+
+  const auto result = keyboard.tap(Key::C, Modifier::Control | Modifier::Alt);
+  ASSERT_FALSE(result.has_value());
+  EXPECT_EQ(result.error().code, ErrorCode::UnmappableInput);
+  const std::vector<KeyTransition> expected{
+      {Key::LeftControl, true}, {Key::LeftAlt, true},
+      {Key::LeftAlt, false},    {Key::LeftControl, false},
+  };
+  EXPECT_EQ(transitions(backend.log()), expected);
+}
+
+TEST(KeyboardSequence, ExplicitSequenceKeepsKeysTheCallerLeftHeld) {
+  MockPlatformBackend backend;
+  Keyboard keyboard(backend.keyboard());
+
+  // A sequence may deliberately end with a key down; only failure unwinds.
+  const std::vector<KeyTransition> hold{
+      {Key::LeftShift, true}, {Key::A, true}, {Key::A, false}};
+  ASSERT_TRUE(keyboard.sequence(hold));
+  EXPECT_EQ(transitions(backend.log()), hold);
+}
+
+}  // namespace
+}  // namespace robot::test
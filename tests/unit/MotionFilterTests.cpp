@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <vector>
+
+#include "robot/MotionFilter.h"
+#include "robot/Recorder.h"
+
+// The motion filter is a pure transformation of a stamped timeline, so each
+// rule is pinned on hand-built events: what coalescing keeps, which points
+// simplification keeps, and that non-motion events are never disturbed.
+namespace robot {
+namespace {
+
+using std::chrono::milliseconds;
+
+RecordedEvent move(const int ms, const double x, const double y) {
+  return {milliseconds(ms), MouseMoveEvent{{x, y}}};
+}
+
+std::vector<RecordedEvent> run(
+    const MotionFilterOptions& options, const std::vector<RecordedEvent>& in
+) {
+  MotionFilter filter(options);
+  std::vector<RecordedEvent> out;
+  const auto sink = [&](const RecordedEvent& e) { out.push_back(e); };
+  for (const auto& e : in) filter.add(e, sink);
+  filter.flush(sink);
+  EXPECT_EQ(filter.dropped(), in.size() - out.size());
+  return out;
+}
+
+TEST(MotionFilter, CoalescesWithinTheWindowKeepingTheNewestMove) {
+  MotionFilterOptions options;
+  options.minInterval = milliseconds(10);
+  const auto out = run(options, {move(0, 0, 0), move(2, 1, 0), move(4, 2, 0),
+                                 move(6, 3, 0), move(12, 9, 0)});
+  // 2 and 4 are replaced by 6 (all within 10 ms of 0); 12 is a new step.
+  EXPECT_EQ(out, (std::vector<RecordedEvent>{move(0, 0, 0), move(6, 3, 0),
+                                             move(12, 9, 0)}));
+}
+
+TEST(MotionFilter, SimplifiesStraightRunsButKeepsCorners) {
+  MotionFilterOptions options;
+  options.tolerance = 0.5;
+  std::vector<RecordedEvent> in;
+  for (int i = 0; i <= 10; ++i) in.push_back(move(i, i * 10.0, 0.0));
+  for (int i = 1; i <= 10; ++i) {
+    in.push_back(move(10 + i, 100.0, i * 10.0 + 0.1 * (i % 2)));  // Jitter.
+  }
+  const auto out = run(options, in);
+  EXPECT_EQ(out, (std::vector<RecordedEvent>{move(0, 0, 0), move(10, 100, 0),
+                                             move(20, 100, 100)}));
+}
+
+TEST(MotionFilter, NeverMovesNonMotionEvents) {
+  MotionFilterOptions options;
+  options.tolerance = 5.0;
+  options.minDistance = 3.0;
+  const RecordedEvent click{
+      milliseconds(3), MouseButtonEvent{MouseButton::Left, true, {2.0, 0.0}}};
+  const RecordedEvent key{milliseconds(3), KeyEvent{Key::A, true}};
+  const auto out = run(options, {move(0, 0, 0), move(1, 1, 0), move(2, 2, 0),
+                                 click, key, move(4, 2.5, 0), move(5, 40, 0)});
+  // 1 coalesces into 2; 2.5 is the newest sample near the click, so it stays.
+  EXPECT_EQ(out, (std::vector<RecordedEvent>{move(0, 0, 0), move(2, 2, 0),
+                                             click, key, move(4, 2.5, 0),
+                                             move(5, 40, 0)}));
+}
+
+TEST(MotionFilter, RecorderReportsCompressionRatio) {
+  RecorderOptions options;
+  options.motionFilter = MotionFilterOptions{.tolerance = 1.0};
+  Recorder recorder(options);
+  for (int i = 0; i < 100; ++i) {
+    recorder.capture(MouseMoveEvent{{i * 1.0, 0.0}});
+  }
+  recorder.capture(MouseButtonEvent{MouseButton::Left, true, {99.0, 0.0}});
+  recorder.flush();
+
+  ASSERT_EQ(recorder.events().size(), 3u);  // Two endpoints and the click.
+  const RecorderStats stats = recorder.stats();
+  EXPECT_EQ(stats.captured, 101u);
+  EXPECT_EQ(stats.filtered, 98u);
+  EXPECT_NEAR(stats.compressionRatio(), 101.0 / 3.0, 1e-9);
+}
+
+}  // namespace
+}  // namespace robot
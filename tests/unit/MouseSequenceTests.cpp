@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 
+#include <cmath>
+
 #include "robot/Mouse.h"
 #include "support/MockBackend.h"
 
@@ -66,5 +68,65 @@ TEST(MouseSequence, SmoothMoveEndsAtTarget) {
   EXPECT_EQ(last, (LogicalPoint{100.0, 0.0}));
 }
 
+TEST(MouseSequence, SmoothMoveReportsAchievedTiming) {
+  MockPlatformBackend backend;
+  backend.mockMouse().setPosition({0.0, 0.0});
+  Mouse mouse(backend.mouse());
+
+  MouseMoveOptions options;
+  options.duration = std::chrono::milliseconds(20);
+  options.steps = 10;
+  options.pacing = PacingMode::Hybrid;
+  auto stats = mouse.moveSmooth({50.0, 50.0}, options);
+  ASSERT_TRUE(stats.has_value());
+
+  // Deadlines are absolute, so the move never finishes before its duration and
+  // every step contributes one lateness sample.
+  EXPECT_EQ(stats->steps, 10);
+  EXPECT_EQ(stats->requested, std::chrono::milliseconds(20));
+  EXPECT_GE(stats->achieved, stats->requested);
+  EXPECT_EQ(stats->jitter.samples, 10u);
+  EXPECT_LE(stats->jitter.mean, stats->jitter.max);
+}
+
+TEST(MouseSequence, SmoothScrollStepsSumToTheTotal) {
+  MockPlatformBackend backend;
+  Mouse mouse(backend.mouse());
+
+  ScrollSmoothOptions options;
+  options.duration = std::chrono::milliseconds(0);
+  options.steps = 7;
+  ASSERT_TRUE(mouse.scrollSmooth(ScrollDelta::lines(-5.0, 2.0), options));
+
+  // Whole-notch quantum: every emitted step is an integer and none is lost.
+  double vertical = 0.0;
+  double horizontal = 0.0;
+  for (const auto& c : backend.log()) {
+    ASSERT_EQ(c.kind, RecordedCall::Kind::Scroll);
+    EXPECT_EQ(c.scroll.vertical, std::round(c.scroll.vertical));
+    vertical += c.scroll.vertical;
+    horizontal += c.scroll.horizontal;
+  }
+  EXPECT_EQ(vertical, -5.0);
+  EXPECT_EQ(horizontal, 2.0);
+}
+
+TEST(MouseSequence, SmoothScrollHonoursFineQuantum) {
+  MockPlatformBackend backend;
+  Mouse mouse(backend.mouse());
+
+  ScrollSmoothOptions options;
+  options.duration = std::chrono::milliseconds(0);
+  options.quantum = 1.0 / 120.0;
+  const auto stats = mouse.scrollSmooth(ScrollDelta::lines(0.5), options);
+  ASSERT_TRUE(stats.has_value());
+
+  double vertical = 0.0;
+  for (const auto& c : backend.log()) vertical += c.scroll.vertical;
+  EXPECT_NEAR(vertical, 0.5, 1e-9);
+  EXPECT_EQ(stats->steps, 60);  // One step per 1/120 of a line.
+  EXPECT_GT(backend.log().size(), 1u);
+}
+
 }  // namespace
 }  // namespace robot::test
@@ -2,6 +2,9 @@
 
 #include <chrono>
 #include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "robot/Recorder.h"
 
@@ -27,6 +30,22 @@ TEST(Recorder, StampsEventsRelativeToFirstCapture) {
   EXPECT_TRUE(std::holds_alternative<KeyEvent>(events.front().event));
 }
 
+TEST(Recorder, KeepsSubMillisecondGapsFromEventTimes) {
+  using std::chrono::microseconds;
+  Recorder recorder;
+  const auto t0 = std::chrono::steady_clock::now();
+  recorder.capture(TimedEvent{t0, KeyEvent{Key::A, true}});
+  recorder.capture(TimedEvent{t0 + microseconds(250), KeyEvent{Key::A, false}});
+  // Slightly out of order (another device's clock): clamped, never negative.
+  recorder.capture(TimedEvent{t0 + microseconds(200), MouseMoveEvent{}});
+
+  const auto& events = recorder.events();
+  ASSERT_EQ(events.size(), 3u);
+  EXPECT_EQ(events[0].timestamp, microseconds(0));
+  EXPECT_EQ(events[1].timestamp, microseconds(250));
+  EXPECT_EQ(events[2].timestamp, microseconds(250));
+}
+
 TEST(Recorder, ResetClearsAndRestartsClock) {
   Recorder recorder;
   recorder.capture(MouseMoveEvent{{10.0, 20.0}});
@@ -38,5 +57,105 @@ TEST(Recorder, ResetClearsAndRestartsClock) {
   EXPECT_EQ(recorder.events().front().timestamp.count(), 0);
 }
 
+TEST(Recorder, ConcurrentModeQueuesUntilDrained) {
+  Recorder recorder(RecorderOptions{.ringCapacity = 4});
+  for (int i = 0; i < 6; ++i) recorder.capture(KeyEvent{Key::A, i % 2 == 0});
+
+  // Nothing is visible before a drain; the two events past capacity dropped.
+  EXPECT_TRUE(recorder.empty());
+  EXPECT_EQ(recorder.drain(), 4u);
+  EXPECT_EQ(recorder.events().size(), 4u);
+
+  const RecorderStats stats = recorder.stats();
+  EXPECT_EQ(stats.captured, 4u);
+  EXPECT_EQ(stats.dropped, 2u);
+  EXPECT_EQ(stats.highWater, 4u);
+}
+
+TEST(Recorder, BatchCaptureMatchesPerEventCapture) {
+  const auto t0 = std::chrono::steady_clock::now();
+  std::vector<TimedEvent> batch;
+  for (int i = 0; i < 6; ++i) {
+    batch.push_back(
+        {t0 + std::chrono::microseconds(250 * i), KeyEvent{Key::A, i % 2 == 0}}
+    );
+  }
+
+  Recorder direct;
+  direct.capture(batch);
+  ASSERT_EQ(direct.events().size(), 6u);
+  EXPECT_EQ(direct.events()[5].timestamp, std::chrono::microseconds(1250));
+  EXPECT_EQ(direct.stats().captured, 6u);
+
+  // A batch larger than the ring drops its tail, counted once per batch.
+  Recorder queued(RecorderOptions{.ringCapacity = 4});
+  queued.capture(batch);
+  EXPECT_EQ(queued.drain(), 4u);
+  EXPECT_EQ(queued.stats().captured, 4u);
+  EXPECT_EQ(queued.stats().dropped, 2u);
+}
+
+TEST(Recorder, ConcurrentCaptureArrivesInOrder) {
+  constexpr int kEvents = 20000;
+  Recorder recorder(RecorderOptions{.ringCapacity = 256});
+
+  std::thread tap([&] {
+    for (int i = 0; i < kEvents; ++i) {
+      recorder.capture(MouseMoveEvent{{static_cast<double>(i), 0.0}});
+    }
+  });
+  while (recorder.events().size() + recorder.stats().dropped <
+         static_cast<std::size_t>(kEvents)) {
+    recorder.drain();
+  }
+  tap.join();
+  recorder.drain();
+
+  // Whatever was not dropped is stored in capture order.
+  double previous = -1.0;
+  for (const RecordedEvent& e : recorder.events()) {
+    const double x = std::get<MouseMoveEvent>(e.event).position.x;
+    EXPECT_GT(x, previous);
+    previous = x;
+  }
+  EXPECT_EQ(
+      recorder.events().size() + recorder.stats().dropped,
+      static_cast<std::size_t>(kEvents)
+  );
+}
+
+TEST(Recorder, MovesWithItsTimelineAndCounters) {
+  static_assert(std::is_nothrow_move_constructible_v<Recorder>);
+  static_assert(std::is_nothrow_move_assignable_v<Recorder>);
+
+  Recorder recorder(RecorderOptions{.ringCapacity = 4});
+  for (int i = 0; i < 6; ++i) recorder.capture(KeyEvent{Key::A, i % 2 == 0});
+  recorder.drain();
+
+  Recorder moved(std::move(recorder));
+  EXPECT_EQ(moved.events().size(), 4u);
+  EXPECT_EQ(moved.stats().captured, 4u);
+  EXPECT_EQ(moved.stats().dropped, 2u);
+  moved.capture(KeyEvent{Key::B, true});
+  EXPECT_EQ(moved.drain(), 1u);
+
+  recorder = std::move(moved);
+  EXPECT_EQ(recorder.events().size(), 5u);
+  EXPECT_EQ(recorder.stats().captured, 5u);
+}
+
+TEST(EventStore, AppendingNeverMovesStoredEvents) {
+  EventStore store;
+  store.push_back({.event = KeyEvent{Key::A, true}});
+  const RecordedEvent* first = &store.front();
+  for (std::size_t i = 0; i < 3 * EventStore::kSegmentSize; ++i) {
+    store.push_back({.event = KeyEvent{Key::B, true}});
+  }
+  EXPECT_EQ(&store.front(), first);
+  EXPECT_EQ(store.size(), 3 * EventStore::kSegmentSize + 1);
+  EXPECT_EQ(std::get<KeyEvent>(store.back().event).key, Key::B);
+  EXPECT_EQ(store.end() - store.begin(), static_cast<std::ptrdiff_t>(store.size()));
+}
+
 }  // namespace
 }  // namespace robot
\ No newline at end of file
@@ -0,0 +1,253 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "robot/MappedRecording.h"
+#include "robot/Recorder.h"
+#include "robot/RecordingFile.h"
+
+// The recording format round-trips through a real temporary file: the codec is
+// only interesting together with the chunked reader and writer around it.
+namespace robot {
+namespace {
+
+using std::chrono::milliseconds;
+
+std::string tempPath(const char* name) {
+  return (std::filesystem::temp_directory_path() / name).string();
+}
+
+std::vector<RecordedEvent> sampleEvents() {
+  return {
+      {milliseconds(0), KeyEvent{Key::LeftShift, true}},
+      {milliseconds(3), MouseMoveEvent{{100.5, -20.25}}},
+      {milliseconds(4), MouseMoveEvent{{99.0, -18.125}}},
+      {milliseconds(4), MouseButtonEvent{MouseButton::X2, true, {99.0, 1e6}}},
+      {milliseconds(90), ScrollEvent{ScrollDelta::pixels(-7.5, 2.0), {0.0, 0.0}}},
+      {milliseconds(70000), KeyEvent{Key::LeftShift, false}},
+  };
+}
+
+TEST(RecordingFile, RoundTripsEveryEventType) {
+  const std::string path = tempPath("robot_roundtrip.rbrc");
+  const auto events = sampleEvents();
+  {
+    auto writer = RecordingWriter::create(path);
+    ASSERT_TRUE(writer.has_value());
+    for (const auto& e : events) ASSERT_TRUE(writer->write(e).has_value());
+    ASSERT_TRUE(writer->close().has_value());
+  }
+
+  auto reader = RecordingReader::open(path);
+  ASSERT_TRUE(reader.has_value());
+  std::vector<RecordedEvent> read;
+  while (true) {
+    auto next = reader->next();
+    ASSERT_TRUE(next.has_value());
+    if (!*next) break;
+    read.push_back(**next);
+  }
+  EXPECT_EQ(read, events);
+  std::remove(path.c_str());
+}
+
+TEST(RecordingFile, RecorderSavesAndLoadsManyChunks) {
+  const std::string path = tempPath("robot_recorder.rbrc");
+  Recorder source;
+  // Enough events that the file spans several 64 KiB chunks.
+  for (int i = 0; i < 40000; ++i) {
+    source.capture(MouseMoveEvent{{i * 0.5, -i * 0.25}});
+  }
+  ASSERT_TRUE(source.save(path).has_value());
+  EXPECT_LT(std::filesystem::file_size(path),
+            source.events().size() * sizeof(RecordedEvent) / 4);
+
+  Recorder loaded;
+  ASSERT_TRUE(loaded.load(path).has_value());
+  ASSERT_EQ(loaded.events().size(), source.events().size());
+  EXPECT_TRUE(std::equal(source.events().begin(), source.events().end(),
+                         loaded.events().begin()));
+  std::remove(path.c_str());
+}
+
+TEST(RecordingFile, LoadStartsAFreshCaptureAfterTheLoadedTimeline) {
+  const std::string path = tempPath("robot_reload.rbrc");
+  {
+    Recorder source;
+    for (const auto& e : sampleEvents()) {
+      source.capture(TimedEvent{
+          std::chrono::steady_clock::time_point(e.timestamp), e.event});
+    }
+    ASSERT_TRUE(source.save(path).has_value());
+  }
+
+  // Simplification holds moves back until a flush; the load drops them.
+  Recorder recorder(RecorderOptions{
+      .motionFilter = MotionFilterOptions{.tolerance = 1.0},
+  });
+  const auto t0 = std::chrono::steady_clock::now();
+  recorder.capture(TimedEvent{t0, MouseMoveEvent{{1.0, 1.0}}});
+  recorder.capture(
+      TimedEvent{t0 + milliseconds(1), MouseMoveEvent{{2.0, 2.0}}}
+  );
+  ASSERT_TRUE(recorder.load(path).has_value());
+  std::remove(path.c_str());
+
+  // Nothing of the session before the load survives it.
+  EXPECT_EQ(recorder.stats().captured, 0u);
+  EXPECT_EQ(recorder.stats().filtered, 0u);
+  ASSERT_EQ(recorder.events().size(), sampleEvents().size());
+  recorder.flush();
+  EXPECT_EQ(recorder.events().size(), sampleEvents().size());
+
+  // New captures continue from the loaded end, keeping the timeline sorted.
+  const auto t1 = std::chrono::steady_clock::now();
+  recorder.capture(TimedEvent{t1, KeyEvent{Key::A, true}});
+  recorder.capture(TimedEvent{t1 + milliseconds(5), KeyEvent{Key::A, false}});
+  const auto& events = recorder.events();
+  ASSERT_EQ(events.size(), sampleEvents().size() + 2);
+  EXPECT_EQ(events[events.size() - 2].timestamp, milliseconds(70000));
+  EXPECT_EQ(events.back().timestamp, milliseconds(70005));
+  EXPECT_EQ(recorder.stats().captured, 2u);
+}
+
+TEST(RecordingFile, RejectsForeignAndTruncatedFiles) {
+  const std::string path = tempPath("robot_corrupt.rbrc");
+  {
+    std::ofstream(path, std::ios::binary) << "PNG\x1a not a recording";
+  }
+  const auto foreign = RecordingReader::open(path);
+  ASSERT_FALSE(foreign.has_value());
+  EXPECT_EQ(foreign.error().code, ErrorCode::InvalidArgument);
+
+  {
+    auto writer = RecordingWriter::create(path);
+    ASSERT_TRUE(writer.has_value());
+    ASSERT_TRUE(
+        writer->write({milliseconds(1), MouseMoveEvent{{5e8, 5e8}}}).has_value()
+    );
+    ASSERT_TRUE(writer->close().has_value());
+  }
+  std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+
+  Recorder recorder;
+  recorder.capture(KeyEvent{Key::A, true});
+  const auto loaded = recorder.load(path);
+  ASSERT_FALSE(loaded.has_value());
+  EXPECT_EQ(loaded.error().code, ErrorCode::IoError);
+  EXPECT_EQ(recorder.events().size(), 1u);  // Untouched on failure.
+  std::remove(path.c_str());
+}
+
+TEST(RecordingFile, WriterRejectsEventsThatGoBackInTime) {
+  const std::string path = tempPath("robot_unsorted.rbrc");
+  auto writer = RecordingWriter::create(path);
+  ASSERT_TRUE(writer.has_value());
+  const KeyEvent key{Key::A, true};
+  ASSERT_TRUE(writer->write({milliseconds(5), key}).has_value());
+  const auto back = writer->write({milliseconds(4), key});
+  ASSERT_FALSE(back.has_value());
+  EXPECT_EQ(back.error().code, ErrorCode::InvalidArgument);
+  ASSERT_TRUE(writer->write({milliseconds(5), key}).has_value());
+  ASSERT_TRUE(writer->close().has_value());
+
+  // The rejected event left no trace.
+  const auto mapped = MappedRecording::open(path);
+  ASSERT_TRUE(mapped.has_value());
+  EXPECT_EQ(mapped->size(), 2u);
+  std::remove(path.c_str());
+}
+
+TEST(RecordingFile, RejectsBackwardTimeAndOverflowingDeltas) {
+  const std::string path = tempPath("robot_crafted.rbrc");
+  const std::vector<std::uint8_t> header = {'R', 'B', 'R', 'C', 1, 3, 0, 0};
+  // Move events: tag, zigzag dt, zigzag dx, zigzag dy.
+  const std::vector<std::vector<std::uint8_t>> bodies = {
+      // dt = -1.
+      {1, 0x01, 0, 0},
+      // dx = INT64_MAX, then dx = 1 on top of it.
+      {1, 0, 0xFE, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01, 0,
+       1, 0, 0x02, 0},
+  };
+  for (const auto& body : bodies) {
+    {
+      std::ofstream out(path, std::ios::binary);
+      for (const auto* bytes : {&header, &body}) {
+        out.write(reinterpret_cast<const char*>(bytes->data()),
+                  static_cast<std::streamsize>(bytes->size()));
+      }
+    }
+    Recorder recorder;
+    const auto loaded = recorder.load(path);
+    ASSERT_FALSE(loaded.has_value());
+    EXPECT_EQ(loaded.error().code, ErrorCode::IoError);
+    const auto mapped = MappedRecording::open(path);
+    ASSERT_FALSE(mapped.has_value());
+    EXPECT_EQ(mapped.error().code, ErrorCode::IoError);
+  }
+  std::remove(path.c_str());
+}
+
+TEST(MappedRecording, SeeksThroughTheIndexToAnyTime) {
+  const std::string path = tempPath("robot_mapped.rbrc");
+  constexpr int kEvents = 5000;  // Several index strides.
+  {
+    auto writer = RecordingWriter::create(path);
+    ASSERT_TRUE(writer.has_value());
+    for (int i = 0; i < kEvents; ++i) {
+      // Two events per millisecond, so a seek lands mid-stride on a tie.
+      const RecordedEvent e{milliseconds(i / 2), MouseMoveEvent{{i * 1.0, 0.0}}};
+      ASSERT_TRUE(writer->write(e).has_value());
+    }
+    ASSERT_TRUE(writer->close().has_value());
+  }
+
+  auto mapped = MappedRecording::open(path);
+  ASSERT_TRUE(mapped.has_value());
+  EXPECT_EQ(mapped->size(), static_cast<std::size_t>(kEvents));
+  EXPECT_EQ(mapped->duration(), milliseconds((kEvents - 1) / 2));
+
+  for (const int ms : {0, 512, 1337, 2499}) {
+    auto cursor = mapped->seek(milliseconds(ms));
+    const auto first = cursor.next();
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(first->timestamp, milliseconds(ms));
+    EXPECT_EQ(std::get<MouseMoveEvent>(first->event).position.x, ms * 2.0);
+    const auto second = cursor.next();
+    ASSERT_TRUE(second.has_value());
+    EXPECT_EQ(second->timestamp, milliseconds(ms));
+  }
+  EXPECT_FALSE(mapped->seek(milliseconds(2500)).next().has_value());
+  std::remove(path.c_str());
+}
+
+TEST(MappedRecording, ValidatesTheWholeFileOnOpen) {
+  const std::string path = tempPath("robot_mapped_corrupt.rbrc");
+  {
+    auto writer = RecordingWriter::create(path);
+    ASSERT_TRUE(writer.has_value());
+    for (int i = 0; i < 3; ++i) {
+      ASSERT_TRUE(
+          writer->write({milliseconds(i), KeyEvent{Key::A, i % 2 == 0}})
+              .has_value()
+      );
+    }
+    ASSERT_TRUE(writer->close().has_value());
+  }
+  std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+
+  const auto mapped = MappedRecording::open(path);
+  ASSERT_FALSE(mapped.has_value());
+  EXPECT_EQ(mapped.error().code, ErrorCode::IoError);
+  std::remove(path.c_str());
+}
+
+}  // namespace
+}  // namespace robot
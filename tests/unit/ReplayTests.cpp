@@ -0,0 +1,231 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "robot/Recorder.h"
+#include "robot/Session.h"
+#include "support/MockBackend.h"
+
+// Replay against a Session built on the mock backend. The mock's call log is
+// not synchronized, so asynchronous tests watch progress() while the
+// scheduler runs and read the log only once result() is ready.
+namespace robot::test {
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+
+struct MockSession {
+  MockPlatformBackend* backend;  // Owned by session.
+  std::unique_ptr<Session> session;
+};
+
+MockSession mockSession() {
+  auto backend = std::make_unique<MockPlatformBackend>();
+  auto* raw = backend.get();
+  return {raw, Session::fromBackend(std::move(backend))};
+}
+
+// Poll until the replay has issued count events, or give up after a second.
+bool waitForIssued(const ReplayHandle& handle, const std::size_t count) {
+  const auto limit = Clock::now() + std::chrono::seconds(1);
+  while (handle.progress().issued < count) {
+    if (Clock::now() > limit) return false;
+    std::this_thread::sleep_for(milliseconds(1));
+  }
+  return true;
+}
+
+bool logged(
+    const std::vector<RecordedCall>& log, const RecordedCall::Kind kind,
+    const Key key
+) {
+  return std::any_of(log.begin(), log.end(), [&](const RecordedCall& c) {
+    return c.kind == kind && c.key == key;
+  });
+}
+
+TEST(Replay, IssuesInRecordedOrderAndCountsDueEventsAsImmediate) {
+  auto [backend, session] = mockSession();
+  Recorder recorder;
+  const auto t0 = Clock::now();
+  // A burst of three stamped together, then one 20 ms later.
+  recorder.capture(TimedEvent{t0, KeyEvent{Key::A, true}});
+  recorder.capture(TimedEvent{t0, KeyEvent{Key::A, false}});
+  recorder.capture(TimedEvent{t0, KeyEvent{Key::B, true}});
+  recorder.capture(TimedEvent{t0 + milliseconds(20), KeyEvent{Key::B, false}});
+
+  const auto start = Clock::now();
+  const auto stats = recorder.replay(*session);
+  ASSERT_TRUE(stats.has_value());
+  EXPECT_GE(Clock::now() - start, milliseconds(20));
+
+  // The burst is due as it is reached, so it goes out without a wait; the
+  // last event is waited for.
+  EXPECT_EQ(stats->events, 4u);
+  EXPECT_GE(stats->immediate, 3u);
+  EXPECT_LE(stats->immediate, stats->events);
+  EXPECT_EQ(stats->lateness.samples, 4u);
+  EXPECT_GE(stats->lateness.mean, microseconds(0));
+  EXPECT_GE(stats->lateness.max, stats->lateness.mean);
+  EXPECT_FALSE(stats->cancelled);
+
+  const auto& log = backend->log();
+  ASSERT_EQ(log.size(), 4u);
+  const std::vector<std::pair<RecordedCall::Kind, Key>> expected = {
+      {RecordedCall::Kind::KeyDown, Key::A},
+      {RecordedCall::Kind::KeyUp, Key::A},
+      {RecordedCall::Kind::KeyDown, Key::B},
+      {RecordedCall::Kind::KeyUp, Key::B},
+  };
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(log[i].kind, expected[i].first) << "call " << i;
+    EXPECT_EQ(log[i].key, expected[i].second) << "call " << i;
+  }
+}
+
+TEST(Replay, DrivesEveryTargetOnItsOwnOffset) {
+  auto first = mockSession();
+  auto second = mockSession();
+  Recorder recorder;
+  const auto t0 = Clock::now();
+  recorder.capture(TimedEvent{t0, KeyEvent{Key::A, true}});
+  recorder.capture(TimedEvent{t0 + milliseconds(10), KeyEvent{Key::B, true}});
+  recorder.capture(TimedEvent{t0 + milliseconds(30), KeyEvent{Key::A, false}});
+
+  // Jitter never reorders a target's events, however it moves them.
+  const std::vector<ReplayTarget> targets = {
+      {.session = first.session.get()},
+      {.session = second.session.get(),
+       .offset = milliseconds(100),
+       .jitter = milliseconds(2)},
+  };
+  const auto stats = recorder.replay(targets);
+  ASSERT_TRUE(stats.has_value());
+  ASSERT_EQ(stats->size(), 2u);
+  for (const ReplayStats& s : *stats) {
+    EXPECT_EQ(s.events, 3u);
+    EXPECT_EQ(s.lateness.samples, 3u);
+    EXPECT_GE(s.lateness.mean, microseconds(0));
+    EXPECT_FALSE(s.cancelled);
+  }
+  // The first target's first event is due at once; the second's is not.
+  EXPECT_GE((*stats)[0].immediate, 1u);
+
+  for (auto* backend : {first.backend, second.backend}) {
+    const auto& log = backend->log();
+    ASSERT_EQ(log.size(), 3u);
+    EXPECT_EQ(log[0].kind, RecordedCall::Kind::KeyDown);
+    EXPECT_EQ(log[0].key, Key::A);
+    EXPECT_EQ(log[1].kind, RecordedCall::Kind::KeyDown);
+    EXPECT_EQ(log[1].key, Key::B);
+    EXPECT_EQ(log[2].kind, RecordedCall::Kind::KeyUp);
+    EXPECT_EQ(log[2].key, Key::A);
+    // 30 ms recorded, less up to 4 ms of jitter and the first event's
+    // lateness.
+    EXPECT_GE(log[2].at - log[0].at, milliseconds(20));
+  }
+  const auto spacing =
+      second.backend->log().front().at - first.backend->log().front().at;
+  EXPECT_GE(spacing, milliseconds(90));
+  EXPECT_LT(spacing, milliseconds(300));
+}
+
+TEST(ReplayAsync, SeekTakesEffectAtOnce) {
+  auto [backend, session] = mockSession();
+  Recorder recorder;
+  const auto t0 = Clock::now();
+  recorder.capture(TimedEvent{t0, KeyEvent{Key::A, true}});
+  recorder.capture(TimedEvent{t0 + std::chrono::seconds(3),
+                              KeyEvent{Key::B, true}});
+  recorder.capture(TimedEvent{t0 + milliseconds(3010),
+                              KeyEvent{Key::B, false}});
+
+  auto handle = recorder.replayAsync(*session);
+  ASSERT_TRUE(waitForIssued(handle, 1));
+  std::this_thread::sleep_for(milliseconds(100));
+
+  // Into the 3 s gap: the event sought to is due now, not when the one the
+  // seek interrupted was.
+  const auto seekAt = Clock::now();
+  handle.seek(std::chrono::seconds(3));
+  ASSERT_TRUE(waitForIssued(handle, 2));
+  EXPECT_LT(Clock::now() - seekAt, milliseconds(500));
+
+  const auto stats = handle.result().get();
+  ASSERT_TRUE(stats.has_value());
+  EXPECT_FALSE(stats->cancelled);
+  EXPECT_EQ(stats->events, 3u);
+
+  // A, held when the seek landed, is released before B goes down.
+  const auto& log = backend->log();
+  ASSERT_EQ(log.size(), 4u);
+  EXPECT_EQ(log[0].kind, RecordedCall::Kind::KeyDown);
+  EXPECT_EQ(log[1].kind, RecordedCall::Kind::KeyUp);
+  EXPECT_EQ(log[1].key, Key::A);
+  EXPECT_EQ(log[2].kind, RecordedCall::Kind::KeyDown);
+  EXPECT_EQ(log[2].key, Key::B);
+  EXPECT_EQ(log[3].kind, RecordedCall::Kind::KeyUp);
+}
+
+TEST(ReplayAsync, PauseHoldsAndResumeReplaysTheRemainingGap) {
+  auto [backend, session] = mockSession();
+  Recorder recorder;
+  const auto t0 = Clock::now();
+  recorder.capture(TimedEvent{t0, KeyEvent{Key::A, true}});
+  recorder.capture(TimedEvent{t0 + milliseconds(200), KeyEvent{Key::A, false}});
+
+  const auto start = Clock::now();
+  auto handle = recorder.replayAsync(*session);
+  ASSERT_TRUE(waitForIssued(handle, 1));
+  handle.pause();
+  std::this_thread::sleep_for(milliseconds(300));
+  EXPECT_EQ(handle.progress().state, ReplayState::Paused);
+  EXPECT_EQ(handle.progress().issued, 1u);
+
+  handle.resume();
+  const auto stats = handle.result().get();
+  ASSERT_TRUE(stats.has_value());
+  EXPECT_EQ(stats->events, 2u);
+  // The pause did not eat into the 200 ms gap.
+  EXPECT_GE(Clock::now() - start, milliseconds(450));
+  EXPECT_EQ(backend->log().size(), 2u);
+}
+
+TEST(ReplayAsync, CancelStopsAndReleasesHeldInputs) {
+  auto [backend, session] = mockSession();
+  Recorder recorder;
+  const auto t0 = Clock::now();
+  recorder.capture(TimedEvent{t0, KeyEvent{Key::A, true}});
+  recorder.capture(TimedEvent{
+      t0 + milliseconds(1),
+      MouseButtonEvent{MouseButton::Left, true, {10.0, 10.0}}});
+  recorder.capture(TimedEvent{t0 + std::chrono::seconds(10),
+                              KeyEvent{Key::A, false}});
+
+  const auto start = Clock::now();
+  auto handle = recorder.replayAsync(*session);
+  ASSERT_TRUE(waitForIssued(handle, 2));
+  handle.cancel();
+  const auto stats = handle.result().get();
+  EXPECT_LT(Clock::now() - start, std::chrono::seconds(1));
+  ASSERT_TRUE(stats.has_value());
+  EXPECT_TRUE(stats->cancelled);
+  EXPECT_EQ(stats->events, 2u);
+
+  const auto& log = backend->log();
+  EXPECT_TRUE(logged(log, RecordedCall::Kind::KeyUp, Key::A));
+  EXPECT_TRUE(std::any_of(log.begin(), log.end(), [](const RecordedCall& c) {
+    return c.kind == RecordedCall::Kind::Button &&
+           c.action == ButtonAction::Up;
+  }));
+}
+
+}  // namespace
+}  // namespace robot::test
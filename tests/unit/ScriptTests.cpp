@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <expected>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include "robot/ScriptExecutor.h"
+#include "robot/ScriptSession.h"
+#include "support/MockBackend.h"
+
+// Scripts are coroutines on the thread that calls run(): their waits park on
+// the executor's timer wheel, so many of them overlap in time without a
+// thread each, and the backend sees the same calls as from the facades.
+namespace robot::test {
+namespace {
+
+using Clock = ScriptExecutor::Clock;
+using std::chrono::milliseconds;
+using Script = Task<std::expected<void, Error>>;
+
+Script napTwice(ScriptExecutor& executor, std::vector<std::thread::id>& ran) {
+  co_await executor.sleepFor(milliseconds(20));
+  co_await executor.sleepFor(milliseconds(20));
+  ran.push_back(std::this_thread::get_id());
+  co_return std::expected<void, Error>{};
+}
+
+TEST(Script, ThousandsInterleaveOnOneThread) {
+  ScriptExecutor executor;
+  std::vector<std::thread::id> ran;
+  std::vector<std::future<std::expected<void, Error>>> results;
+  for (int i = 0; i < 2000; ++i) {
+    results.push_back(executor.spawn(napTwice(executor, ran)));
+  }
+  EXPECT_EQ(executor.active(), 2000u);
+
+  const auto start = Clock::now();
+  executor.run();
+  const auto elapsed = Clock::now() - start;
+
+  // Every script waited 40 ms, all of them at once.
+  EXPECT_GE(elapsed, milliseconds(40));
+  EXPECT_LT(elapsed, milliseconds(1000));
+  EXPECT_EQ(executor.active(), 0u);
+  ASSERT_EQ(ran.size(), 2000u);
+  for (const auto id : ran) EXPECT_EQ(id, std::this_thread::get_id());
+  for (auto& r : results) EXPECT_TRUE(r.get().has_value());
+}
+
+Script wakeAt(
+    ScriptExecutor& executor, const Clock::time_point deadline,
+    std::vector<Clock::time_point>& woke
+) {
+  co_await executor.sleepUntil(deadline);
+  woke.push_back(Clock::now());
+  co_return std::expected<void, Error>{};
+}
+
+TEST(Script, WaitsEndAtOrAfterTheirDeadlinesInOrder) {
+  ScriptExecutor executor;
+  std::vector<Clock::time_point> woke;
+  const auto start = Clock::now();
+  // Spawned out of order, and one beyond a full revolution of the wheel.
+  const std::vector<milliseconds> delays = {
+      milliseconds(30), milliseconds(5), milliseconds(300), milliseconds(15)};
+  for (const auto d : delays) {
+    (void)executor.spawn(wakeAt(executor, start + d, woke));
+  }
+  executor.run();
+
+  ASSERT_EQ(woke.size(), 4u);
+  EXPECT_GE(woke[0], start + milliseconds(5));
+  EXPECT_GE(woke[1], start + milliseconds(15));
+  EXPECT_GE(woke[2], start + milliseconds(30));
+  EXPECT_GE(woke[3], start + milliseconds(300));
+}
+
+Task<std::expected<int, Error>> answer(ScriptExecutor& executor) {
+  co_await executor.sleepFor(milliseconds(1));
+  co_return 42;
+}
+
+Task<std::expected<int, Error>> doubled(ScriptExecutor& executor) {
+  auto a = co_await answer(executor);
+  if (!a) co_return std::unexpected(a.error());
+  co_return *a * 2;
+}
+
+TEST(Script, TasksComposeAndCarryValues) {
+  ScriptExecutor executor;
+  auto result = executor.spawn(doubled(executor));
+  executor.run();
+  const auto value = result.get();
+  ASSERT_TRUE(value.has_value());
+  EXPECT_EQ(*value, 84);
+}
+
+Script dragThere(ScriptSession& s) {
+  co_return co_await s.drag({40.0, 30.0});
+}
+
+TEST(Script, DragIssuesTheSameCallsAsTheFacade) {
+  MockPlatformBackend backend;
+  ScriptExecutor executor;
+  ScriptSession session(executor, backend);
+
+  auto result = executor.spawn(dragThere(session));
+  executor.run();
+  ASSERT_TRUE(result.get().has_value());
+
+  const auto& log = backend.log();
+  ASSERT_EQ(log.size(), 3u);
+  EXPECT_EQ(log[0].action, ButtonAction::Down);
+  EXPECT_EQ(log[1].kind, RecordedCall::Kind::Warp);
+  EXPECT_EQ(log[1].point, (LogicalPoint{40.0, 30.0}));
+  EXPECT_EQ(log[2].action, ButtonAction::Up);
+}
+
+Task<std::expected<MoveStats, Error>> glide(ScriptSession& s) {
+  MouseMoveOptions options;
+  options.duration = milliseconds(20);
+  options.steps = 10;
+  co_return co_await s.moveSmooth({100.0, 0.0}, options);
+}
+
+TEST(Script, SmoothMoveKeepsItsTiming) {
+  MockPlatformBackend backend;
+  backend.mockMouse().setPosition({0.0, 0.0});
+  ScriptExecutor executor;
+  ScriptSession session(executor, backend);
+
+  auto result = executor.spawn(glide(session));
+  executor.run();
+  const auto stats = result.get();
+  ASSERT_TRUE(stats.has_value());
+  EXPECT_EQ(stats->steps, 10);
+  EXPECT_GE(stats->achieved, stats->requested);
+  EXPECT_EQ(stats->jitter.samples, 10u);
+  EXPECT_EQ(backend.log().back().point, (LogicalPoint{100.0, 0.0}));
+}
+
+Script slowDrag(ScriptSession& s) {
+  MouseMoveOptions options;
+  options.duration = std::chrono::seconds(10);
+  options.steps = 2;
+  co_return co_await s.dragSmooth({50.0, 50.0}, MouseButton::Left, options);
+}
+
+TEST(Script, DestroyingTheExecutorCancelsAndReleases) {
+  MockPlatformBackend backend;
+  std::future<std::expected<void, Error>> result;
+  {
+    ScriptExecutor executor;
+    ScriptSession session(executor, backend);
+    result = executor.spawn(slowDrag(session));
+    EXPECT_FALSE(executor.runUntil(Clock::now() + milliseconds(50)));
+    EXPECT_EQ(executor.active(), 1u);
+  }
+  const auto r = result.get();
+  ASSERT_FALSE(r.has_value());
+  EXPECT_EQ(r.error().code, ErrorCode::Cancelled);
+
+  const auto& log = backend.log();
+  ASSERT_GE(log.size(), 2u);
+  EXPECT_EQ(log.front().action, ButtonAction::Down);
+  EXPECT_EQ(log.back().kind, RecordedCall::Kind::Button);
+  EXPECT_EQ(log.back().action, ButtonAction::Up);
+}
+
+}  // namespace
+}  // namespace robot::test
@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "robot/SpscRing.h"
+
+// The ring is the only lock-free structure in the library, so its edge cases
+// are pinned directly: capacity rounding, full rejection, index wrap-around, and
+// ordered delivery across two real threads.
+namespace robot {
+namespace {
+
+std::vector<int> drainAll(SpscRing<int>& ring) {
+  std::vector<int> out;
+  ring.drain([&](int&& v) { out.push_back(v); });
+  return out;
+}
+
+TEST(SpscRing, RoundsCapacityAndRejectsWhenFull) {
+  SpscRing<int> ring(3);
+  EXPECT_EQ(ring.capacity(), 4u);
+  for (int i = 0; i < 4; ++i) EXPECT_TRUE(ring.tryPush(i));
+  EXPECT_FALSE(ring.tryPush(4));
+  EXPECT_EQ(drainAll(ring), (std::vector<int>{0, 1, 2, 3}));
+  EXPECT_EQ(ring.size(), 0u);
+}
+
+TEST(SpscRing, WrapsAroundItsSlots) {
+  SpscRing<int> ring(2);
+  std::vector<int> seen;
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_TRUE(ring.tryPush(i));
+    const auto batch = drainAll(ring);
+    seen.insert(seen.end(), batch.begin(), batch.end());
+  }
+  EXPECT_EQ(seen, (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+}
+
+TEST(SpscRing, DeliversInOrderAcrossThreads) {
+  constexpr int kCount = 100000;
+  SpscRing<int> ring(64);
+
+  std::thread producer([&] {
+    for (int i = 0; i < kCount;) {
+      if (ring.tryPush(i)) ++i;
+    }
+  });
+  int expected = 0;
+  while (expected < kCount) {
+    ring.drain([&](int&& v) { EXPECT_EQ(v, expected++); });
+  }
+  producer.join();
+  EXPECT_EQ(expected, kCount);
+}
+
+}  // namespace
+}  // namespace robot
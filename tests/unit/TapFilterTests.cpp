@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+
+#include "common/TapFilter.h"
+
+// The compiled EventFilter every tap applies on its own thread: category
+// switches, key and button selection, and the pointer region.
+namespace robot {
+namespace {
+
+TEST(TapFilter, DefaultAcceptsEverything) {
+  const tap::Filter filter(EventFilter{});
+  EXPECT_TRUE(filter.accepts(KeyEvent{Key::A, true}));
+  EXPECT_TRUE(filter.accepts(MouseMoveEvent{{5.0, 5.0}}));
+  EXPECT_TRUE(filter.accepts(MouseButtonEvent{MouseButton::X2, true, {}}));
+  EXPECT_TRUE(filter.accepts(ScrollEvent{ScrollDelta::lines(1, 0), {}}));
+}
+
+TEST(TapFilter, SelectsKeysAndButtons) {
+  const tap::Filter filter(EventFilter{
+      .onlyKeys = {Key::A, Key::Enter},
+      .onlyButtons = {MouseButton::Right},
+  });
+  EXPECT_TRUE(filter.accepts(KeyEvent{Key::A, true}));
+  EXPECT_TRUE(filter.accepts(KeyEvent{Key::Enter, false}));
+  EXPECT_FALSE(filter.accepts(KeyEvent{Key::B, true}));
+  EXPECT_TRUE(filter.accepts(MouseButtonEvent{MouseButton::Right, true, {}}));
+  EXPECT_FALSE(filter.accepts(MouseButtonEvent{MouseButton::Left, true, {}}));
+  // Selecting keys and buttons leaves the other categories alone.
+  EXPECT_TRUE(filter.accepts(MouseMoveEvent{{1.0, 1.0}}));
+}
+
+TEST(TapFilter, CategorySwitchesOverrideSelection) {
+  const tap::Filter filter(EventFilter{
+      .keys = false,
+      .buttons = false,
+      .onlyKeys = {Key::A},
+      .onlyButtons = {MouseButton::Left},
+  });
+  EXPECT_FALSE(filter.accepts(KeyEvent{Key::A, true}));
+  EXPECT_FALSE(filter.accepts(MouseButtonEvent{MouseButton::Left, true, {}}));
+  EXPECT_TRUE(filter.accepts(ScrollEvent{ScrollDelta::lines(1, 0), {}}));
+}
+
+TEST(TapFilter, RegionAppliesToPointerEventsOnly) {
+  // [100, 300) x [50, 150): the right and bottom edges are outside.
+  const tap::Filter filter(EventFilter{
+      .region = LogicalRect{{100.0, 50.0}, {200.0, 100.0}},
+  });
+  EXPECT_TRUE(filter.accepts(MouseMoveEvent{{100.0, 50.0}}));
+  EXPECT_TRUE(filter.accepts(MouseMoveEvent{{299.0, 149.0}}));
+  EXPECT_FALSE(filter.accepts(MouseMoveEvent{{300.0, 100.0}}));
+  EXPECT_FALSE(filter.accepts(MouseMoveEvent{{150.0, 150.0}}));
+  EXPECT_FALSE(filter.accepts(MouseMoveEvent{{99.0, 100.0}}));
+
+  EXPECT_TRUE(
+      filter.accepts(MouseButtonEvent{MouseButton::Left, true, {200.0, 100.0}})
+  );
+  EXPECT_FALSE(
+      filter.accepts(MouseButtonEvent{MouseButton::Left, true, {10.0, 10.0}})
+  );
+  EXPECT_TRUE(
+      filter.accepts(ScrollEvent{ScrollDelta::lines(1, 0), {200.0, 100.0}})
+  );
+  EXPECT_FALSE(
+      filter.accepts(ScrollEvent{ScrollDelta::lines(1, 0), {10.0, 10.0}})
+  );
+  // Keys carry no position, so the region never excludes them.
+  EXPECT_TRUE(filter.accepts(KeyEvent{Key::A, true}));
+}
+
+}  // namespace
+}  // namespace robot
@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "robot/Mouse.h"
+#include "robot/Trajectory.h"
+#include "support/MockBackend.h"
+
+// Path generation is pure math over a seeded engine, so every shape is pinned
+// here without any timing: endpoints, determinism, and the velocity profile's
+// characteristic slow start.
+namespace robot::test {
+namespace {
+
+std::vector<LogicalPoint> generate(
+    const TrajectoryOptions& options, const int steps = 50
+) {
+  Trajectory trajectory;
+  trajectory.generate({0.0, 0.0}, {300.0, 100.0}, steps, options);
+  const auto points = trajectory.points();
+  return {points.begin(), points.end()};
+}
+
+TEST(Trajectory, EveryShapeEndsExactlyOnTarget) {
+  TrajectoryOptions bezier;
+  bezier.shape = PathShape::Bezier;
+  bezier.velocity = VelocityProfile::MinimumJerk;
+  bezier.overshoot = 0.1;
+  bezier.seed = 7;
+
+  for (const auto& options : {TrajectoryOptions{}, bezier}) {
+    const auto points = generate(options);
+    ASSERT_EQ(points.size(), 50u);
+    EXPECT_EQ(points.back(), (LogicalPoint{300.0, 100.0}));
+  }
+}
+
+TEST(Trajectory, SeededBezierIsReproducible) {
+  TrajectoryOptions options;
+  options.shape = PathShape::Bezier;
+  options.curvature = 0.3;
+  options.seed = 42;
+
+  EXPECT_EQ(generate(options), generate(options));
+
+  TrajectoryOptions other = options;
+  other.seed = 43;
+  EXPECT_NE(generate(options), generate(other));
+}
+
+TEST(Trajectory, MinimumJerkAcceleratesFromRest) {
+  TrajectoryOptions options;
+  options.velocity = VelocityProfile::MinimumJerk;
+  const auto points = generate(options);
+
+  const double first = LogicalPoint{0.0, 0.0}.distanceTo(points[0]);
+  const double middle = points[24].distanceTo(points[25]);
+  const double last = points[48].distanceTo(points[49]);
+  EXPECT_LT(first, middle);
+  EXPECT_LT(last, middle);
+}
+
+TEST(Trajectory, OvershootPassesTargetThenCorrects) {
+  TrajectoryOptions options;
+  options.overshoot = 0.1;
+  const auto points = generate(options);
+
+  double furthestX = 0.0;
+  for (const auto& p : points) furthestX = std::max(furthestX, p.x);
+  EXPECT_NEAR(furthestX, 330.0, 1e-9);
+  EXPECT_EQ(points.back().x, 300.0);
+}
+
+TEST(Trajectory, FittsDurationGrowsWithDistance) {
+  const FittsTiming fitts;
+  EXPECT_EQ(fitts.durationFor(0.0), fitts.intercept);
+  EXPECT_LT(fitts.durationFor(100.0), fitts.durationFor(1000.0));
+}
+
+TEST(Trajectory, MoveSmoothFollowsGeneratedPath) {
+  MockPlatformBackend backend;
+  backend.mockMouse().setPosition({0.0, 0.0});
+  Mouse mouse(backend.mouse());
+
+  MouseMoveOptions options;
+  options.duration = std::chrono::milliseconds(0);
+  options.steps = 20;
+  options.trajectory.shape = PathShape::Bezier;
+  options.trajectory.seed = 9;
+  ASSERT_TRUE(mouse.moveSmooth({300.0, 100.0}, options).has_value());
+
+  Trajectory expected;
+  expected.generate({0.0, 0.0}, {300.0, 100.0}, 20, options.trajectory);
+  std::vector<LogicalPoint> warps;
+  for (const auto& c : backend.log()) {
+    if (c.kind == RecordedCall::Kind::Warp) warps.push_back(c.point);
+  }
+  ASSERT_EQ(warps.size(), expected.points().size());
+  EXPECT_TRUE(std::equal(warps.begin(), warps.end(), expected.points().begin()));
+}
+
+TEST(Trajectory, DisplayRefreshEmitsOneStepPerFrame) {
+  MockPlatformBackend backend;
+  backend.mockMouse().setPosition({0.0, 0.0});
+  Monitor slow;
+  slow.isPrimary = true;
+  slow.logicalBounds = {{0.0, 0.0}, {1000.0, 1000.0}};
+  slow.refreshRate = 100.0;
+  Monitor fast;
+  fast.logicalBounds = {{1000.0, 0.0}, {1000.0, 1000.0}};
+  fast.refreshRate = 200.0;
+  backend.mockScreen().setMonitors({slow, fast});
+  Mouse mouse(backend.mouse(), &backend.screen());
+
+  MouseMoveOptions options;
+  options.duration = std::chrono::milliseconds(30);
+  options.sync = MotionSync::DisplayRefresh;
+  const auto onSlow = mouse.moveSmooth({1500.0, 10.0}, options);
+  ASSERT_TRUE(onSlow.has_value());
+  EXPECT_EQ(onSlow->steps, 3);  // The monitor under the start point decides.
+
+  const auto onFast = mouse.moveSmooth({10.0, 10.0}, options);
+  ASSERT_TRUE(onFast.has_value());
+  EXPECT_EQ(onFast->steps, 6);
+
+  options.frameRate = 50.0;
+  const auto overridden = mouse.moveSmooth({20.0, 10.0}, options);
+  ASSERT_TRUE(overridden.has_value());
+  EXPECT_EQ(overridden->steps, 2);
+}
+
+TEST(Trajectory, DisplayRefreshCoalescesFramesAlreadyDue) {
+  MockPlatformBackend backend;
+  Mouse mouse(backend.mouse());
+  const std::vector<LogicalPoint> path{{1.0, 0.0}, {2.0, 0.0}, {3.0, 0.0}};
+
+  // A zero duration makes every frame due at once: only the last is warped.
+  MouseMoveOptions options;
+  options.duration = std::chrono::milliseconds(0);
+  options.sync = MotionSync::DisplayRefresh;
+  const auto stats = mouse.followPath(path, options);
+  ASSERT_TRUE(stats.has_value());
+  EXPECT_EQ(stats->steps, 3);
+  EXPECT_EQ(stats->coalesced, 2);
+
+  std::vector<LogicalPoint> warps;
+  for (const auto& c : backend.log()) {
+    if (c.kind == RecordedCall::Kind::Warp) warps.push_back(c.point);
+  }
+  EXPECT_EQ(warps, (std::vector<LogicalPoint>{{3.0, 0.0}}));
+}
+
+}  // namespace
+}  // namespace robot::test
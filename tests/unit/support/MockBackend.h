@@ -1,9 +1,15 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <span>
 #include <string>
 #include <variant>
 #include <vector>
 
+#include "robot/backend/IEventTapBackend.h"
 #include "robot/backend/IPlatformBackend.h"
 
 // A fully in-memory backend that records every operation and returns programmed
@@ -27,12 +33,15 @@ struct RecordedCall {
   int clickCount = 0;
   ScrollDelta scroll;
   PhysicalRect region;
+  // When the call was made, for tests that check pacing.
+  std::chrono::steady_clock::time_point at = std::chrono::steady_clock::now();
 };
 
 class MockKeyboard final : public backend::IKeyboardBackend {
  public:
   explicit MockKeyboard(std::vector<RecordedCall>& log) : log_(&log) {}
   std::expected<void, Error> keyDown(Key k) override {
+    if (k == failKeyDown_) return std::unexpected(Error::unmappableInput("mock"));
     log_->push_back({.kind = RecordedCall::Kind::KeyDown, .key = k});
     return {};
   }
@@ -44,8 +53,10 @@ class MockKeyboard final : public backend::IKeyboardBackend {
     log_->push_back({.kind = RecordedCall::Kind::TypeUnicode, .codepoint = cp});
     return {};
   }
+  void failKeyDown(Key k) { failKeyDown_ = k; }
  private:
   std::vector<RecordedCall>* log_;
+  Key failKeyDown_ = Key::Unknown;
 };
 
 class MockMouse final : public backend::IMouseBackend {
@@ -98,6 +109,53 @@ class MockScreen final : public backend::IScreenBackend {
   Rgba fill_{1, 2, 3, 255};
 };
 
+// A tap whose start() blocks like a real one until stop(); emit() plays the
+// part of the OS, delivering a batch to the running sink from the caller's
+// thread.
+class MockEventTap final : public backend::IEventTapBackend {
+ public:
+  std::expected<void, Error> start(
+      EventBatchSink sink, const TapOptions& options
+  ) override {
+    std::unique_lock lock(mutex_);
+    sink_ = std::move(sink);
+    options_ = options;
+    stopped_ = false;
+    ++starts_;
+    running_.store(true);
+    cv_.wait(lock, [this] { return stopped_; });
+    running_.store(false);
+    sink_ = nullptr;
+    return {};
+  }
+  void stop() override {
+    const std::lock_guard lock(mutex_);
+    stopped_ = true;
+    cv_.notify_all();
+  }
+  bool isRunning() const override { return running_.load(); }
+
+  void emit(std::span<const TimedEvent> batch) {
+    EventBatchSink sink;
+    {
+      const std::lock_guard lock(mutex_);
+      sink = sink_;
+    }
+    if (sink) sink(batch);
+  }
+  int starts() const { return starts_; }
+  TapOptions options() const { return options_; }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  EventBatchSink sink_;
+  TapOptions options_;
+  bool stopped_ = false;
+  int starts_ = 0;
+  std::atomic<bool> running_{false};
+};
+
 class MockPlatformBackend final : public backend::IPlatformBackend {
  public:
   MockPlatformBackend()
@@ -118,6 +176,7 @@ class MockPlatformBackend final : public backend::IPlatformBackend {
   const Capabilities& capabilities() const override { return capabilities_; }
 
   std::vector<RecordedCall>& log() { return log_; }
+  MockKeyboard& mockKeyboard() { return keyboard_; }
   MockMouse& mockMouse() { return mouse_; }
   MockScreen& mockScreen() { return screen_; }
 